@@ -223,6 +223,66 @@ int32_t db_upperbound_i64(account_name code, account_name scope, table_name tabl
   */
 int32_t db_end_i64(account_name code, account_name scope, table_name table);
 
+/**
+  *  Header of each table row in the buffers of the batched primary 64-bit integer index table functions. Rows are packed
+  *  back to back, each header immediately followed by `size` bytes of the row, with no padding.
+  *  The batched functions can only be imported by contracts set once the chain activated the `batchdb` feature.
+  *
+  *  @brief Header of a table row in a batch
+  */
+struct db_batch_row {
+   uint64_t primary;
+   int32_t  iterator;
+   uint32_t size;
+};
+
+/**
+  *
+  *  Read up to `max_rows` consecutive table rows of a primary 64-bit integer index table, starting with the row pointed to by `iterator`, in a single call
+  *
+  *  @brief Read consecutive table rows of a primary 64-bit integer index table
+  *  @param iterator - The iterator to the first table row to read
+  *  @param data - Buffer the rows are written to, each as a `db_batch_row` followed by the data of the row
+  *  @param len - Size of the buffer
+  *  @param max_rows - The maximum number of table rows to read
+  *  @param next - Pointer to the iterator of the first table row that was not read, which is the end iterator of the table once every row was read
+  *  @return number of table rows read, which is less than `max_rows` if the table ends or the next row does not fit in the rest of the buffer
+  *
+  *  Example:
+  *  @code
+  *  char buffer[512];
+  *  int32_t next;
+  *  int32_t rows = db_get_batch_i64(itr, buffer, sizeof(buffer), 16, &next);
+  *  @endcode
+  */
+int32_t db_get_batch_i64(int32_t iterator, void* data, uint32_t len, uint32_t max_rows, int32_t* next);
+
+/**
+  *
+  *  Store the table rows of a batch in a primary 64-bit integer index table in a single call
+  *
+  *  @brief Store table rows in a primary 64-bit integer index table
+  *  @param scope - The scope where the table resides
+  *  @param table - The table name
+  *  @param payer - The account that pays for the storage costs
+  *  @param data - The rows to store, each as a `db_batch_row` holding its primary key followed by the row
+  *  @param len - Size of data
+  *  @return iterator to the first newly created table row, the iterators of the others following it consecutively, or -1 if `data` has no rows
+  */
+int32_t db_store_batch_i64(account_name scope, table_name table, account_name payer, const void* data, uint32_t len);
+
+/**
+  *
+  *  Update the table rows of a batch in a primary 64-bit integer index table in a single call
+  *
+  *  @brief Update table rows in a primary 64-bit integer index table
+  *  @param payer - The account that pays for the storage costs (use 0 to continue using current payer)
+  *  @param data - The updated rows, each as a `db_batch_row` holding its iterator and primary key followed by the row
+  *  @param len - Size of data
+  *  @pre the primary key of each row matches the primary key of the table row pointed to by its iterator
+  */
+void db_update_batch_i64(account_name payer, const void* data, uint32_t len);
+
 /**
   *
   *  Store an association of a 64-bit integer secondary key to a primary key in a secondary 64-bit integer index table
@@ -548,28 +548,19 @@ class multi_index
 
       indices_type _indices;
 
-      const item& load_object_by_primary_iterator( int32_t itr )const {
-         using namespace _multi_index_detail;
-
+      const item* find_loaded_object( int32_t itr )const {
          auto itr2 = std::find_if(_items_vector.rbegin(), _items_vector.rend(), [&](const item_ptr& ptr) {
             return ptr._primary_itr == itr;
          });
          if( itr2 != _items_vector.rend() )
-            return *itr2->_item;
-
-         auto size = db_get_i64( itr, nullptr, 0 );
-         enumivo_assert( size >= 0, "error reading iterator" );
-
-         //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
-         void* buffer = max_stack_buffer_size < size_t(size) ? malloc(size_t(size)) : alloca(size_t(size));
+            return itr2->_item.get();
+         return nullptr;
+      }
 
-         db_get_i64( itr, buffer, uint32_t(size) );
+      const item& load_object( int32_t itr, const char* data, uint32_t size )const {
+         using namespace _multi_index_detail;
 
-         datastream<const char*> ds( (char*)buffer, uint32_t(size) );
-
-         if ( max_stack_buffer_size < size_t(size) ) {
-            free(buffer);
-         }
+         datastream<const char*> ds( data, size );
 
          auto itm = std::make_unique<item>( this, [&]( auto& i ) {
             T& val = static_cast<T&>(i);
@@ -590,8 +581,88 @@ class multi_index
          _items_vector.emplace_back( std::move(itm), pk, pitr );
 
          return *ptr;
+      }
+
+      const item& load_object_by_primary_iterator( int32_t itr )const {
+         if( auto ptr = find_loaded_object( itr ) )
+            return *ptr;
+
+         auto size = db_get_i64( itr, nullptr, 0 );
+         enumivo_assert( size >= 0, "error reading iterator" );
+
+         //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
+         void* buffer = max_stack_buffer_size < size_t(size) ? malloc(size_t(size)) : alloca(size_t(size));
+
+         db_get_i64( itr, buffer, uint32_t(size) );
+
+         const item& obj = load_object( itr, (const char*)buffer, uint32_t(size) );
+
+         if ( max_stack_buffer_size < size_t(size) ) {
+            free(buffer);
+         }
+
+         return obj;
       } /// load_object_by_primary_iterator
 
+#ifdef ENULIB_MULTI_INDEX_BATCH_ROWS
+      /// a row read ahead by load_next_object, at offset in _prefetch_buffer
+      struct prefetched_row {
+         int32_t  iterator;
+         uint32_t offset;
+         uint32_t size;
+      };
+
+      mutable std::vector<char>           _prefetch_buffer;
+      mutable std::vector<prefetched_row> _prefetched_rows;
+
+      void clear_prefetched_rows()const {
+         _prefetched_rows.clear();
+      }
+
+      /**
+       * Loads the object of itr, which follows the row of an incremented iterator. When it was not read ahead yet, up
+       * to ENULIB_MULTI_INDEX_BATCH_ROWS rows from it on are read with a single call, but a row is only deserialized
+       * once an iterator reaches it.
+       */
+      const item& load_next_object( int32_t itr )const {
+         if( auto ptr = find_loaded_object( itr ) )
+            return *ptr;
+
+         auto row = std::find_if( _prefetched_rows.begin(), _prefetched_rows.end(), [&]( const prefetched_row& r ) {
+            return r.iterator == itr;
+         });
+         if( row == _prefetched_rows.end() ) {
+            _prefetch_buffer.resize( max_stack_buffer_size );
+            _prefetched_rows.clear();
+
+            int32_t next = -1;
+            auto rows = db_get_batch_i64( itr, _prefetch_buffer.data(), _prefetch_buffer.size(), ENULIB_MULTI_INDEX_BATCH_ROWS, &next );
+
+            uint32_t pos = 0;
+            for( int32_t i = 0; i < rows; ++i ) {
+               db_batch_row header;
+               memcpy( &header, _prefetch_buffer.data() + pos, sizeof(header) );
+               pos += sizeof(header);
+               _prefetched_rows.push_back( prefetched_row{ header.iterator, pos, header.size } );
+               pos += header.size;
+            }
+
+            // reads the row on its own if it is larger than the buffer
+            row = _prefetched_rows.begin();
+            if( row == _prefetched_rows.end() || row->iterator != itr )
+               return load_object_by_primary_iterator( itr );
+         }
+
+         return load_object( itr, _prefetch_buffer.data() + row->offset, row->size );
+      }
+#else
+      void clear_prefetched_rows()const {}
+
+      const item& load_next_object( int32_t itr )const {
+         return load_object_by_primary_iterator( itr );
+      }
+#endif
+
    public:
       /**
        *  Constructs an instance of a Multi-Index table.
@@ -748,7 +819,7 @@ class multi_index
             if( next_itr < 0 )
                _item = nullptr;
             else
-               _item = &_multidx->load_object_by_primary_iterator( next_itr );
+               _item = &_multidx->load_next_object( next_itr );
             return *this;
          }
          const_iterator& operator--() {
@@ -1658,6 +1729,7 @@ class multi_index
          using namespace _multi_index_detail;
 
          enumivo_assert( _code == current_receiver(), "cannot create objects in table of another contract" ); // Quick fix for mutating db using multi_index that shouldn't allow mutation. Real fix can come in RC2.
+         clear_prefetched_rows();
 
          auto itm = std::make_unique<item>( this, [&]( auto& i ){
             T& obj = static_cast<T&>(i);
@@ -1838,6 +1910,7 @@ class multi_index
          enumivo_assert( objitem.__idx == this, "object passed to modify is not in multi_index" );
          auto& mutableitem = const_cast<item&>(objitem);
          enumivo_assert( _code == current_receiver(), "cannot modify objects in table of another contract" ); // Quick fix for mutating db using multi_index that shouldn't allow mutation. Real fix can come in RC2.
+         clear_prefetched_rows();
 
          auto secondary_keys = hana::transform( _indices, [&]( auto&& idx ) {
             typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
@@ -2153,6 +2226,7 @@ class multi_index
          const auto& objitem = static_cast<const item&>(obj);
          enumivo_assert( objitem.__idx == this, "object passed to erase is not in multi_index" );
          enumivo_assert( _code == current_receiver(), "cannot erase objects in table of another contract" ); // Quick fix for mutating db using multi_index that shouldn't allow mutation. Real fix can come in RC2.
+         clear_prefetched_rows();
 
          auto pk = objitem.primary_key();
          auto itr2 = std::find_if(_items_vector.rbegin(), _items_vector.rend(), [&](const item_ptr& ptr) {
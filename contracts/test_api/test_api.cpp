@@ -147,6 +147,7 @@ extern "C" {
       WASM_TEST_HANDLER(test_transaction, context_free_api);
       WASM_TEST_HANDLER(test_transaction, new_feature);
       WASM_TEST_HANDLER(test_transaction, active_new_feature);
+      WASM_TEST_HANDLER(test_transaction, activate_batch_db);
 
       //test chain
       WASM_TEST_HANDLER(test_chain, test_activeprods);
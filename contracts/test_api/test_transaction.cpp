@@ -317,3 +317,8 @@ void test_transaction::new_feature() {
 void test_transaction::active_new_feature() {
    activate_feature((int64_t)N(newfeature));
 }
+
+void test_transaction::activate_batch_db() {
+   enumivo_assert(false == is_feature_active((int64_t)N(batchdb)), "batchdb should not be active yet");
+   activate_feature((int64_t)N(batchdb));
+}
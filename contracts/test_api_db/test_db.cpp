@@ -242,6 +242,68 @@ void test_db::primary_i64_upperbound(uint64_t receiver, uint64_t code, uint64_t
    }
 }
 
+void test_db::primary_i64_batch(uint64_t receiver, uint64_t code, uint64_t action)
+{
+   (void)code;(void)action;
+   auto table = N(mybatch);
+   const std::string err = "primary_i64_batch";
+
+   // rows of 8 byte values, one per primary key from 1 to 5
+   char buffer[5 * (sizeof(db_batch_row) + sizeof(uint64_t))];
+   auto pack_rows = [&]( uint64_t offset, int32_t first_itr ) {
+      char* pos = buffer;
+      for (uint64_t i = 1; i <= 5; ++i) {
+         db_batch_row row{ i, first_itr < 0 ? -1 : int32_t(first_itr + i - 1), sizeof(uint64_t) };
+         uint64_t value = i + offset;
+         memcpy(pos, &row, sizeof(row));
+         memcpy(pos + sizeof(row), &value, sizeof(value));
+         pos += sizeof(row) + sizeof(value);
+      }
+   };
+
+   pack_rows(100, -1);
+   int first = db_store_batch_i64(receiver, table, receiver, buffer, sizeof(buffer));
+   enumivo_assert(first == db_find_i64(receiver, receiver, table, 1), err.c_str());
+   enumivo_assert(first + 4 == db_find_i64(receiver, receiver, table, 5), err.c_str());
+
+   // read the rows two at a time
+   int itr = first;
+   uint64_t expected = 1;
+   while (itr >= 0) {
+      char rows[2 * (sizeof(db_batch_row) + sizeof(uint64_t))];
+      int next = -1;
+      int count = db_get_batch_i64(itr, rows, sizeof(rows), 2, &next);
+      enumivo_assert(count == 2 || (count == 1 && expected == 5), err.c_str());
+      const char* pos = rows;
+      for (int i = 0; i < count; ++i, ++expected) {
+         db_batch_row row;
+         uint64_t value = 0;
+         memcpy(&row, pos, sizeof(row));
+         memcpy(&value, pos + sizeof(row), sizeof(value));
+         enumivo_assert(row.primary == expected && row.size == sizeof(uint64_t) && value == expected + 100, err.c_str());
+         enumivo_assert(row.iterator == db_find_i64(receiver, receiver, table, expected), err.c_str());
+         pos += sizeof(row) + row.size;
+      }
+      itr = next;
+   }
+   enumivo_assert(expected == 6 && itr == db_end_i64(receiver, receiver, table), err.c_str());
+
+   // a row that does not fit is not read
+   {
+      char row[sizeof(db_batch_row)];
+      int next = -1;
+      enumivo_assert(db_get_batch_i64(first, row, sizeof(row), 5, &next) == 0 && next == first, err.c_str());
+   }
+
+   pack_rows(200, first);
+   db_update_batch_i64(0, buffer, sizeof(buffer));
+   for (uint64_t i = 1; i <= 5; ++i) {
+      uint64_t value = 0;
+      db_get_i64(db_find_i64(receiver, receiver, table, i), &value, sizeof(value));
+      enumivo_assert(value == i + 200, err.c_str());
+   }
+}
+
 void test_db::idx64_general(uint64_t receiver, uint64_t code, uint64_t action)
 {
    (void)code;(void)action;
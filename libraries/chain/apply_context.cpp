@@ -315,27 +315,38 @@ bool apply_context::cancel_deferred_transaction( const uint128_t& sender_id, acc
 }
 
 const table_id_object* apply_context::find_table( name code, name scope, name table ) {
-   return db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   auto key = std::make_tuple(code.value, scope.value, table.value);
+   auto itr = trx_context.table_cache.find(key);
+   if (itr != trx_context.table_cache.end()) {
+      return itr->second;
+   }
+
+   const auto* tid = db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   trx_context.table_cache.emplace(key, tid);
+   return tid;
 }
 
 const table_id_object& apply_context::find_or_create_table( name code, name scope, name table, const account_name &payer ) {
-   const auto* existing_tid =  db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   const auto* existing_tid = find_table(code, scope, table);
    if (existing_tid != nullptr) {
       return *existing_tid;
    }
 
    update_db_usage(payer, config::billable_size_v<table_id_object>);
 
-   return db.create<table_id_object>([&](table_id_object &t_id){
+   const auto& tid = db.create<table_id_object>([&](table_id_object &t_id){
       t_id.code = code;
       t_id.scope = scope;
       t_id.table = table;
       t_id.payer = payer;
    });
+   trx_context.table_cache[std::make_tuple(code.value, scope.value, table.value)] = &tid;
+   return tid;
 }
 
 void apply_context::remove_table( const table_id_object& tid ) {
    update_db_usage(tid.payer, - config::billable_size_v<table_id_object>);
+   trx_context.table_cache[std::make_tuple(tid.code.value, tid.scope.value, tid.table.value)] = nullptr;
    db.remove(tid);
 }
 
@@ -560,7 +571,7 @@ int apply_context::db_find_i64( uint64_t code, uint64_t scope, uint64_t table, u
 
    auto table_end_itr = keyval_cache.cache_table( *tab );
 
-   const key_value_object* obj = db.find<key_value_object, by_scope_primary>( boost::make_tuple( tab->id, id ) );
+   const key_value_object* obj = db.find<key_value_object, by_point_lookup>( boost::make_tuple( tab->id, id ) );
    if( !obj ) return table_end_itr;
 
    return keyval_cache.add( *obj );
@@ -607,6 +618,67 @@ int apply_context::db_end_i64( uint64_t code, uint64_t scope, uint64_t table ) {
    return keyval_cache.cache_table( *tab );
 }
 
+int apply_context::db_get_batch_i64( int iterator, char* buffer, size_t buffer_size, uint32_t max_rows, int& next ) {
+   next = iterator;
+   if( iterator < -1 ) return 0; // nothing left to read past the end iterator of a table
+
+   const auto& obj = keyval_cache.get( iterator ); // Check for iterator != -1 happens in this call
+   const auto& idx = db.get_index<key_value_index, by_scope_primary>();
+
+   uint32_t rows = 0;
+   size_t   used = 0;
+   auto itr = idx.iterator_to( obj );
+   for( ; itr != idx.end() && itr->t_id == obj.t_id && rows < max_rows; ++itr, ++rows ) {
+      auto s = itr->value.size();
+      if( buffer_size - used < sizeof(db_batch_row) + s ) break;
+
+      db_batch_row row;
+      row.primary  = itr->primary_key;
+      row.iterator = keyval_cache.add( *itr );
+      row.size     = s;
+      memcpy( buffer + used, &row, sizeof(row) );
+      memcpy( buffer + used + sizeof(row), itr->value.data(), s );
+      used += sizeof(row) + s;
+   }
+
+   if( itr == idx.end() || itr->t_id != obj.t_id )
+      next = keyval_cache.get_end_iterator_by_table_id( obj.t_id );
+   else
+      next = keyval_cache.add( *itr );
+   return rows;
+}
+
+template<typename Function>
+static void for_each_batch_row( const char* buffer, size_t buffer_size, Function&& f ) {
+   size_t used = 0;
+   while( used < buffer_size ) {
+      db_batch_row row;
+      ENU_ASSERT( buffer_size - used >= sizeof(row), table_operation_not_permitted, "truncated batch row" );
+      memcpy( &row, buffer + used, sizeof(row) );
+      used += sizeof(row);
+      ENU_ASSERT( buffer_size - used >= row.size, table_operation_not_permitted, "truncated batch row" );
+      f( row, buffer + used );
+      used += row.size;
+   }
+}
+
+int apply_context::db_store_batch_i64( uint64_t scope, uint64_t table, const account_name& payer, const char* buffer, size_t buffer_size ) {
+   int first = -1;
+   for_each_batch_row( buffer, buffer_size, [&]( const db_batch_row& row, const char* value ) {
+      auto itr = db_store_i64( receiver, scope, table, payer, row.primary, value, row.size );
+      if( first == -1 ) first = itr;
+   });
+   return first;
+}
+
+void apply_context::db_update_batch_i64( account_name payer, const char* buffer, size_t buffer_size ) {
+   for_each_batch_row( buffer, buffer_size, [&]( const db_batch_row& row, const char* value ) {
+      ENU_ASSERT( keyval_cache.get( row.iterator ).primary_key == row.primary, table_operation_not_permitted,
+                  "batch row does not match the primary key of its iterator" );
+      db_update_i64( row.iterator, payer, value, row.size );
+   });
+}
+
 uint64_t apply_context::next_global_sequence() {
    const auto& p = control.get_dynamic_global_properties();
    db.modify( p, [&]( auto& dgp ) {
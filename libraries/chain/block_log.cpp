@@ -4,28 +4,987 @@
  */
 #include <enumivo/chain/block_log.hpp>
 #include <enumivo/chain/exceptions.hpp>
+#include <enumivo/chain/config.hpp>
 #include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
 #include <fc/io/raw.hpp>
+#include <fc/scoped_exit.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
 
 #define LOG_READ  (std::ios::in | std::ios::binary)
 #define LOG_WRITE (std::ios::out | std::ios::binary | std::ios::app)
 
 namespace enumivo { namespace chain {
 
-   const uint32_t block_log::supported_version = 1;
+   const uint32_t block_log::supported_version     = 3;
+   const uint32_t block_log::min_supported_version = 1;
 
    namespace detail {
+      namespace bip = boost::interprocess;
+      namespace bio = boost::iostreams;
+
+      /// version written to logs which are appended to block by block
+      const uint32_t uncompressed_log_version = 2;
+      /// version of sealed logs which store their blocks in zlib compressed chunks
+      const uint32_t compressed_log_version   = 3;
+
+      /**
+       * Read-only memory mapping of a log file. A view covers the file as it was when the view was
+       * created; data appended afterwards only becomes visible through a newly created view.
+       */
+      class mapped_log_view {
+         public:
+            explicit mapped_log_view( const fc::path& file ) {
+               auto size = fc::file_size( file );
+               if( size > 0 ) {
+                  mapping = bip::file_mapping( file.generic_string().c_str(), bip::read_only );
+                  region  = bip::mapped_region( mapping, bip::read_only, 0, size );
+               }
+            }
+
+            const char* data()const { return static_cast<const char*>( region.get_address() ); }
+            uint64_t    size()const { return region.get_size(); }
+
+         private:
+            bip::file_mapping  mapping;
+            bip::mapped_region region;
+      };
+
+      using mapped_log_view_ptr = std::shared_ptr<const mapped_log_view>;
+
+      /// mappings of a block file and its index along with the number of the first block they contain
+      struct log_views {
+         uint32_t             first_block_num = 0;
+         uint64_t             first_block_pos = 0; ///< size of the file header, only tracked for the active log
+         uint32_t             chunk_blocks    = 0; ///< blocks per compressed chunk, 0 if the blocks are not compressed
+         mapped_log_view_ptr  block_view;
+         mapped_log_view_ptr  index_view;
+
+         /// @return the i-th position stored in the index or block_log::npos if the index does not contain it
+         uint64_t index_entry( uint64_t i )const {
+            if( !index_view || index_view->size() < sizeof(uint64_t) * (i + 1) )
+               return block_log::npos;
+            uint64_t pos;
+            memcpy( &pos, index_view->data() + sizeof(uint64_t) * i, sizeof(pos) );
+            return pos;
+         }
+
+         /// @return position of the block in an uncompressed block file or block_log::npos if the index does not contain it
+         uint64_t block_pos( uint32_t block_num )const {
+            if( block_num < first_block_num )
+               return block_log::npos;
+            return index_entry( block_num - first_block_num );
+         }
+      };
+
+      /// unpacks the block at pos straight out of the mapping; sets next_pos to the position of the following block
+      signed_block_ptr unpack_block( const mapped_log_view& view, uint64_t pos, uint64_t& next_pos ) {
+         ENU_ASSERT( pos < view.size(), block_log_exception,
+                     "Block position ${pos} is beyond the end of the block log", ("pos", pos)("size", view.size()) );
+
+         fc::datastream<const char*> ds( view.data() + pos, view.size() - pos );
+         auto b = std::make_shared<signed_block>();
+         fc::raw::unpack( ds, *b );
+         next_pos = pos + ds.tellp() + sizeof(uint64_t);
+         return b;
+      }
+
+      /**
+       * Compressed logs store their blocks in chunks of a fixed number of blocks. On disk a chunk is
+       *
+       *    uint32 uncompressed size | uint32 compressed size | zlib data | uint64 position of the chunk
+       *
+       * and the index file holds the position of every chunk instead of every block. Uncompressed, a chunk is
+       *
+       *    uint32 block count | uint32 offset of each block | packed blocks
+       *
+       * with the offsets relative to the start of the packed blocks.
+       */
+      vector<char> zlib_compress_chunk( const vector<char>& data ) {
+         vector<char> out;
+         bio::filtering_ostream comp;
+         comp.push( bio::zlib_compressor( bio::zlib::default_compression ) );
+         comp.push( bio::back_inserter( out ) );
+         bio::write( comp, data.data(), data.size() );
+         bio::close( comp );
+         return out;
+      }
+
+      /// decompresses the chunk at pos straight out of the mapping
+      vector<char> unpack_chunk( const mapped_log_view& view, uint64_t pos ) {
+         uint32_t sizes[2];
+         ENU_ASSERT( pos + sizeof(sizes) <= view.size(), block_log_exception,
+                     "Chunk position ${pos} is beyond the end of the block log", ("pos", pos)("size", view.size()) );
+         memcpy( sizes, view.data() + pos, sizeof(sizes) );
+         ENU_ASSERT( pos + sizeof(sizes) + sizes[1] <= view.size(), block_log_exception,
+                     "Chunk at position ${pos} is truncated", ("pos", pos) );
+
+         vector<char> out;
+         out.reserve( sizes[0] );
+         bio::filtering_ostream decomp;
+         decomp.push( bio::zlib_decompressor() );
+         decomp.push( bio::back_inserter( out ) );
+         bio::write( decomp, view.data() + pos + sizeof(sizes), sizes[1] );
+         bio::close( decomp );
+         ENU_ASSERT( out.size() == sizes[0], block_log_exception, "Chunk at position ${pos} is corrupted", ("pos", pos) );
+         return out;
+      }
+
+      /// unpacks the i-th block of a decompressed chunk
+      signed_block_ptr unpack_chunk_block( const vector<char>& chunk, uint32_t i ) {
+         uint32_t count = 0;
+         ENU_ASSERT( chunk.size() >= sizeof(count), block_log_exception, "Chunk of block log is corrupted" );
+         memcpy( &count, chunk.data(), sizeof(count) );
+         uint64_t blocks_start = sizeof(count) + uint64_t(sizeof(uint32_t)) * count;
+         ENU_ASSERT( i < count && blocks_start <= chunk.size(), block_log_exception, "Chunk of block log is corrupted" );
+
+         uint32_t offset;
+         memcpy( &offset, chunk.data() + sizeof(count) + sizeof(uint32_t) * i, sizeof(offset) );
+         ENU_ASSERT( blocks_start + offset < chunk.size(), block_log_exception, "Chunk of block log is corrupted" );
+
+         fc::datastream<const char*> ds( chunk.data() + blocks_start + offset, chunk.size() - blocks_start - offset );
+         auto b = std::make_shared<signed_block>();
+         fc::raw::unpack( ds, *b );
+         return b;
+      }
+
+      /// waits until all data of the file written so far has reached the storage device
+      static void sync_file( const fc::path& file ) {
+         int fd = ::open( file.generic_string().c_str(), O_RDONLY );
+         ENU_ASSERT( fd >= 0, block_log_exception, "Unable to open '${file}' to synchronize it: errno ${e}",
+                     ("file", file.generic_string())("e", errno) );
+         auto close_fd = fc::make_scoped_exit( [fd]() { ::close( fd ); } );
+#ifdef __APPLE__
+         int r = ::fsync( fd );
+#else
+         int r = ::fdatasync( fd );
+#endif
+         ENU_ASSERT( r == 0, block_log_exception, "Unable to synchronize '${file}': errno ${e}",
+                     ("file", file.generic_string())("e", errno) );
+      }
+
+      struct log_header {
+         uint32_t version         = uncompressed_log_version;
+         uint32_t first_block_num = 1;
+         uint32_t chunk_blocks    = 0; ///< only present in compressed logs
+      };
+
+      /**
+       * Reads and validates the header of a block log file and leaves the stream positioned at its first block.
+       * Version 1 logs always start at block 1; later versions record the number of their first block.
+       */
+      log_header read_log_header( std::fstream& stream, genesis_state& gs ) {
+         stream.seekg( 0 );
+         uint32_t version = 0;
+         stream.read( (char*)&version, sizeof(version) );
+         ENU_ASSERT( version > 0, block_log_exception, "Block log was not setup properly with genesis information." );
+         ENU_ASSERT( version >= block_log::min_supported_version && version <= block_log::supported_version,
+                    block_log_unsupported_version,
+                    "Unsupported version of block log. Block log version is ${version} while code supports versions ${min} to ${max}",
+                    ("version", version)("min", block_log::min_supported_version)("max", block_log::supported_version) );
+
+         log_header header;
+         header.version = version;
+         if( version >= 2 ) {
+            stream.read( (char*)&header.first_block_num, sizeof(header.first_block_num) );
+            ENU_ASSERT( header.first_block_num > 0, block_log_exception, "Block log has an invalid first block number" );
+         }
+
+         fc::raw::unpack( stream, gs );
+
+         if( version >= compressed_log_version ) {
+            stream.read( (char*)&header.chunk_blocks, sizeof(header.chunk_blocks) );
+            ENU_ASSERT( header.chunk_blocks > 0, block_log_exception, "Compressed block log has an invalid chunk size" );
+         }
+         return header;
+      }
+
+      log_header read_log_header( const fc::path& file, genesis_state& gs ) {
+         std::fstream stream;
+         stream.exceptions( std::fstream::failbit | std::fstream::badbit );
+         stream.open( file.generic_string().c_str(), LOG_READ );
+         return read_log_header( stream, gs );
+      }
+
+      void write_log_header( std::fstream& stream, const log_header& header, const genesis_state& gs ) {
+         auto data = fc::raw::pack( gs );
+         stream.write( (char*)&header.version, sizeof(header.version) );
+         stream.write( (char*)&header.first_block_num, sizeof(header.first_block_num) );
+         stream.write( data.data(), data.size() );
+         if( header.version >= compressed_log_version )
+            stream.write( (char*)&header.chunk_blocks, sizeof(header.chunk_blocks) );
+      }
+
+      /// the active log can only be appended to while it is uncompressed
+      void check_appendable( const log_header& header, const fc::path& file ) {
+         ENU_ASSERT( header.version < compressed_log_version, block_log_exception,
+                     "'${file}' is compressed and can not be appended to", ("file", file.generic_string()) );
+      }
+
+      uint64_t read_pos( const mapped_log_view& view, uint64_t offset ) {
+         ENU_ASSERT( offset + sizeof(uint64_t) <= view.size(), block_log_exception, "Position ${offset} is beyond the end of the block log",
+                     ("offset", offset) );
+         uint64_t pos;
+         memcpy( &pos, view.data() + offset, sizeof(pos) );
+         return pos;
+      }
+
+      /// reads the number of the block starting at pos from the id of its previous block, without unpacking the whole block
+      uint32_t peek_block_num( const mapped_log_view& view, uint64_t pos ) {
+         ENU_ASSERT( pos < view.size(), block_log_exception, "Block position ${pos} is beyond the end of the block log", ("pos", pos) );
+         fc::datastream<const char*> ds( view.data() + pos, view.size() - pos );
+         block_timestamp_type timestamp;
+         account_name         producer;
+         uint16_t             confirmed;
+         block_id_type        previous;
+         fc::raw::unpack( ds, timestamp );
+         fc::raw::unpack( ds, producer );
+         fc::raw::unpack( ds, confirmed );
+         fc::raw::unpack( ds, previous );
+         return block_header::num_from_id( previous ) + 1;
+      }
+
+      /**
+       * Checks whether a block starts at pos of a block file whose first block starts at first_pos: the position
+       * in front of it has to lead back to the two preceding blocks, and all three have to be numbered consecutively.
+       */
+      bool is_block_start( const mapped_log_view& view, uint64_t pos, uint64_t first_pos ) {
+         try {
+            if( pos < first_pos + sizeof(uint64_t) || pos >= view.size() )
+               return false;
+            uint32_t num = peek_block_num( view, pos );
+            for( int i = 0; i < 2; ++i ) {
+               uint64_t prev = read_pos( view, pos - sizeof(uint64_t) );
+               if( prev < first_pos || prev + sizeof(uint64_t) >= pos ||
+                   (prev != first_pos && prev < first_pos + sizeof(uint64_t)) )
+                  return false;
+               if( peek_block_num( view, prev ) + 1 != num )
+                  return false;
+               if( prev == first_pos )
+                  break;
+               pos = prev;
+               --num;
+            }
+            return true;
+         } catch( ... ) {
+            return false;
+         }
+      }
+
+      /**
+       * Rebuilds the index of an uncompressed block file from the position written after every block, without
+       * unpacking any block. The file is split into byte ranges at block boundaries and every range is walked
+       * backwards on its own thread, following those positions and writing them straight into a mapping of the
+       * index file. Progress and throughput are logged while the ranges are walked.
+       *
+       * @return false if the positions do not form a consistent chain of blocks, in which case nothing useful was
+       *         written to the index file and the file has to be scanned serially
+       */
+      bool build_index_backwards( const fc::path& block_file, const fc::path& index_file, uint64_t first_pos, uint32_t first_block_num ) {
+         const uint64_t min_blocks_per_thread = 1000;
+         const uint64_t progress_step         = 1024;
+         auto start_time = fc::time_point::now();
+
+         mapped_log_view view( block_file );
+         uint64_t last_pos = 0;
+         uint32_t head_num = 0;
+         try {
+            if( view.size() < first_pos + sizeof(uint64_t) )
+               return false;
+            last_pos = read_pos( view, view.size() - sizeof(uint64_t) );
+            if( last_pos < first_pos || last_pos + sizeof(uint64_t) >= view.size() )
+               return false;
+            head_num = peek_block_num( view, last_pos );
+         } catch( ... ) {
+            return false;
+         }
+         if( head_num < first_block_num )
+            return false;
+         uint64_t num_blocks = uint64_t(head_num) - first_block_num + 1;
+
+         uint64_t index_size = sizeof(uint64_t) * num_blocks;
+         ENU_ASSERT( ::truncate( index_file.generic_string().c_str(), index_size ) == 0, block_log_exception,
+                     "Unable to resize '${file}': errno ${e}", ("file", index_file.generic_string())("e", errno) );
+         bip::file_mapping  index_mapping( index_file.generic_string().c_str(), bip::read_write );
+         bip::mapped_region index_region( index_mapping, bip::read_write, 0, index_size );
+         char* index_data = static_cast<char*>( index_region.get_address() );
+
+         // ranges start at the first block found after evenly spaced split points
+         uint64_t num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+         num_threads = std::min( num_threads, std::max<uint64_t>( 1, num_blocks / min_blocks_per_thread ) );
+         vector<uint64_t> range_starts{ first_pos };
+         for( uint64_t i = 1; i < num_threads; ++i ) {
+            uint64_t pos = std::max( first_pos + (last_pos - first_pos) / num_threads * i, range_starts.back() + 1 );
+            for( ; pos <= last_pos; ++pos ) {
+               if( is_block_start( view, pos, first_pos ) ) {
+                  range_starts.push_back( pos );
+                  break;
+               }
+            }
+         }
+
+         std::atomic<uint64_t> blocks_done{0};
+         std::atomic<bool>     failed{false};
+         auto walk_range = [&]( size_t r ) {
+            try {
+               uint64_t lowest = range_starts[r];
+               uint64_t pos = last_pos;
+               uint32_t expected = head_num;
+               if( r + 1 < range_starts.size() ) {
+                  // the range ends with the block in front of the next range, which must precede that range's first block
+                  pos = read_pos( view, range_starts[r+1] - sizeof(uint64_t) );
+                  expected = peek_block_num( view, range_starts[r+1] ) - 1;
+               }
+
+               uint64_t walked = 0;
+               while( !failed ) {
+                  if( pos < lowest || pos + sizeof(uint64_t) >= view.size() || peek_block_num( view, pos ) != expected
+                      || expected < first_block_num || expected > head_num || (pos == lowest && r == 0 && expected != first_block_num) ) {
+                     failed = true;
+                     break;
+                  }
+                  memcpy( index_data + sizeof(uint64_t) * (expected - first_block_num), &pos, sizeof(pos) );
+                  if( ++walked % progress_step == 0 )
+                     blocks_done += progress_step;
+                  if( pos == lowest )
+                     break;
+                  if( pos < lowest + sizeof(uint64_t) ) {
+                     failed = true;
+                     break;
+                  }
+                  pos = read_pos( view, pos - sizeof(uint64_t) );
+                  --expected;
+               }
+               blocks_done += walked % progress_step;
+            } catch( ... ) {
+               failed = true;
+            }
+         };
+
+         auto report = [&]() {
+            auto elapsed = std::max<int64_t>( (fc::time_point::now() - start_time).count(), 1 );
+            uint64_t done = blocks_done;
+            ilog( "Reconstructing index of '${file}': ${done} of ${total} blocks (${pct}%), ${rate} blocks/s",
+                  ("file", block_file.generic_string())("done", done)("total", num_blocks)
+                  ("pct", done * 100 / num_blocks)("rate", done * 1000000 / elapsed) );
+         };
+
+         vector<std::future<void>> workers;
+         for( size_t r = 0; r < range_starts.size(); ++r )
+            workers.emplace_back( std::async( std::launch::async, walk_range, r ) );
+         for( auto& w : workers ) {
+            while( w.wait_for( std::chrono::seconds(5) ) != std::future_status::ready )
+               report();
+         }
+
+         if( failed || blocks_done != num_blocks )
+            return false;
+         index_region.flush();
+
+         auto elapsed = std::max<int64_t>( (fc::time_point::now() - start_time).count(), 1 );
+         ilog( "Reconstructed index of ${total} blocks of '${file}' in ${ms} ms using ${threads} threads "
+               "(${rate} blocks/s, ${mbps} MiB/s)",
+               ("total", num_blocks)("file", block_file.generic_string())("ms", elapsed / 1000)
+               ("threads", range_starts.size())("rate", num_blocks * 1000000 / elapsed)
+               ("mbps", view.size() * 1000000 / elapsed / (1024 * 1024)) );
+         return true;
+      }
+
+      /// rebuilds the index of a block file, walking uncompressed files backwards in parallel where possible
+      void build_index( const fc::path& block_file, const fc::path& index_file ) {
+         std::fstream block_stream;
+         std::fstream index_stream;
+         block_stream.exceptions( std::fstream::failbit | std::fstream::badbit );
+         index_stream.exceptions( std::fstream::failbit | std::fstream::badbit );
+
+         fc::remove_all( index_file );
+         block_stream.open( block_file.generic_string().c_str(), LOG_READ );
+         index_stream.open( index_file.generic_string().c_str(), LOG_WRITE );
+
+         genesis_state gs;
+         auto header = read_log_header( block_stream, gs );
+         uint64_t first_pos = block_stream.tellg();
+
+         block_stream.seekg( 0, std::ios::end );
+         uint64_t file_end = block_stream.tellg();
+         if( file_end <= first_pos )
+            return; // no blocks
+
+         if( header.version >= compressed_log_version ) {
+            // walk the chunks by their sizes, each one ends with its own position
+            uint64_t pos = first_pos;
+            while( pos < file_end ) {
+               uint32_t sizes[2];
+               block_stream.seekg( pos );
+               block_stream.read( (char*)sizes, sizeof(sizes) );
+               block_stream.seekg( pos + sizeof(sizes) + sizes[1] );
+               uint64_t chunk_pos;
+               block_stream.read( (char*)&chunk_pos, sizeof(chunk_pos) );
+               ENU_ASSERT( chunk_pos == pos, block_log_exception, "Compressed block log '${file}' is corrupted at position ${pos}",
+                           ("file", block_file.generic_string())("pos", pos) );
+               index_stream.write( (char*)&pos, sizeof(pos) );
+               pos += sizeof(sizes) + sizes[1] + sizeof(chunk_pos);
+            }
+            return;
+         }
+
+         if( build_index_backwards( block_file, index_file, first_pos, header.first_block_num ) )
+            return;
+
+         wlog( "The positions in '${file}' do not form a consistent chain of blocks, reconstructing its index by a serial scan",
+               ("file", block_file.generic_string()) );
+         index_stream.close();
+         fc::remove_all( index_file );
+         index_stream.open( index_file.generic_string().c_str(), LOG_WRITE );
+
+         uint64_t end_pos;
+         block_stream.seekg( -sizeof(uint64_t), std::ios::end );
+         block_stream.read( (char*)&end_pos, sizeof(end_pos) );
+
+         block_stream.seekg( first_pos );
+         signed_block tmp;
+         uint64_t pos;
+         do {
+            fc::raw::unpack( block_stream, tmp );
+            block_stream.read( (char*)&pos, sizeof(pos) );
+            index_stream.write( (char*)&pos, sizeof(pos) );
+         } while( pos < end_pos );
+      }
+
+      /**
+       * Writes the blocks of the uncompressed log src as a compressed log with chunks of chunk_blocks blocks.
+       *
+       * @return the number of the last block written, or 0 if src holds no blocks
+       */
+      uint32_t write_compressed_log( const fc::path& src, const fc::path& dest_block_file, const fc::path& dest_index_file,
+                                     uint32_t chunk_blocks ) {
+         std::fstream in;
+         std::fstream block_stream;
+         std::fstream index_stream;
+         in.exceptions( std::fstream::failbit | std::fstream::badbit );
+         block_stream.exceptions( std::fstream::failbit | std::fstream::badbit );
+         index_stream.exceptions( std::fstream::failbit | std::fstream::badbit );
+
+         in.open( src.generic_string().c_str(), LOG_READ );
+         genesis_state gs;
+         auto header = read_log_header( in, gs );
+         ENU_ASSERT( header.version < compressed_log_version, block_log_exception,
+                     "Block log '${file}' is already compressed", ("file", src.generic_string()) );
+         uint64_t pos = in.tellg();
+         in.seekg( 0, std::ios::end );
+         uint64_t end_pos = in.tellg();
+         in.seekg( pos );
+
+         fc::remove_all( dest_block_file );
+         fc::remove_all( dest_index_file );
+         block_stream.open( dest_block_file.generic_string().c_str(), LOG_WRITE );
+         index_stream.open( dest_index_file.generic_string().c_str(), LOG_WRITE );
+
+         log_header out_header;
+         out_header.version = compressed_log_version;
+         out_header.first_block_num = header.first_block_num;
+         out_header.chunk_blocks = chunk_blocks;
+         write_log_header( block_stream, out_header, gs );
+
+         vector<uint32_t> offsets;
+         vector<char>     blocks_data;
+         vector<char>     chunk;
+         auto write_chunk = [&]() {
+            if( offsets.empty() )
+               return;
+            uint32_t count = offsets.size();
+            chunk.resize( sizeof(count) + sizeof(uint32_t) * count );
+            memcpy( chunk.data(), &count, sizeof(count) );
+            memcpy( chunk.data() + sizeof(count), offsets.data(), sizeof(uint32_t) * count );
+            chunk.insert( chunk.end(), blocks_data.begin(), blocks_data.end() );
+
+            auto compressed = zlib_compress_chunk( chunk );
+            uint64_t chunk_pos = block_stream.tellp();
+            uint32_t sizes[2] = { static_cast<uint32_t>(chunk.size()), static_cast<uint32_t>(compressed.size()) };
+            block_stream.write( (char*)sizes, sizeof(sizes) );
+            block_stream.write( compressed.data(), compressed.size() );
+            block_stream.write( (char*)&chunk_pos, sizeof(chunk_pos) );
+            index_stream.write( (char*)&chunk_pos, sizeof(chunk_pos) );
+
+            offsets.clear();
+            blocks_data.clear();
+         };
+
+         uint32_t block_num = 0;
+         uint32_t expected_num = header.first_block_num;
+         signed_block tmp;
+         while( pos < end_pos ) {
+            fc::raw::unpack( in, tmp );
+            uint64_t trailer;
+            in.read( (char*)&trailer, sizeof(trailer) );
+            ENU_ASSERT( trailer == pos && tmp.block_num() == expected_num, block_log_exception,
+                        "Block log '${file}' is damaged at block ${num}, repair it before compressing it",
+                        ("file", src.generic_string())("num", expected_num) );
+
+            offsets.push_back( blocks_data.size() );
+            auto data = fc::raw::pack( tmp );
+            blocks_data.insert( blocks_data.end(), data.begin(), data.end() );
+            if( offsets.size() == chunk_blocks )
+               write_chunk();
+
+            block_num = expected_num++;
+            pos = in.tellg();
+         }
+         write_chunk();
+
+         block_stream.flush();
+         index_stream.flush();
+         return block_num;
+      }
+
+      /**
+       * Replaces an uncompressed sealed log with its compressed form. The index is removed before the log is
+       * replaced, so an interrupted conversion leaves either the original files or a log whose index is rebuilt.
+       */
+      void compress_sealed_log( const fc::path& block_file, const fc::path& index_file, uint32_t chunk_blocks ) {
+         fc::path tmp_block_file = block_file.generic_string() + ".tmp";
+         fc::path tmp_index_file = index_file.generic_string() + ".tmp";
+         write_compressed_log( block_file, tmp_block_file, tmp_index_file, chunk_blocks );
+         fc::remove_all( index_file );
+         fc::rename( tmp_block_file, block_file );
+         fc::rename( tmp_index_file, index_file );
+      }
+
+      const char* const segment_prefix = "blocks-";
+
+      /// sealed segments are named blocks-<first block num>-<last block num>.log with a matching .index
+      fc::path segment_file( const fc::path& dir, uint32_t first_block_num, uint32_t last_block_num, const char* extension ) {
+         return dir / ( std::string(segment_prefix) + std::to_string(first_block_num) + "-"
+                        + std::to_string(last_block_num) + extension );
+      }
+
+      bool parse_segment_name( const std::string& name, uint32_t& first_block_num, uint32_t& last_block_num ) {
+         unsigned first = 0, last = 0;
+         if( sscanf( name.c_str(), "blocks-%u-%u.log", &first, &last ) != 2 )
+            return false;
+         first_block_num = first;
+         last_block_num = last;
+         return first > 0 && first <= last && segment_file( fc::path(), first, last, ".log" ).generic_string() == name;
+      }
+
+      /// a sealed part of the block log which is no longer appended to
+      struct log_segment {
+         uint32_t   last_block_num = 0;
+         fc::path   block_file;
+         fc::path   index_file;
+         bool       archived = false;
+         log_views  views; ///< mapped on first use
+      };
+
       class block_log_impl {
          public:
             signed_block_ptr         head;
             block_id_type            head_id;
             std::fstream             block_stream;
             std::fstream             index_stream;
+            fc::path                 data_dir;
             fc::path                 block_file;
             fc::path                 index_file;
             bool                     block_write;
             bool                     index_write;
             bool                     genesis_written_to_block_log = false;
+            genesis_state            genesis;
+
+            block_log_config         cfg;
+            fc::path                 archive_dir;
+
+            /// number of bytes of each file which have been flushed and may be read through a mapping
+            std::atomic<uint64_t>    block_file_size{0};
+            std::atomic<uint64_t>    index_file_size{0};
+
+            std::mutex               view_mutex;
+            log_views                active;               ///< guarded by view_mutex, first_block_num also written by the appender
+            vector<log_segment>      segments;             ///< guarded by view_mutex, sorted by first block number
+
+            /// the most recently decompressed chunk, which serves sequential reads of compressed segments
+            std::shared_ptr<const vector<char>> cached_chunk;            ///< guarded by view_mutex
+            uint32_t                            cached_chunk_first_block = 0;
+
+            /// serializes the writers of the files: appends and the batch timer
+            std::mutex               write_mutex;
+            uint32_t                 batch_count = 0;      ///< blocks appended since the last batch ended, guarded by write_mutex
+            fc::time_point           batch_start;          ///< guarded by write_mutex
+            vector<char>             block_data;           ///< blocks are packed here, keeps its capacity from one append to the next
+
+            std::thread              batch_timer;
+            std::condition_variable  batch_timer_cv;
+            bool                     stopping = false;     ///< guarded by write_mutex
+
+            std::future<void>        compression;          ///< of the most recently sealed segment, guarded by write_mutex
+
+            ~block_log_impl() {
+               stop_batch_timer();
+               wait_for_compression();
+            }
+
+            /**
+             * Returns mappings of the active log covering at least its flushed portion. Readers keep the returned
+             * views alive for as long as they use them, so remapping after an append never invalidates a read
+             * that is in progress on another thread.
+             */
+            log_views get_active_views() {
+               std::lock_guard<std::mutex> lock( view_mutex );
+               if( !active.block_view || active.block_view->size() < block_file_size )
+                  active.block_view = std::make_shared<const mapped_log_view>( block_file );
+               if( !active.index_view || active.index_view->size() < index_file_size )
+                  active.index_view = std::make_shared<const mapped_log_view>( index_file );
+               return active;
+            }
+
+            /// @return mappings of the sealed segment containing block_num, or empty views if there is none
+            log_views get_segment_views( uint32_t block_num ) {
+               std::lock_guard<std::mutex> lock( view_mutex );
+               auto* seg = find_segment( block_num );
+               if( !seg )
+                  return log_views();
+               if( !seg->views.block_view ) {
+                  seg->views.block_view = std::make_shared<const mapped_log_view>( seg->block_file );
+                  seg->views.index_view = std::make_shared<const mapped_log_view>( seg->index_file );
+               }
+               return seg->views;
+            }
+
+            /**
+             * Segments normally all span the configured stride, which allows the segment of a block to be
+             * computed directly; otherwise (the stride was changed between runs) fall back to a binary search.
+             */
+            log_segment* find_segment( uint32_t block_num ) {
+               if( segments.empty() || block_num < segments.front().views.first_block_num
+                                    || block_num > segments.back().last_block_num )
+                  return nullptr;
+
+               if( cfg.stride > 0 ) {
+                  auto i = (block_num - segments.front().views.first_block_num) / cfg.stride;
+                  if( i < segments.size() && segments[i].views.first_block_num <= block_num
+                                          && block_num <= segments[i].last_block_num )
+                     return &segments[i];
+               }
+
+               auto itr = std::upper_bound( segments.begin(), segments.end(), block_num,
+                                            []( uint32_t n, const log_segment& s ) { return n < s.views.first_block_num; } );
+               if( itr == segments.begin() )
+                  return nullptr;
+               --itr;
+               return block_num <= itr->last_block_num ? &*itr : nullptr;
+            }
+
+            signed_block_ptr read_compressed_block( const log_views& views, uint32_t block_num ) {
+               uint32_t i = (block_num - views.first_block_num) / views.chunk_blocks;
+               uint32_t chunk_first_block = views.first_block_num + i * views.chunk_blocks;
+
+               std::shared_ptr<const vector<char>> chunk;
+               {
+                  std::lock_guard<std::mutex> lock( view_mutex );
+                  if( cached_chunk && cached_chunk_first_block == chunk_first_block )
+                     chunk = cached_chunk;
+               }
+
+               if( !chunk ) {
+                  uint64_t pos = views.index_entry( i );
+                  if( pos == block_log::npos )
+                     return signed_block_ptr();
+                  chunk = std::make_shared<const vector<char>>( unpack_chunk( *views.block_view, pos ) );
+
+                  std::lock_guard<std::mutex> lock( view_mutex );
+                  cached_chunk = chunk;
+                  cached_chunk_first_block = chunk_first_block;
+               }
+
+               return unpack_chunk_block( *chunk, block_num - chunk_first_block );
+            }
+
+            void add_segments_from( const fc::path& dir, bool archived ) {
+               if( !fc::is_directory( dir ) )
+                  return;
+               for( fc::directory_iterator itr( dir ), end_itr; itr != end_itr; ++itr ) {
+                  uint32_t first = 0, last = 0;
+                  if( !fc::is_regular_file( *itr ) || !parse_segment_name( (*itr).filename().generic_string(), first, last ) )
+                     continue;
+
+                  log_segment seg;
+                  seg.views.first_block_num = first;
+                  seg.last_block_num = last;
+                  seg.block_file = *itr;
+                  seg.index_file = segment_file( dir, first, last, ".index" );
+                  seg.archived = archived;
+
+                  genesis_state gs;
+                  seg.views.chunk_blocks = read_log_header( seg.block_file, gs ).chunk_blocks;
+                  uint64_t entries = last - first + 1;
+                  if( seg.views.chunk_blocks > 0 )
+                     entries = (entries + seg.views.chunk_blocks - 1) / seg.views.chunk_blocks;
+                  if( !fc::exists( seg.index_file ) || fc::file_size( seg.index_file ) != sizeof(uint64_t) * entries ) {
+                     ilog( "Reconstructing index of block log segment '${file}'", ("file", seg.block_file.generic_string()) );
+                     build_index( seg.block_file, seg.index_file );
+                  }
+                  segments.emplace_back( std::move(seg) );
+               }
+            }
+
+            /// discovers the sealed segments in the blocks directory and in the archive directory
+            void load_segments() {
+               std::lock_guard<std::mutex> lock( view_mutex );
+               segments.clear();
+               add_segments_from( data_dir, false );
+               if( !archive_dir.generic_string().empty() && archive_dir.generic_string() != data_dir.generic_string() )
+                  add_segments_from( archive_dir, true );
+
+               std::sort( segments.begin(), segments.end(), []( const log_segment& a, const log_segment& b ) {
+                  return a.views.first_block_num < b.views.first_block_num;
+               });
+               for( size_t i = 1; i < segments.size(); ++i ) {
+                  if( segments[i].views.first_block_num != segments[i-1].last_block_num + 1 )
+                     wlog( "Block log segments are not contiguous: '${a}' is followed by '${b}'",
+                           ("a", segments[i-1].block_file.generic_string())("b", segments[i].block_file.generic_string()) );
+               }
+            }
+
+            /**
+             * Seals the active log as a segment ending at last_block_num and starts a new, empty active log.
+             * The current batch must have been ended before. With compression enabled the sealed segment is
+             * compressed in the background; readers keep using the uncompressed files until that is done.
+             */
+            void rotate( uint32_t last_block_num ) {
+               // retention may move the previous segment, which must not happen while it is being compressed
+               wait_for_compression();
+
+               block_stream.close();
+               index_stream.close();
+
+               std::lock_guard<std::mutex> lock( view_mutex );
+               log_segment seg;
+               seg.views.first_block_num = active.first_block_num;
+               seg.last_block_num = last_block_num;
+               seg.block_file = segment_file( data_dir, active.first_block_num, last_block_num, ".log" );
+               seg.index_file = segment_file( data_dir, active.first_block_num, last_block_num, ".index" );
+               fc::rename( block_file, seg.block_file );
+               fc::rename( index_file, seg.index_file );
+               ilog( "Sealed block log segment '${file}'", ("file", seg.block_file.generic_string()) );
+               segments.emplace_back( std::move(seg) );
+
+               block_stream.open( block_file.generic_string().c_str(), LOG_WRITE );
+               log_header header;
+               header.first_block_num = last_block_num + 1;
+               write_log_header( block_stream, header, genesis );
+               block_stream.flush();
+               index_stream.open( index_file.generic_string().c_str(), LOG_WRITE );
+               block_write = true;
+               index_write = true;
+
+               active = log_views();
+               active.first_block_num = last_block_num + 1;
+               active.first_block_pos = static_cast<uint64_t>( block_stream.tellp() );
+               block_file_size = active.first_block_pos;
+               index_file_size = 0;
+
+               if( cfg.compression_chunk_blocks > 0 ) {
+                  const auto& sealed = segments.back();
+                  compression = std::async( std::launch::async, [this, first = sealed.views.first_block_num,
+                                                                 sealed_block_file = sealed.block_file,
+                                                                 sealed_index_file = sealed.index_file]() {
+                     compress_segment( first, sealed_block_file, sealed_index_file );
+                  });
+               }
+
+               enforce_retention();
+            }
+
+            /**
+             * Writes the compressed form of a sealed segment to temporary files and swaps them in under
+             * view_mutex, so readers either map the uncompressed files or the compressed ones. Mappings held by
+             * readers stay valid after the files are replaced. The index is removed before the log is replaced, so
+             * an interruption leaves either the original files or a log whose index is rebuilt on open.
+             */
+            void compress_segment( uint32_t first_block_num, const fc::path& seg_block_file, const fc::path& seg_index_file ) {
+               fc::path tmp_block_file = seg_block_file.generic_string() + ".tmp";
+               fc::path tmp_index_file = seg_index_file.generic_string() + ".tmp";
+               try {
+                  write_compressed_log( seg_block_file, tmp_block_file, tmp_index_file, cfg.compression_chunk_blocks );
+
+                  std::lock_guard<std::mutex> lock( view_mutex );
+                  auto* seg = find_segment( first_block_num );
+                  ENU_ASSERT( seg && seg->block_file == seg_block_file, block_log_exception,
+                              "Block log segment '${file}' was moved while it was compressed", ("file", seg_block_file.generic_string()) );
+                  fc::remove_all( seg_index_file );
+                  fc::rename( tmp_block_file, seg_block_file );
+                  fc::rename( tmp_index_file, seg_index_file );
+                  seg->views.block_view.reset();
+                  seg->views.index_view.reset();
+                  seg->views.chunk_blocks = cfg.compression_chunk_blocks;
+               } catch( ... ) {
+                  fc::remove_all( tmp_block_file );
+                  fc::remove_all( tmp_index_file );
+                  throw;
+               }
+            }
+
+            /// waits until the last sealed segment is compressed; a failure leaves the segment uncompressed
+            void wait_for_compression() {
+               if( !compression.valid() )
+                  return;
+               try {
+                  compression.get();
+               } FC_LOG_AND_DROP();
+            }
+
+            /// moves (or removes) the oldest segments of the blocks directory beyond the retention limit; view_mutex must be held
+            void enforce_retention() {
+               size_t retained = std::count_if( segments.begin(), segments.end(), []( const log_segment& s ) { return !s.archived; } );
+               for( auto itr = segments.begin(); itr != segments.end() && retained > cfg.max_retained_files; ) {
+                  if( itr->archived ) {
+                     ++itr;
+                     continue;
+                  }
+                  --retained;
+                  // mappings held by readers stay valid after the files are moved or removed
+                  itr->views.block_view.reset();
+                  itr->views.index_view.reset();
+                  if( archive_dir.generic_string().empty() ) {
+                     ilog( "Removing block log segment '${file}'", ("file", itr->block_file.generic_string()) );
+                     fc::remove_all( itr->block_file );
+                     fc::remove_all( itr->index_file );
+                     itr = segments.erase( itr );
+                  } else {
+                     auto new_block_file = archive_dir / itr->block_file.filename();
+                     auto new_index_file = archive_dir / itr->index_file.filename();
+                     ilog( "Archiving block log segment '${file}' to '${dir}'",
+                           ("file", itr->block_file.generic_string())("dir", archive_dir.generic_string()) );
+                     fc::rename( itr->block_file, new_block_file );
+                     fc::rename( itr->index_file, new_index_file );
+                     itr->block_file = new_block_file;
+                     itr->index_file = new_index_file;
+                     itr->archived = true;
+                     ++itr;
+                  }
+               }
+            }
+
+            /// must be called whenever either file of the active log is truncated or replaced
+            void reset_views() {
+               std::lock_guard<std::mutex> lock( view_mutex );
+               active.block_view.reset();
+               active.index_view.reset();
+               block_file_size = fc::exists( block_file ) ? fc::file_size( block_file ) : 0;
+               index_file_size = fc::exists( index_file ) ? fc::file_size( index_file ) : 0;
+            }
+
+            /**
+             * Writes a block to the end of the active log and flushes it to the files, as the caller drops its
+             * reversible copy of the block right after. Only synchronizing the files is left to the end of the batch.
+             * write_mutex must be held.
+             */
+            uint64_t append_block( const signed_block_ptr& b ) {
+               check_block_write();
+               check_index_write();
+
+               uint32_t first_block_num = active.first_block_num;
+               uint64_t pos = block_stream.tellp();
+               uint64_t index_pos = index_stream.tellp();
+               ENU_ASSERT(index_pos == sizeof(uint64_t) * (b->block_num() - first_block_num),
+                         block_log_append_fail,
+                         "Append to index file occuring at wrong position.",
+                         ("position", index_pos)
+                         ("expected", (b->block_num() - first_block_num) * sizeof(uint64_t)));
+
+               // pack into a buffer which is reused for every block, so the block and its position take one write
+               auto size = fc::raw::pack_size(*b);
+               block_data.resize(size + sizeof(pos));
+               fc::datastream<char*> ds(block_data.data(), size);
+               fc::raw::pack(ds, *b);
+               memcpy(block_data.data() + size, &pos, sizeof(pos));
+               block_stream.write(block_data.data(), block_data.size());
+               index_stream.write((char*)&pos, sizeof(pos));
+
+               flush_streams();
+               head = b;
+               head_id = b->id();
+
+               if( batch_count++ == 0 ) {
+                  batch_start = fc::time_point::now();
+                  batch_timer_cv.notify_one();
+               }
+               if( cfg.stride > 0 && b->block_num() % cfg.stride == 0 ) {
+                  end_batch();
+                  rotate( b->block_num() );
+               } else if( batch_count >= cfg.batch_blocks ) {
+                  end_batch();
+               }
+               return pos;
+            }
+
+            /**
+             * Flushes the streams, block file before index file so that the index never refers to a block which has
+             * not reached the block log, and publishes what was flushed to readers of the mappings.
+             */
+            void flush_streams() {
+               block_stream.flush();
+               index_stream.flush();
+
+               std::lock_guard<std::mutex> lock( view_mutex );
+               block_file_size = static_cast<uint64_t>( block_stream.tellp() );
+               index_file_size = static_cast<uint64_t>( index_stream.tellp() );
+            }
+
+            /// ends the current batch, synchronizing both files in the fdatasync mode. write_mutex must be held.
+            void end_batch() {
+               if( batch_count == 0 )
+                  return;
+
+               flush_streams();
+               if( cfg.sync_mode == block_log_sync_mode::fdatasync ) {
+                  sync_file( block_file );
+                  sync_file( index_file );
+               }
+               batch_count = 0;
+            }
+
+            /// ends every batch once it is batch_interval old, even when no further block is appended to the log
+            void start_batch_timer() {
+               batch_timer = std::thread( [this]() {
+                  std::unique_lock<std::mutex> lock( write_mutex );
+                  while( !stopping ) {
+                     // an idle timer is woken by the append starting the next batch
+                     batch_timer_cv.wait( lock, [this]() { return stopping || batch_count > 0; } );
+                     auto deadline = batch_start + cfg.batch_interval;
+                     batch_timer_cv.wait_for( lock, std::chrono::microseconds( (deadline - fc::time_point::now()).count() ),
+                                              [this]() { return stopping || batch_count == 0; } );
+                     if( !stopping && batch_count > 0 && fc::time_point::now() - batch_start >= cfg.batch_interval ) {
+                        try {
+                           end_batch();
+                        } FC_LOG_AND_DROP();
+                     }
+                  }
+               });
+            }
+
+            void stop_batch_timer() {
+               if( !batch_timer.joinable() )
+                  return;
+               {
+                  std::lock_guard<std::mutex> lock( write_mutex );
+                  stopping = true;
+               }
+               batch_timer_cv.notify_all();
+               batch_timer.join();
+            }
 
             inline void check_block_read() {
                if (block_write) {
@@ -64,11 +1023,129 @@ namespace enumivo { namespace chain {
       };
    }
 
-   block_log::block_log(const fc::path& data_dir)
+   namespace detail {
+      class block_read_ahead_impl {
+         public:
+            struct slot {
+               bool                ready = false;
+               signed_block_ptr    block;
+               std::exception_ptr  error;
+            };
+
+            block_read_ahead_impl( const block_log& log, uint32_t first_block_num, uint32_t last_block_num, uint32_t max_blocks,
+                                   std::function<void(const signed_block_ptr&)> on_read )
+            :log(log)
+            ,on_read( std::move(on_read) )
+            ,slots( std::max( max_blocks, 1u ) )
+            ,next_to_read( first_block_num )
+            ,next_to_return( first_block_num )
+            ,last_block_num( last_block_num )
+            {}
+
+            /// worker loop: claims the next unread block as long as it stays within the window of blocks ahead
+            void read_blocks() {
+               while( true ) {
+                  uint32_t block_num;
+                  {
+                     std::unique_lock<std::mutex> lock( mtx );
+                     slot_freed.wait( lock, [this]() {
+                        return stopping || next_to_read > last_block_num || next_to_read - next_to_return < slots.size();
+                     });
+                     if( stopping || next_to_read > last_block_num )
+                        return;
+                     block_num = next_to_read++;
+                  }
+
+                  slot result;
+                  result.ready = true;
+                  try {
+                     result.block = log.read_block_by_num( block_num );
+                     if( result.block && on_read )
+                        on_read( result.block );
+                  } catch( ... ) {
+                     result.error = std::current_exception();
+                  }
+
+                  {
+                     std::lock_guard<std::mutex> lock( mtx );
+                     slots[block_num % slots.size()] = std::move( result );
+                  }
+                  block_ready.notify_all();
+               }
+            }
+
+            signed_block_ptr next() {
+               slot result;
+               {
+                  std::unique_lock<std::mutex> lock( mtx );
+                  if( next_to_return > last_block_num )
+                     return signed_block_ptr();
+                  auto& s = slots[next_to_return % slots.size()];
+                  block_ready.wait( lock, [&s]() { return s.ready; } );
+                  result = std::move( s );
+                  s = slot();
+                  ++next_to_return;
+               }
+               slot_freed.notify_all();
+
+               if( result.error )
+                  std::rethrow_exception( result.error );
+               return result.block;
+            }
+
+            void stop() {
+               {
+                  std::lock_guard<std::mutex> lock( mtx );
+                  stopping = true;
+               }
+               slot_freed.notify_all();
+               for( auto& t : workers )
+                  t.join();
+               workers.clear();
+            }
+
+            const block_log&         log;
+            std::function<void(const signed_block_ptr&)> on_read;
+            std::mutex               mtx;
+            std::condition_variable  slot_freed;
+            std::condition_variable  block_ready;
+            vector<slot>             slots;          ///< block n is kept in slots[n % slots.size()]
+            uint32_t                 next_to_read;
+            uint32_t                 next_to_return;
+            uint32_t                 last_block_num;
+            bool                     stopping = false;
+            vector<std::thread>      workers;
+      };
+   }
+
+   block_read_ahead::block_read_ahead( const block_log& log, uint32_t first_block_num, uint32_t last_block_num,
+                                       uint32_t max_blocks, uint32_t num_threads,
+                                       std::function<void(const signed_block_ptr&)> on_read )
+   :my( new detail::block_read_ahead_impl( log, first_block_num, last_block_num, max_blocks, std::move(on_read) ) ) {
+      auto impl = my.get();
+      for( uint32_t i = 0; i < std::max( num_threads, 1u ); ++i )
+         my->workers.emplace_back( [impl]() { impl->read_blocks(); } );
+   }
+
+   block_read_ahead::~block_read_ahead() {
+      my->stop();
+   }
+
+   signed_block_ptr block_read_ahead::next() {
+      return my->next();
+   }
+
+   block_log::block_log(const fc::path& data_dir, const block_log_config& cfg)
    :my(new detail::block_log_impl()) {
       my->block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
       my->index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+      my->cfg = cfg;
+      my->cfg.batch_blocks = cfg.sync_mode == block_log_sync_mode::fdatasync ? std::max( cfg.batch_blocks, 1u ) : 1;
+      if( my->cfg.max_retained_files == 0 )
+         my->cfg.max_retained_files = 1;
       open(data_dir);
+      if( my->cfg.batch_blocks > 1 && my->cfg.batch_interval > fc::microseconds() )
+         my->start_batch_timer();
    }
 
    block_log::block_log(block_log&& other) {
@@ -90,14 +1167,24 @@ namespace enumivo { namespace chain {
 
       if (!fc::is_directory(data_dir))
          fc::create_directories(data_dir);
+      my->data_dir = data_dir;
       my->block_file = data_dir / "blocks.log";
       my->index_file = data_dir / "blocks.index";
 
+      my->archive_dir = fc::path();
+      if( my->cfg.stride > 0 && !my->cfg.archive_dir.generic_string().empty() ) {
+         my->archive_dir = my->cfg.archive_dir.is_relative() ? data_dir / my->cfg.archive_dir : my->cfg.archive_dir;
+         if( !fc::is_directory( my->archive_dir ) )
+            fc::create_directories( my->archive_dir );
+      }
+
       //ilog("Opening block log at ${path}", ("path", my->block_file.generic_string()));
       my->block_stream.open(my->block_file.generic_string().c_str(), LOG_WRITE);
       my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
       my->block_write = true;
       my->index_write = true;
+      my->reset_views();
+      my->load_segments();
 
       /* On startup of the block log, there are several states the log file and the index file can be
        * in relation to each other.
@@ -116,6 +1203,9 @@ namespace enumivo { namespace chain {
        *  - If they are the same, do nothing.
        *  - If the index file head is not in the log file, delete the index and replay.
        *  - If the index file head is in the log, but not up to date, replay from index head.
+       *
+       * Only the active log (blocks.log) is checked here; it never holds more than one stride of blocks
+       * when segmenting is enabled, which bounds the cost of reconstructing its index.
        */
       auto log_size = fc::file_size(my->block_file);
       auto index_size = fc::file_size(my->index_file);
@@ -123,19 +1213,26 @@ namespace enumivo { namespace chain {
       if (log_size) {
          ilog("Log is nonempty");
          my->check_block_read();
-         my->block_stream.seekg( 0 );
-         uint32_t version = 0;
-         my->block_stream.read( (char*)&version, sizeof(version) );
-         ENU_ASSERT( version > 0, block_log_exception, "Block log was not setup properly with genesis information." );
-         ENU_ASSERT( version == block_log::supported_version, block_log_unsupported_version,
-                    "Unsupported version of block log. Block log version is ${version} while code supports version ${supported}",
-                    ("version", version)("supported", block_log::supported_version) );
+         auto header = detail::read_log_header( my->block_stream, my->genesis );
+         detail::check_appendable( header, my->block_file );
+         uint64_t first_block_pos = my->block_stream.tellg();
+         {
+            std::lock_guard<std::mutex> lock( my->view_mutex );
+            my->active.first_block_num = header.first_block_num;
+            my->active.first_block_pos = first_block_pos;
+         }
 
          my->genesis_written_to_block_log = true; // Assume it was constructed properly.
          my->head = read_head();
-         my->head_id = my->head->id();
+         if( my->head )
+            my->head_id = my->head->id();
 
-         if (index_size) {
+         if (log_size <= first_block_pos) {
+            if (index_size) {
+               ilog("Log has no blocks but index is nonempty, remove and recreate it");
+               construct_index();
+            }
+         } else if (index_size) {
             my->check_block_read();
             my->check_index_read();
 
@@ -165,6 +1262,7 @@ namespace enumivo { namespace chain {
          fc::remove_all(my->index_file);
          my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
          my->index_write = true;
+         my->reset_views();
       }
    }
 
@@ -172,35 +1270,26 @@ namespace enumivo { namespace chain {
       try {
          ENU_ASSERT( my->genesis_written_to_block_log, block_log_append_fail, "Cannot append to block log until the genesis is first written" );
 
-         my->check_block_write();
-         my->check_index_write();
-
-         uint64_t pos = my->block_stream.tellp();
-         ENU_ASSERT(my->index_stream.tellp() == sizeof(uint64_t) * (b->block_num() - 1),
-                   block_log_append_fail,
-                   "Append to index file occuring at wrong position.",
-                   ("position", (uint64_t) my->index_stream.tellp())
-                   ("expected", (b->block_num() - 1) * sizeof(uint64_t)));
-         auto data = fc::raw::pack(*b);
-         my->block_stream.write(data.data(), data.size());
-         my->block_stream.write((char*)&pos, sizeof(pos));
-         my->index_stream.write((char*)&pos, sizeof(pos));
-         my->head = b;
-         my->head_id = b->id();
-
-         flush();
-
-         return pos;
+         std::lock_guard<std::mutex> lock( my->write_mutex );
+         return my->append_block( b );
       }
       FC_LOG_AND_RETHROW()
    }
 
    void block_log::flush() {
-      my->block_stream.flush();
-      my->index_stream.flush();
+      std::lock_guard<std::mutex> lock( my->write_mutex );
+      my->end_batch();
+      my->flush_streams();
    }
 
    uint64_t block_log::reset_to_genesis( const genesis_state& gs, const signed_block_ptr& genesis_block ) {
+      return reset( gs, genesis_block );
+   }
+
+   uint64_t block_log::reset( const genesis_state& gs, const signed_block_ptr& first_block ) {
+      std::lock_guard<std::mutex> lock( my->write_mutex );
+      my->batch_count = 0;
+
       if( my->block_stream.is_open() )
          my->block_stream.close();
       if( my->index_stream.is_open() )
@@ -213,26 +1302,33 @@ namespace enumivo { namespace chain {
       my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
       my->block_write = true;
       my->index_write = true;
+      my->reset_views();
 
-      auto data = fc::raw::pack( gs );
-      uint32_t version = 0; // version of 0 is invalid; it indicates that the genesis was not properly written to the block log
-      my->block_stream.write( (char*)&version, sizeof(version) );
-      my->block_stream.write( data.data(), data.size() );
+      my->genesis = gs;
+      detail::log_header header;
+      header.version = 0; // version of 0 is invalid; it indicates that the genesis was not properly written to the block log
+      header.first_block_num = first_block->block_num();
+      detail::write_log_header( my->block_stream, header, gs );
       my->genesis_written_to_block_log = true;
+      {
+         std::lock_guard<std::mutex> lock( my->view_mutex );
+         my->active.first_block_num = header.first_block_num;
+         my->active.first_block_pos = static_cast<uint64_t>( my->block_stream.tellp() );
+      }
 
-      auto ret = append( genesis_block );
+      auto ret = my->append_block( first_block );
+      my->end_batch();
 
       auto pos = my->block_stream.tellp();
 
       my->block_stream.close();
       my->block_stream.open(my->block_file.generic_string().c_str(), std::ios::in | std::ios::out | std::ios::binary ); // Bypass append-only writing just once
 
-      static_assert( block_log::supported_version > 0, "a version number of zero is not supported" );
-      version = block_log::supported_version;
+      uint32_t version = detail::uncompressed_log_version;
       my->block_stream.seekp( 0 );
       my->block_stream.write( (char*)&version, sizeof(version) ); // Finally write actual version to disk.
       my->block_stream.seekp( pos );
-      flush();
+      my->flush_streams();
 
       my->block_write = false;
       my->check_block_write(); // Reset to append-only writing.
@@ -241,22 +1337,32 @@ namespace enumivo { namespace chain {
    }
 
    std::pair<signed_block_ptr, uint64_t> block_log::read_block(uint64_t pos)const {
-      my->check_block_read();
-
-      my->block_stream.seekg(pos);
+      auto views = my->get_active_views();
       std::pair<signed_block_ptr,uint64_t> result;
-      result.first = std::make_shared<signed_block>();
-      fc::raw::unpack(my->block_stream, *result.first);
-      result.second = uint64_t(my->block_stream.tellg()) + 8;
+      result.first = detail::unpack_block( *views.block_view, pos, result.second );
       return result;
    }
 
    signed_block_ptr block_log::read_block_by_num(uint32_t block_num)const {
       try {
          signed_block_ptr b;
-         uint64_t pos = get_block_pos(block_num);
-         if (pos != npos) {
-            b = read_block(pos).first;
+
+         // The index entry of a block is written after the block itself, so any block with a flushed index
+         // entry is also completely contained in the flushed portion of the block file.
+         auto views = my->get_active_views();
+         if( block_num < views.first_block_num )
+            views = my->get_segment_views( block_num );
+
+         if( views.chunk_blocks > 0 ) {
+            b = my->read_compressed_block( views, block_num );
+         } else {
+            uint64_t pos = views.block_pos( block_num );
+            if( pos != npos ) {
+               uint64_t next_pos;
+               b = detail::unpack_block( *views.block_view, pos, next_pos );
+            }
+         }
+         if (b) {
             ENU_ASSERT(b->block_num() == block_num, reversible_blocks_exception,
                       "Wrong block was read from block log.", ("returned", b->block_num())("expected", block_num));
          }
@@ -265,29 +1371,34 @@ namespace enumivo { namespace chain {
    }
 
    uint64_t block_log::get_block_pos(uint32_t block_num) const {
-      my->check_index_read();
-
-      if (!(my->head && block_num <= block_header::num_from_id(my->head_id) && block_num > 0))
+      if( block_num == 0 )
          return npos;
-      my->index_stream.seekg(sizeof(uint64_t) * (block_num - 1));
-      uint64_t pos;
-      my->index_stream.read((char*)&pos, sizeof(pos));
-      return pos;
+
+      return my->get_active_views().block_pos( block_num );
    }
 
    signed_block_ptr block_log::read_head()const {
-      my->check_block_read();
-
+      auto views = my->get_active_views();
       uint64_t pos;
+      uint64_t log_size = views.block_view->size();
 
-      // Check that the file is not empty
-      my->block_stream.seekg(0, std::ios::end);
-      if (my->block_stream.tellg() <= sizeof(pos))
-         return {};
+      // Check that the active log contains blocks
+      if( log_size > views.first_block_pos && log_size > sizeof(pos) ) {
+         memcpy( &pos, views.block_view->data() + log_size - sizeof(pos), sizeof(pos) );
+         return read_block(pos).first;
+      }
 
-      my->block_stream.seekg(-sizeof(pos), std::ios::end);
-      my->block_stream.read((char*)&pos, sizeof(pos));
-      return read_block(pos).first;
+      // the active log is still empty, the head is the last block of the newest segment
+      uint32_t last_sealed = 0;
+      {
+         std::lock_guard<std::mutex> lock( my->view_mutex );
+         if( !my->segments.empty() )
+            last_sealed = my->segments.back().last_block_num;
+      }
+      if( last_sealed > 0 )
+         return read_block_by_num( last_sealed );
+
+      return {};
    }
 
    const signed_block_ptr& block_log::head()const {
@@ -297,28 +1408,13 @@ namespace enumivo { namespace chain {
    void block_log::construct_index() {
       ilog("Reconstructing Block Log Index...");
       my->index_stream.close();
-      fc::remove_all(my->index_file);
-      my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
-      my->index_write = true;
-
-      uint64_t end_pos;
       my->check_block_read();
 
-      my->block_stream.seekg(-sizeof( uint64_t), std::ios::end);
-      my->block_stream.read((char*)&end_pos, sizeof(end_pos));
-      signed_block tmp;
+      detail::build_index( my->block_file, my->index_file );
 
-      uint64_t pos = 4; // Skip version which should have already been checked.
-      my->block_stream.seekg(pos);
-
-      genesis_state gs;
-      fc::raw::unpack(my->block_stream, gs);
-
-      while( pos < end_pos ) {
-         fc::raw::unpack(my->block_stream, tmp);
-         my->block_stream.read((char*)&pos, sizeof(pos));
-         my->index_stream.write((char*)&pos, sizeof(pos));
-      }
+      my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
+      my->index_write = true;
+      my->reset_views();
    } // construct_index
 
    fc::path block_log::repair_log( const fc::path& data_dir, uint32_t truncate_at_block ) {
@@ -347,6 +1443,20 @@ namespace enumivo { namespace chain {
       fc::create_directories(blocks_dir);
       auto block_log_path = blocks_dir / "blocks.log";
 
+      // Sealed segments and archive directories are never appended to and do not need recovering, so move them
+      // back. The reversible blocks database is left in the backup for the caller to recover.
+      for( fc::directory_iterator itr( backup_dir ), end_itr; itr != end_itr; ++itr ) {
+         auto name = (*itr).filename().generic_string();
+         if( name == "blocks.log" || name == "blocks.index" || name == config::reversible_blocks_dir_name )
+            continue;
+         uint32_t first = 0, last = 0;
+         bool is_index = name.size() > 6 && name.compare( name.size() - 6, 6, ".index" ) == 0;
+         if( fc::is_directory( *itr ) || detail::parse_segment_name( name, first, last )
+             || (is_index && detail::parse_segment_name( name.substr( 0, name.size() - 6 ) + ".log", first, last )) ) {
+            fc::rename( *itr, blocks_dir / name );
+         }
+      }
+
       ilog( "Reconstructing '${new_block_log}' from backed up block log", ("new_block_log", block_log_path) );
 
       std::fstream  old_block_stream;
@@ -357,21 +1467,13 @@ namespace enumivo { namespace chain {
 
       old_block_stream.seekg( 0, std::ios::end );
       uint64_t end_pos = old_block_stream.tellg();
-      old_block_stream.seekg( 0 );
-
-      uint32_t version = 0;
-      old_block_stream.read( (char*)&version, sizeof(version) );
-      ENU_ASSERT( version > 0, block_log_exception, "Block log was not setup properly with genesis information." );
-      ENU_ASSERT( version == block_log::supported_version, block_log_unsupported_version,
-                 "Unsupported version of block log. Block log version is ${version} while code supports version ${supported}",
-                 ("version", version)("supported", block_log::supported_version) );
 
       genesis_state gs;
-      fc::raw::unpack(old_block_stream, gs);
-
-      auto data = fc::raw::pack( gs );
-      new_block_stream.write( (char*)&version, sizeof(version) );
-      new_block_stream.write( data.data(), data.size() );
+      auto header = detail::read_log_header( old_block_stream, gs );
+      detail::check_appendable( header, backup_dir / "blocks.log" );
+      uint32_t first_block_num = header.first_block_num;
+      header.version = detail::uncompressed_log_version;
+      detail::write_log_header( new_block_stream, header, gs );
 
       std::exception_ptr     except_ptr;
       vector<char>           incomplete_block_data;
@@ -394,6 +1496,13 @@ namespace enumivo { namespace chain {
          }
 
          auto id = tmp.id();
+         if( block_num == 0 && first_block_num > 1 ) {
+            // the log continues a sealed segment, so there is no previous block to link to
+            ENU_ASSERT( tmp.block_num() == first_block_num, block_log_exception,
+                        "First block in block log is ${num} but the log header says it starts at ${first}",
+                        ("num", tmp.block_num())("first", first_block_num) );
+            previous = tmp.previous;
+         }
          if( block_header::num_from_id(previous) + 1 != block_header::num_from_id(id) ) {
             elog( "Block ${num} (${id}) skips blocks. Previous block in block log is block ${prev_num} (${previous})",
                   ("num", block_header::num_from_id(id))("id", id)
@@ -415,11 +1524,13 @@ namespace enumivo { namespace chain {
             break;
          }
 
+         // the header of the new log may differ in size from the old one, so positions are tracked per file
+         uint64_t new_pos = new_block_stream.tellp();
          auto data = fc::raw::pack(tmp);
          new_block_stream.write( data.data(), data.size() );
-         new_block_stream.write( reinterpret_cast<char*>(&pos), sizeof(pos) );
+         new_block_stream.write( reinterpret_cast<char*>(&new_pos), sizeof(new_pos) );
          block_num = tmp.block_num();
-         pos = new_block_stream.tellp();
+         pos = old_block_stream.tellg();
          if( block_num == truncate_at_block )
             break;
       }
@@ -470,16 +1581,72 @@ namespace enumivo { namespace chain {
       std::fstream  block_stream;
       block_stream.open( (data_dir / "blocks.log").generic_string().c_str(), LOG_READ );
 
-      uint32_t version = 0;
-      block_stream.read( (char*)&version, sizeof(version) );
-      ENU_ASSERT( version > 0, block_log_exception, "Block log was not setup properly with genesis information." );
-      ENU_ASSERT( version == block_log::supported_version, block_log_unsupported_version,
-                 "Unsupported version of block log. Block log version is ${version} while code supports version ${supported}",
-                 ("version", version)("supported", block_log::supported_version) );
-
       genesis_state gs;
-      fc::raw::unpack(block_stream, gs);
+      detail::read_log_header( block_stream, gs );
       return gs;
    }
 
+   void block_log::compress_log( const fc::path& data_dir, uint32_t chunk_blocks, const fc::path& archive_dir ) {
+      ENU_ASSERT( chunk_blocks > 0, block_log_exception, "Compressed block log chunks must hold at least one block" );
+      ENU_ASSERT( fc::is_directory(data_dir) && fc::is_regular_file(data_dir / "blocks.log"), block_log_not_found,
+                 "Block log not found in '${blocks_dir}'", ("blocks_dir", data_dir)          );
+
+      auto compress_segments_in = [chunk_blocks]( const fc::path& dir ) {
+         if( !fc::is_directory( dir ) )
+            return;
+         vector<fc::path> files;
+         for( fc::directory_iterator itr( dir ), end_itr; itr != end_itr; ++itr ) {
+            uint32_t first = 0, last = 0;
+            if( fc::is_regular_file( *itr ) && detail::parse_segment_name( (*itr).filename().generic_string(), first, last ) )
+               files.emplace_back( *itr );
+         }
+         for( const auto& file : files ) {
+            genesis_state gs;
+            if( detail::read_log_header( file, gs ).version >= detail::compressed_log_version )
+               continue;
+            ilog( "Compressing block log segment '${file}'", ("file", file.generic_string()) );
+            fc::path index_file = file.generic_string().substr( 0, file.generic_string().size() - 4 ) + ".index";
+            detail::compress_sealed_log( file, index_file, chunk_blocks );
+         }
+      };
+
+      compress_segments_in( data_dir );
+      if( !archive_dir.generic_string().empty() )
+         compress_segments_in( archive_dir.is_relative() ? data_dir / archive_dir : archive_dir );
+
+      // The blocks of blocks.log become a sealed, compressed segment and blocks.log starts over empty, continuing
+      // after the last block, so that the node can keep appending to it.
+      auto block_file = data_dir / "blocks.log";
+      auto index_file = data_dir / "blocks.index";
+      genesis_state gs;
+      auto header = detail::read_log_header( block_file, gs );
+      detail::check_appendable( header, block_file );
+
+      ilog( "Compressing '${file}'", ("file", block_file.generic_string()) );
+      auto tmp_block_file = data_dir / "blocks.log.tmp";
+      auto tmp_index_file = data_dir / "blocks.index.tmp";
+      uint32_t last_block_num = detail::write_compressed_log( block_file, tmp_block_file, tmp_index_file, chunk_blocks );
+      if( last_block_num == 0 ) {
+         fc::remove_all( tmp_block_file );
+         fc::remove_all( tmp_index_file );
+         ilog( "'${file}' holds no blocks", ("file", block_file.generic_string()) );
+         return;
+      }
+      fc::rename( tmp_block_file, detail::segment_file( data_dir, header.first_block_num, last_block_num, ".log" ) );
+      fc::rename( tmp_index_file, detail::segment_file( data_dir, header.first_block_num, last_block_num, ".index" ) );
+
+      {
+         std::fstream new_block_stream;
+         new_block_stream.exceptions( std::fstream::failbit | std::fstream::badbit );
+         new_block_stream.open( tmp_block_file.generic_string().c_str(), LOG_WRITE );
+         detail::log_header new_header;
+         new_header.first_block_num = last_block_num + 1;
+         detail::write_log_header( new_block_stream, new_header, gs );
+      }
+      fc::remove_all( index_file );
+      fc::rename( tmp_block_file, block_file );
+
+      ilog( "Compressed blocks ${first} to ${last} of the block log", ("first", header.first_block_num)("last", last_block_num) );
+   }
+
 } } /// enumivo::chain
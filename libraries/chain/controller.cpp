@@ -3,9 +3,12 @@
 
 #include <enumivo/chain/block_log.hpp>
 #include <enumivo/chain/fork_database.hpp>
+#include <enumivo/chain/snapshot.hpp>
+#include <enumivo/chain/replay_profiler.hpp>
 
 #include <enumivo/chain/account_object.hpp>
 #include <enumivo/chain/block_summary_object.hpp>
+#include <enumivo/chain/feature_activation_object.hpp>
 #include <enumivo/chain/global_property_object.hpp>
 #include <enumivo/chain/contract_table_objects.hpp>
 #include <enumivo/chain/generated_transaction_object.hpp>
@@ -14,6 +17,8 @@
 
 #include <enumivo/chain/authorization_manager.hpp>
 #include <enumivo/chain/resource_limits.hpp>
+#include <enumivo/chain/thread_utils.hpp>
+#include <enumivo/chain/signature_recovery_cache.hpp>
 
 #include <chainbase/chainbase.hpp>
 #include <fc/io/json.hpp>
@@ -34,7 +39,8 @@ struct pending_state {
 
    block_state_ptr                    _pending_block_state;
 
-   vector<action_receipt>             _actions;
+   merkle_accumulator                 _action_merkle; ///< digests of the action receipts of the block
+   merkle_accumulator                 _trx_merkle;    ///< digests of the transaction receipts of the block
 
    controller::block_status           _block_status = controller::block_status::incomplete;
 
@@ -43,6 +49,18 @@ struct pending_state {
    }
 };
 
+static block_log_config make_block_log_config( const controller::config& cfg ) {
+   block_log_config blog_cfg;
+   blog_cfg.sync_mode          = cfg.block_log_sync;
+   blog_cfg.batch_blocks       = cfg.block_log_batch_blocks;
+   blog_cfg.batch_interval     = fc::milliseconds( cfg.block_log_batch_interval_ms );
+   blog_cfg.stride             = cfg.blocks_log_stride;
+   blog_cfg.max_retained_files = cfg.max_retained_block_files;
+   blog_cfg.archive_dir        = cfg.blocks_archive_dir;
+   blog_cfg.compression_chunk_blocks = cfg.block_log_compression_chunk;
+   return blog_cfg;
+}
+
 struct controller_impl {
    controller&                    self;
    chainbase::database            db;
@@ -71,6 +89,22 @@ struct controller_impl {
     */
    map<digest_type, transaction_metadata_ptr>     unapplied_transactions;
 
+   /// threads recovering the signing keys of transactions ahead of their use, if any were configured
+   std::unique_ptr<boost::asio::thread_pool>      thread_pool;
+
+   /// threads hashing the action receipts of transactions with many actions, kept apart from the signature recovery
+   std::unique_ptr<boost::asio::thread_pool>      merkle_pool;
+
+   using prepared_transactions = vector<std::shared_future<transaction_metadata_ptr>>;
+
+   /**
+    *  Transactions of blocks passed to prepare_block, one entry per receipt of the block (without a value
+    *  for receipts of scheduled transactions), ordered by block number as block ids start with it.
+    */
+   map<block_id_type, prepared_transactions>      prepared_blocks;
+   std::mutex                                     prepared_blocks_mutex;
+   static const size_t                            max_prepared_blocks = 1024;
+
    void pop_block() {
       auto prev = fork_db.get_block( head->header.previous );
       ENU_ASSERT( prev, block_validate_exception, "attempt to pop beyond last irreversible block" );
@@ -90,6 +124,57 @@ struct controller_impl {
    }
 
 
+   /// a snapshot of a reversible head block, kept aside until the block is irreversible
+   struct pending_snapshot {
+      block_id_type   block_id;
+      fc::path        pending_file;
+      fc::path        file;
+      std::function<void()> written;
+   };
+   vector<pending_snapshot>                       pending_snapshots;
+
+   /**
+    *  Writes a snapshot of the head state. If the head block is irreversible, that is in the block log, it goes to
+    *  file right away. Otherwise it is kept in a .pending file next to it, which on_irreversible moves to file once
+    *  the block is irreversible, or removes if the block is forked out. Nothing is popped or applied again for it.
+    */
+   void write_snapshot( const fc::path& file, std::function<void()> written ) {
+      if( !blog.head() )
+         blog.read_head();
+
+      if( blog.head() && head->block_num <= blog.head()->block_num() ) {
+         snapshot::write( file, db, conf.genesis, *head );
+         ilog( "Wrote snapshot of block ${num} to '${file}'", ("num", head->block_num)("file", file.generic_string()) );
+         if( written ) written();
+         return;
+      }
+
+      fc::path pending_file = file.generic_string() + ".pending";
+      snapshot::write( pending_file, db, conf.genesis, *head );
+      ilog( "Wrote snapshot of reversible block ${num} to '${file}', it is moved to '${final}' once the block is irreversible",
+            ("num", head->block_num)("file", pending_file.generic_string())("final", file.generic_string()) );
+      pending_snapshots.push_back( { head->id, pending_file, file, std::move( written ) } );
+   }
+
+   void finalize_pending_snapshots( const block_state_ptr& s ) {
+      auto itr = pending_snapshots.begin();
+      while( itr != pending_snapshots.end() ) {
+         if( block_header::num_from_id( itr->block_id ) > s->block_num ) {
+            ++itr;
+            continue;
+         }
+         if( itr->block_id == s->id ) {
+            fc::rename( itr->pending_file, itr->file );
+            ilog( "Wrote snapshot of block ${num} to '${file}'", ("num", s->block_num)("file", itr->file.generic_string()) );
+            if( itr->written ) itr->written();
+         } else {
+            fc::remove( itr->pending_file );
+            wlog( "Removed snapshot '${file}', its block ${id} was forked out", ("file", itr->pending_file.generic_string())("id", itr->block_id) );
+         }
+         itr = pending_snapshots.erase( itr );
+      }
+   }
+
    void set_apply_handler( account_name receiver, account_name contract, action_name action, apply_handler v ) {
       apply_handlers[receiver][make_pair(contract,action)] = v;
    }
@@ -102,9 +187,9 @@ struct controller_impl {
     reversible_blocks( cfg.blocks_dir/config::reversible_blocks_dir_name,
         cfg.read_only ? database::read_only : database::read_write,
         cfg.reversible_cache_size ),
-    blog( cfg.blocks_dir ),
+    blog( cfg.blocks_dir, make_block_log_config( cfg ) ),
     fork_db( cfg.state_dir ),
-    wasmif( cfg.wasm_runtime ),
+    wasmif( cfg.wasm_runtime, cfg.wasm_cache_dir, cfg.wasm_instantiation_cache_size, cfg.wasm_compile_threads ),
     resource_limits( db ),
     authorization( s, db ),
     conf( cfg ),
@@ -134,6 +219,14 @@ struct controller_impl {
                                  on_irreversible(b);
                                  });
 
+   if( cfg.signature_recovery_threads > 0 )
+      thread_pool.reset( new boost::asio::thread_pool( cfg.signature_recovery_threads ) );
+
+   if( cfg.merkle_threads > 0 )
+      merkle_pool.reset( new boost::asio::thread_pool( cfg.merkle_threads ) );
+
+   signature_recovery_cache::instance().set_capacity( cfg.signature_recovery_cache_size );
+
    }
 
    /**
@@ -195,6 +288,8 @@ struct controller_impl {
          fork_db.set_validity( s, true );
          head = s;
       }
+      if( pending_snapshots.size() )
+         finalize_pending_snapshots( s );
       emit( self.irreversible_block, s );
    }
 
@@ -203,23 +298,62 @@ struct controller_impl {
       /**
       *  The fork database needs an initial block_state to be set before
       *  it can accept any new blocks. This initial block state can be found
-      *  in the database (whose head block state should be irreversible) or
-      *  it would be the genesis state.
+      *  in the database (whose head block state should be irreversible),
+      *  restored from a snapshot, or it would be the genesis state.
       */
       if( !head ) {
-         initialize_fork_db(); // set head to genesis state
+         if( !conf.snapshot.empty() )
+            initialize_from_snapshot(); // set head to the snapshot state
+         else
+            initialize_fork_db(); // set head to genesis state
 
          auto end = blog.read_head();
-         if( end && end->block_num() > 1 ) {
+         if( end && !conf.snapshot.empty() ) {
+            ENU_ASSERT( end->block_num() >= head->block_num, fork_database_exception,
+                        "block log ends at block ${blog_head}, before the snapshot taken at block ${head}",
+                        ("blog_head",end->block_num())("head",head->block_num) );
+            auto snapshot_block = blog.read_block_by_num( head->block_num );
+            ENU_ASSERT( snapshot_block && snapshot_block->id() == head->id, fork_database_exception,
+                        "block log does not contain the block the snapshot was taken at", ("head",head->block_num) );
+         }
+         if( end && end->block_num() > head->block_num ) {
             replaying = true;
-            ilog( "existing block log, attempting to replay ${n} blocks", ("n",end->block_num()) );
+            ilog( "existing block log, attempting to replay ${n} blocks", ("n",end->block_num() - head->block_num) );
+
+            optional<replay_profiler> profiler;
+            boost::signals2::scoped_connection profiler_connection;
+            if( !conf.replay_profile.empty() ) {
+               profiler.emplace( conf.replay_profile_slowest_blocks );
+               profiler_connection = self.applied_transaction.connect( [&]( const transaction_trace_ptr& trace ) {
+                  profiler->add_transaction( *trace );
+               });
+            }
 
             auto start = fc::time_point::now();
-            while( auto next = blog.read_block_by_num( head->block_num + 1 ) ) {
+            auto start_block_num = head->block_num;
+            auto replay_block = [&]( const signed_block_ptr& next ) {
+               auto block_start = fc::time_point::now();
                self.push_block( next, controller::block_status::irreversible );
+               if( profiler )
+                  profiler->add_block( next->block_num(), fc::time_point::now() - block_start );
                if( next->block_num() % 100 == 0 ) {
                   std::cerr << std::setw(10) << next->block_num() << " of " << end->block_num() <<"\r";
                }
+            };
+            if( conf.replay_read_ahead_threads > 0 ) {
+               // blocks are read from the block log and unpacked on other threads while the previous ones are applied;
+               // the signing keys of their transactions are only needed, and recovered as soon as they are read, when
+               // all checks are forced
+               std::function<void(const signed_block_ptr&)> on_read;
+               if( conf.force_all_checks )
+                  on_read = [this]( const signed_block_ptr& b ) { prepare_block( b ); };
+               block_read_ahead read_ahead( blog, head->block_num + 1, end->block_num(),
+                                            conf.replay_read_ahead_blocks, conf.replay_read_ahead_threads, on_read );
+               while( auto next = read_ahead.next() )
+                  replay_block( next );
+            } else {
+               while( auto next = blog.read_block_by_num( head->block_num + 1 ) )
+                  replay_block( next );
             }
 
             int rev = 0;
@@ -232,11 +366,21 @@ struct controller_impl {
             ilog( "${n} reversible blocks replayed", ("n",rev) );
             auto end = fc::time_point::now();
             ilog( "replayed ${n} blocks in ${duration} seconds, ${mspb} ms/block",
-                  ("n", head->block_num)("duration", (end-start).count()/1000000)
-                  ("mspb", ((end-start).count()/1000.0)/head->block_num)        );
+                  ("n", head->block_num - start_block_num)("duration", (end-start).count()/1000000)
+                  ("mspb", ((end-start).count()/1000.0)/(head->block_num - start_block_num))        );
             std::cerr<< "\n";
+
+            if( profiler ) {
+               profiler_connection.disconnect();
+               try {
+                  profiler->write( conf.replay_profile );
+                  ilog( "replay profile written to '${file}'", ("file", conf.replay_profile.generic_string()) );
+               } FC_LOG_AND_DROP();
+            }
             replaying = false;
 
+         } else if( !end && !conf.snapshot.empty() ) {
+            blog.reset( conf.genesis, head->block );
          } else if( !end ) {
             blog.reset_to_genesis( conf.genesis, head->block );
          }
@@ -267,9 +411,45 @@ struct controller_impl {
          db.undo();
       }
 
+      precompile_contracts();
+   }
+
+   /**
+    *  Compiles the contracts that received the most actions in the background, so the first blocks
+    *  after startup are not held up compiling them.
+    */
+   void precompile_contracts() {
+      vector<const account_object*> contracts;
+      for( const auto& a : db.get_index<account_index>().indices() ) {
+         if( a.code.size() > 0 )
+            contracts.push_back( &a );
+      }
+      auto n = std::min<size_t>( conf.wasm_precompile_contracts, contracts.size() );
+      if( n == 0 )
+         return;
+
+      const auto& sequences = db.get_index<account_sequence_index,by_name>();
+      auto recv_sequence = [&]( const account_object* a ) {
+         auto itr = sequences.find( a->name );
+         return itr != sequences.end() ? itr->recv_sequence : 0;
+      };
+      std::partial_sort( contracts.begin(), contracts.begin() + n, contracts.end(),
+                         [&]( const account_object* l, const account_object* r ) {
+         return recv_sequence( l ) > recv_sequence( r );
+      });
+      for( size_t i = 0; i < n; ++i )
+         wasmif.precompile( contracts[i]->code_version, contracts[i]->code );
    }
 
    ~controller_impl() {
+      if( thread_pool ) {
+         thread_pool->stop();
+         thread_pool->join();
+      }
+      if( merkle_pool ) {
+         merkle_pool->stop();
+         merkle_pool->join();
+      }
       pending.reset();
 
       db.flush();
@@ -295,6 +475,7 @@ struct controller_impl {
       db.add_index<block_summary_multi_index>();
       db.add_index<transaction_multi_index>();
       db.add_index<generated_transaction_multi_index>();
+      db.add_index<feature_activation_multi_index>();
 
       authorization.add_indices();
       resource_limits.add_indices();
@@ -336,6 +517,21 @@ struct controller_impl {
       initialize_database();
    }
 
+   /**
+    *  Sets the state database and the fork database head to the state of the snapshot.
+    */
+   void initialize_from_snapshot() {
+      ilog( "Initializing chain state from snapshot '${file}'", ("file", conf.snapshot.generic_string()) );
+      auto header = snapshot::read( conf.snapshot, db );
+      ENU_ASSERT( header.genesis.compute_chain_id() == chain_id, snapshot_validation_exception,
+                  "snapshot is of a different chain", ("snapshot_chain_id", header.genesis.compute_chain_id())("chain_id", chain_id) );
+
+      head = std::make_shared<block_state>( header.head );
+      head->block = std::make_shared<signed_block>( std::move(header.head_block) );
+      fork_db.set( head );
+      db.set_revision( head->block_num );
+   }
+
    void create_native_account( account_name name, const authority& owner, const authority& active, bool is_privileged = false ) {
       db.create<account_object>([&](auto& a) {
          a.name = name;
@@ -449,16 +645,19 @@ struct controller_impl {
    fc::scoped_exit<std::function<void()>> make_block_restore_point() {
       auto orig_block_transactions_size = pending->_pending_block_state->block->transactions.size();
       auto orig_state_transactions_size = pending->_pending_block_state->trxs.size();
-      auto orig_state_actions_size      = pending->_actions.size();
+      auto orig_action_merkle           = pending->_action_merkle;
+      auto orig_trx_merkle              = pending->_trx_merkle;
 
       std::function<void()> callback = [this,
                                         orig_block_transactions_size,
                                         orig_state_transactions_size,
-                                        orig_state_actions_size]()
+                                        orig_action_merkle,
+                                        orig_trx_merkle]()
       {
          pending->_pending_block_state->block->transactions.resize(orig_block_transactions_size);
          pending->_pending_block_state->trxs.resize(orig_state_transactions_size);
-         pending->_actions.resize(orig_state_actions_size);
+         pending->_action_merkle = orig_action_merkle;
+         pending->_trx_merkle = orig_trx_merkle;
       };
 
       return fc::make_scoped_exit( std::move(callback) );
@@ -492,7 +691,7 @@ struct controller_impl {
          auto restore = make_block_restore_point();
          trace->receipt = push_receipt( gtrx.trx_id, transaction_receipt::soft_fail,
                                         trx_context.billed_cpu_time_us, trace->net_usage );
-         fc::move_append( pending->_actions, move(trx_context.executed) );
+         push_action_receipts( trx_context.executed );
 
          emit( self.applied_transaction, trace );
 
@@ -602,7 +801,7 @@ struct controller_impl {
                                         trx_context.billed_cpu_time_us,
                                         trace->net_usage );
 
-         fc::move_append( pending->_actions, move(trx_context.executed) );
+         push_action_receipts( trx_context.executed );
 
          emit( self.applied_transaction, trace );
 
@@ -682,9 +881,23 @@ struct controller_impl {
       r.cpu_usage_us         = cpu_usage_us;
       r.net_usage_words      = net_usage_words;
       r.status               = status;
+      pending->_trx_merkle.append( r.digest() );
       return r;
    }
 
+   /**
+    *  Adds the digests of the action receipts of a transaction to the action merkle of the pending block. The
+    *  digests of a transaction with many actions, and the subtrees they fill, are calculated on the merkle pool.
+    */
+   void push_action_receipts( const vector<action_receipt>& receipts ) {
+      if( merkle_pool && receipts.size() > merkle_batch_size ) {
+         pending->_action_merkle.append( calculate_digests( receipts, merkle_pool.get() ), merkle_pool.get() );
+         return;
+      }
+      for( const auto& a : receipts )
+         pending->_action_merkle.append( a.digest() );
+   }
+
    /**
     *  This is the entry point for new transactions to the block state. It will check authorization and
     *  determine whether to execute it now or to delay it. Lastly it inserts a transaction receipt into
@@ -756,7 +969,7 @@ struct controller_impl {
                trace->receipt = r;
             }
 
-            fc::move_append(pending->_actions, move(trx_context.executed));
+            push_action_receipts( trx_context.executed );
 
             // call the accept signal but only once for this transaction
             if (!trx->accepted) {
@@ -804,6 +1017,7 @@ struct controller_impl {
       });
 
       pending = db.start_undo_session(true);
+      resource_limits.reset_cached_objects();
 
       pending->_block_status = s;
 
@@ -878,11 +1092,17 @@ struct controller_impl {
 
          transaction_trace_ptr trace;
 
-         for( const auto& receipt : b->transactions ) {
+         auto prepared = take_prepared_transactions( b );
+         for( size_t i = 0; i < b->transactions.size(); ++i ) {
+            const auto& receipt = b->transactions[i];
             auto num_pending_receipts = pending->_pending_block_state->block->transactions.size();
             if( receipt.trx.contains<packed_transaction>() ) {
                auto& pt = receipt.trx.get<packed_transaction>();
-               auto mtrx = std::make_shared<transaction_metadata>(pt);
+               transaction_metadata_ptr mtrx = find_unapplied_transaction( pt );
+               if( !mtrx && i < prepared.size() && prepared[i].valid() )
+                  mtrx = prepared[i].get();
+               if( !mtrx )
+                  mtrx = std::make_shared<transaction_metadata>(pt);
                trace = push_transaction( mtrx, fc::time_point::maximum(), false, receipt.cpu_usage_us, true );
             } else if( receipt.trx.contains<transaction_id_type>() ) {
                trace = push_scheduled_transaction( receipt.trx.get<transaction_id_type>(), fc::time_point::maximum(), receipt.cpu_usage_us, true );
@@ -938,6 +1158,76 @@ struct controller_impl {
    } FC_CAPTURE_AND_RETHROW() } /// apply_block
 
 
+   /**
+    *  Returns the metadata of the transaction if it was already pushed speculatively and is waiting in
+    *  unapplied_transactions, so a block including it does not unpack it and recover its keys again.
+    */
+   transaction_metadata_ptr find_unapplied_transaction( const packed_transaction& pt )const {
+      if( unapplied_transactions.empty() )
+         return transaction_metadata_ptr();
+      auto itr = unapplied_transactions.find( digest_type::hash( pt ) );
+      if( itr == unapplied_transactions.end() )
+         return transaction_metadata_ptr();
+      return itr->second;
+   }
+
+   /**
+    *  Unpacks the transactions of the block and recovers their signing keys on the thread pool, for apply_block
+    *  to pick up. Does nothing during a replay which skips authorization checks, as the keys are never used then.
+    *  Safe to call from any thread.
+    */
+   void prepare_block( const signed_block_ptr& b ) {
+      if( !thread_pool || b->transactions.empty() || (replaying && !conf.force_all_checks) )
+         return;
+
+      auto id = b->id();
+      {
+         std::lock_guard<std::mutex> lock( prepared_blocks_mutex );
+         if( prepared_blocks.count( id ) )
+            return;
+      }
+
+      prepared_transactions trxs;
+      trxs.reserve( b->transactions.size() );
+      for( const auto& receipt : b->transactions ) {
+         if( receipt.trx.contains<packed_transaction>() ) {
+            const auto* pt = &receipt.trx.get<packed_transaction>();
+            trxs.emplace_back( async_thread_pool( *thread_pool, [b, pt, chain_id = chain_id]() {
+               auto mtrx = std::make_shared<transaction_metadata>( *pt );
+               try {
+                  mtrx->recover_keys( chain_id );
+               } catch( ... ) {
+                  // leave the keys to be recovered again by push_transaction, which reports the failure
+               }
+               return mtrx;
+            }).share() );
+         } else {
+            trxs.emplace_back();
+         }
+      }
+
+      std::lock_guard<std::mutex> lock( prepared_blocks_mutex );
+      if( prepared_blocks.size() >= max_prepared_blocks )
+         prepared_blocks.erase( prepared_blocks.begin() );
+      prepared_blocks.emplace( id, std::move( trxs ) );
+   }
+
+   /// removes and returns the transactions prepared for the block, dropping those of older blocks never applied
+   prepared_transactions take_prepared_transactions( const signed_block_ptr& b ) {
+      prepared_transactions trxs;
+      if( !thread_pool || b->transactions.empty() )
+         return trxs;
+
+      auto id = b->id();
+      std::lock_guard<std::mutex> lock( prepared_blocks_mutex );
+      auto itr = prepared_blocks.find( id );
+      if( itr != prepared_blocks.end() && itr->second.size() == b->transactions.size() )
+         trxs = std::move( itr->second );
+      while( !prepared_blocks.empty() && block_header::num_from_id( prepared_blocks.begin()->first ) <= b->block_num() )
+         prepared_blocks.erase( prepared_blocks.begin() );
+      return trxs;
+   }
+
    void push_block( const signed_block_ptr& b, controller::block_status s ) {
     //  idump((fc::json::to_pretty_string(*b)));
       ENU_ASSERT(!pending, block_validate_exception, "it is not valid to push a block when there is a pending block");
@@ -1047,22 +1337,11 @@ struct controller_impl {
    }
 
    void set_action_merkle() {
-      vector<digest_type> action_digests;
-      action_digests.reserve( pending->_actions.size() );
-      for( const auto& a : pending->_actions )
-         action_digests.emplace_back( a.digest() );
-
-      pending->_pending_block_state->header.action_mroot = merkle( move(action_digests) );
+      pending->_pending_block_state->header.action_mroot = pending->_action_merkle.get_root();
    }
 
    void set_trx_merkle() {
-      vector<digest_type> trx_digests;
-      const auto& trxs = pending->_pending_block_state->block->transactions;
-      trx_digests.reserve( trxs.size() );
-      for( const auto& a : trxs )
-         trx_digests.emplace_back( a.digest() );
-
-      pending->_pending_block_state->header.transaction_mroot = merkle( move(trx_digests) );
+      pending->_pending_block_state->header.transaction_mroot = pending->_trx_merkle.get_root();
    }
 
 
@@ -1307,6 +1586,11 @@ chainbase::database& controller::db()const { return my->db; }
 
 fork_database& controller::fork_db()const { return my->fork_db; }
 
+void controller::write_snapshot( const path& file, std::function<void()> written ) {
+   ENU_ASSERT( !my->pending, block_validate_exception, "cannot write a snapshot while a block is pending" );
+   my->write_snapshot( file, std::move( written ) );
+}
+
 
 void controller::start_block( block_timestamp_type when, uint16_t confirm_block_count) {
    validate_db_available_size();
@@ -1332,9 +1616,15 @@ void controller::abort_block() {
    my->abort_block();
 }
 
+void controller::prepare_block( const signed_block_ptr& b ) {
+   my->prepare_block( b );
+}
+
 void controller::push_block( const signed_block_ptr& b, block_status s ) {
    validate_db_available_size();
    validate_reversible_available_size();
+   // recover the keys of all transactions of the block in parallel, unless that was started ahead of time
+   my->prepare_block( b );
    my->push_block( b, s );
 }
 
@@ -1509,6 +1799,26 @@ int64_t controller::set_proposed_producers( vector<producer_key> producers ) {
    return version;
 }
 
+void controller::activate_feature( name feature ) {
+   ENU_ASSERT( my->pending, block_validate_exception, "no pending block to activate feature ${feature} in", ("feature", feature) );
+   ENU_ASSERT( feature == config::batch_db_feature_name, unsupported_feature, "Unsupported Hardfork Detected" );
+   ENU_ASSERT( !my->db.find<feature_activation_object, by_feature>( feature ), unsupported_feature,
+               "feature ${feature} is already activated", ("feature", feature) );
+
+   my->db.create<feature_activation_object>( [&]( auto& f ) {
+      f.feature              = feature;
+      f.activation_block_num = my->pending->_pending_block_state->block_num;
+   });
+}
+
+bool controller::is_feature_active( name feature )const {
+   const auto* f = my->db.find<feature_activation_object, by_feature>( feature );
+   if( !f )
+      return false;
+   const auto& bs = my->pending ? *my->pending->_pending_block_state : *my->head;
+   return f->activation_block_num <= bs.dpos_irreversible_blocknum;
+}
+
 const producer_schedule_type&    controller::active_producers()const {
    if ( !(my->pending) )
       return  my->head->active_schedule;
@@ -169,6 +169,10 @@ void apply_enumivo_setcode(apply_context& context) {
    if (new_size != old_size) {
       context.trx_context.add_ram_usage( act.account, new_size - old_size );
    }
+
+   // the new code is likely to be used soon, compiling it now keeps that from stalling the action that does
+   if( code_size > 0 )
+      context.control.get_wasm_interface().precompile( code_id, account.code );
 }
 
 void apply_enumivo_setabi(apply_context& context) {
@@ -18,6 +18,17 @@ namespace enumivo { namespace chain {
 class controller;
 class transaction_context;
 
+/**
+ * Header of each row in the buffers of the batched table intrinsics. Rows are packed back to back, each header
+ * immediately followed by size bytes of value, with no alignment padding.
+ */
+struct db_batch_row {
+   uint64_t primary  = 0;
+   int32_t  iterator = -1;
+   uint32_t size     = 0;
+};
+static_assert( sizeof(db_batch_row) == 16, "db_batch_row is shared with contracts and must not be padded" );
+
 class apply_context {
    private:
       template<typename T>
@@ -551,6 +562,22 @@ class apply_context {
       int  db_upperbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
       int  db_end_i64( uint64_t code, uint64_t scope, uint64_t table );
 
+      /**
+       * Copies up to max_rows consecutive rows, starting with the row of iterator, into buffer and sets next to the
+       * iterator of the first row that was not copied (the end iterator of the table once it is exhausted).
+       * Copying stops early at the first row that does not fit in the rest of buffer.
+       * @return the number of rows copied
+       */
+      int  db_get_batch_i64( int iterator, char* buffer, size_t buffer_size, uint32_t max_rows, int& next );
+      /**
+       * Stores each row of buffer under its primary key, ignoring the iterators of the rows. The iterators of the new
+       * rows are consecutive.
+       * @return the iterator of the first row stored, or -1 if buffer has no rows
+       */
+      int  db_store_batch_i64( uint64_t scope, uint64_t table, const account_name& payer, const char* buffer, size_t buffer_size );
+      /// Replaces the value of the row of each iterator in buffer, whose primary keys must match the rows
+      void db_update_batch_i64( account_name payer, const char* buffer, size_t buffer_size );
+
    private:
 
       const table_id_object* find_table( name code, name scope, name table );
@@ -6,10 +6,30 @@
 #include <fc/filesystem.hpp>
 #include <enumivo/chain/block.hpp>
 #include <enumivo/chain/genesis_state.hpp>
+#include <functional>
 
 namespace enumivo { namespace chain {
 
-   namespace detail { class block_log_impl; }
+   namespace detail { class block_log_impl; class block_read_ahead_impl; }
+
+   /**
+    * Controls how appended blocks are written out to the block log files.
+    */
+   enum class block_log_sync_mode {
+      none,      ///< every append is written and flushed to the files right away, the files are never synchronized
+      flush,     ///< same as none
+      fdatasync  ///< every append is written and flushed right away, and the files are synchronized once per batch
+   };
+
+   struct block_log_config {
+      block_log_sync_mode sync_mode          = block_log_sync_mode::flush;
+      uint32_t            batch_blocks       = 1;      ///< maximum number of blocks in a batch, fdatasync mode only
+      fc::microseconds    batch_interval;              ///< maximum age of a batch, fdatasync mode only
+      uint32_t            stride             = 0;      ///< number of blocks per log segment, 0 keeps a single log file
+      uint32_t            max_retained_files = std::numeric_limits<uint32_t>::max(); ///< sealed segments kept in the blocks directory
+      fc::path            archive_dir;                 ///< where segments beyond max_retained_files go; relative to the blocks directory, empty to delete them
+      uint32_t            compression_chunk_blocks = 0; ///< compress sealed segments in chunks of this many blocks, 0 leaves them uncompressed
+   };
 
    /* The block log is an external append only log of the blocks. Blocks should only be written
     * to the log after they irreverisble as the log is append only. The log is a doubly linked
@@ -32,13 +52,44 @@ namespace enumivo { namespace chain {
     * Blocks can be accessed at random via block number through the index file. Seek to 8 * (block_num - 1)
     * to find the position of the block in the main file.
     *
+    * Starting with version 2 the main file begins with a header holding the version, the number of the first
+    * block in the file, and the genesis state. Version 1 files have no first block number and start at block 1.
+    * For files that do not start at block 1 the index lookup becomes 8 * (block_num - first_block_num).
+    *
+    * When a stride is configured the log is split into segments. blocks.log (with blocks.index) holds the most
+    * recent blocks and is sealed every time a block number that is a multiple of the stride is appended: it is
+    * renamed to blocks-<first block num>-<last block num>.log (and .index) and a new, empty blocks.log is
+    * started. Segments beyond the retention limit are moved to the archive directory, or deleted when there is
+    * none, and blocks in archived segments remain readable. The segment holding a block is found directly from
+    * the block number.
+    *
+    * Sealed segments may be stored compressed (version 3). Their blocks are grouped into chunks of a fixed number
+    * of blocks which are compressed with zlib one by one, and their index holds the position of every chunk
+    * rather than of every block. Reading a block decompresses its chunk; the last decompressed chunk is kept so
+    * that reading consecutive blocks decompresses every chunk only once. Segments are compressed in the background
+    * once they are sealed when a chunk size is configured, and existing logs are converted offline by compress_log.
+    *
     * The main file is the only file that needs to persist. The index file can be reconstructed during a
     * linear scan of the main file.
+    *
+    * Reads are served from read-only memory mappings of both files and blocks are unpacked directly out of
+    * the mapping, so reading never disturbs the append streams. Only data that has been flushed is visible
+    * to readers, and the read methods may be called from other threads while the log is being appended to.
+    *
+    * Every appended block is written and flushed to the files before append returns, since the chain state already
+    * holds it and the caller drops its reversible copy right after, so a crash of the process never loses a block
+    * which was appended. In the fdatasync mode appends are grouped into batches which end once either the configured
+    * number of blocks has been appended or the first block of the batch has reached the configured age, checked by a
+    * timer so that a batch also ends when no further block arrives, and the files are synchronized to the storage
+    * device at the end of every batch. The other modes never synchronize the files. The block file is always flushed
+    * and synchronized before the index file so that, after a crash, the files either agree or the index is behind and
+    * gets reconstructed on open. A partially written tail of the block file is dropped by repair_log
+    * (--hard-replay-blockchain).
     */
 
    class block_log {
       public:
-         block_log(const fc::path& data_dir);
+         block_log(const fc::path& data_dir, const block_log_config& cfg = block_log_config());
          block_log(block_log&& other);
          ~block_log();
 
@@ -46,6 +97,12 @@ namespace enumivo { namespace chain {
          void flush();
          uint64_t reset_to_genesis( const genesis_state& gs, const signed_block_ptr& genesis_block );
 
+         /**
+          * Starts a new, empty log whose first block is first_block, such as the head block of a snapshot the chain
+          * state was initialized from.
+          */
+         uint64_t reset( const genesis_state& gs, const signed_block_ptr& first_block );
+
          std::pair<signed_block_ptr, uint64_t> read_block(uint64_t file_pos)const;
          signed_block_ptr read_block_by_num(uint32_t block_num)const;
          signed_block_ptr read_block_by_id(const block_id_type& id)const {
@@ -53,7 +110,8 @@ namespace enumivo { namespace chain {
          }
 
          /**
-          * Return offset of block in file, or block_log::npos if it does not exist.
+          * Return offset of block in blocks.log, or block_log::npos if it does not exist there. Blocks of sealed
+          * segments have no position in blocks.log.
           */
          uint64_t get_block_pos(uint32_t block_num) const;
          signed_block_ptr        read_head()const;
@@ -62,11 +120,19 @@ namespace enumivo { namespace chain {
          static const uint64_t npos = std::numeric_limits<uint64_t>::max();
 
          static const uint32_t supported_version;
+         static const uint32_t min_supported_version;
 
          static fc::path repair_log( const fc::path& data_dir, uint32_t truncate_at_block = 0 );
 
          static genesis_state extract_genesis_state( const fc::path& data_dir );
 
+         /**
+          * Converts an existing block log to the compressed format. Uncompressed sealed segments in data_dir and
+          * archive_dir are compressed in place, and the blocks of blocks.log are moved into a new compressed
+          * segment, leaving an empty blocks.log which continues after them. Must not be called while the log is open.
+          */
+         static void compress_log( const fc::path& data_dir, uint32_t chunk_blocks, const fc::path& archive_dir = fc::path() );
+
       private:
          void open(const fc::path& data_dir);
          void construct_index();
@@ -74,4 +140,29 @@ namespace enumivo { namespace chain {
          std::unique_ptr<detail::block_log_impl> my;
    };
 
+   /**
+    * Reads a range of blocks from a block log in order, with worker threads reading and unpacking up to
+    * max_blocks blocks ahead of the block last returned by next(). Used to overlap reading the block log with
+    * applying its blocks during a replay. The block log must outlive the read-ahead. If given, on_read is called
+    * on the worker thread with every block read, before the block is handed out by next().
+    */
+   class block_read_ahead {
+      public:
+         block_read_ahead( const block_log& log, uint32_t first_block_num, uint32_t last_block_num,
+                           uint32_t max_blocks, uint32_t num_threads,
+                           std::function<void(const signed_block_ptr&)> on_read = std::function<void(const signed_block_ptr&)>() );
+         ~block_read_ahead();
+
+         /**
+          * Waits for the next block of the range and returns it. Returns an empty pointer after the last block of
+          * the range or if the block is missing from the log; an error reading the block is rethrown.
+          */
+         signed_block_ptr next();
+
+      private:
+         std::unique_ptr<detail::block_read_ahead_impl> my;
+   };
+
 } }
+
+FC_REFLECT_ENUM( enumivo::chain::block_log_sync_mode, (none)(flush)(fdatasync) )
@@ -16,8 +16,23 @@ const static auto default_blocks_dir_name    = "blocks";
 const static auto reversible_blocks_dir_name = "reversible";
 const static auto default_reversible_cache_size = 340*1024*1024ll;/// 1MB * 340 blocks based on 21 producer BFT delay
 const static auto default_reversible_guard_size = 2*1024*1024ll;/// 1MB * 340 blocks based on 21 producer BFT delay
+const static uint32_t default_block_log_batch_blocks      = 1000; ///< maximum number of blocks in a block log batch
+const static uint32_t default_block_log_batch_interval_ms = 1000; ///< maximum age of a block log batch
+const static auto default_blocks_archive_dir_name = "archive";
+const static uint32_t default_block_log_compression_chunk_blocks = 64; ///< blocks per chunk when converting a block log to the compressed format
+const static uint32_t default_replay_read_ahead_blocks  = 256; ///< blocks read ahead of the block being applied during a replay
+const static uint32_t default_replay_read_ahead_threads = 2;   ///< threads reading blocks ahead during a replay
+const static uint32_t default_signature_recovery_threads = 4;  ///< threads recovering transaction signing keys ahead of their use
+const static uint64_t default_signature_recovery_cache_size = 100000; ///< signing keys remembered between receiving a transaction and applying it
+const static uint32_t default_replay_profile_slowest_blocks = 20; ///< slowest blocks listed in a replay profile
+const static uint32_t default_incoming_transaction_threads = 2; ///< threads recovering the signing keys of incoming transactions
+const static uint32_t default_merkle_threads = 2; ///< threads hashing the action merkle of transactions with many actions
 
 const static auto default_state_dir_name     = "state";
+const static auto default_wasm_cache_dir_name = "wasm-cache";
+const static uint64_t default_wasm_instantiation_cache_size = 1024*1024*1024ll; ///< bytes of compiled contracts kept in memory
+const static uint32_t default_wasm_compile_threads = 1;       ///< threads compiling contracts ahead of their use
+const static uint32_t default_wasm_precompile_contracts = 32; ///< most used contracts compiled at startup
 const static auto forkdb_filename            = "forkdb.dat";
 const static auto default_state_size            = 1*1024*1024*1024ll;
 const static auto default_state_guard_size      = 128*1024*1024ll;
@@ -39,6 +54,9 @@ const static uint64_t owner_name  = N(owner);
 const static uint64_t enumivo_any_name = N(enumivo.any);
 const static uint64_t enumivo_code_name = N(enumivo.code);
 
+/// features a privileged contract can activate with activate_feature
+const static uint64_t batch_db_feature_name = N(batchdb); ///< db_get_batch_i64, db_store_batch_i64 and db_update_batch_i64
+
 const static int      block_interval_ms = 500;
 const static int      block_interval_us = block_interval_ms*1000;
 const static uint64_t block_timestamp_epoch = 946684800000ll; // epoch is year 2000.
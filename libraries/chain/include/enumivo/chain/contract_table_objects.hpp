@@ -10,9 +10,19 @@
 
 #include <chainbase/chainbase.hpp>
 
+#include <boost/multi_index/hashed_index.hpp>
+
 #include <array>
 #include <type_traits>
 
+/**
+ * When set, key_value_index also has a hashed (table, primary key) index used for the point lookups of db_find_i64.
+ * It changes the layout of the state database, so a node switching it must be restarted from a snapshot or replayed.
+ */
+#ifndef ENUMIVO_HASHED_KEY_VALUE_INDEX
+#define ENUMIVO_HASHED_KEY_VALUE_INDEX 0
+#endif
+
 namespace enumivo { namespace chain {
 
    /**
@@ -50,9 +60,21 @@ namespace enumivo { namespace chain {
    using table_id = table_id_object::id_type;
 
    struct by_scope_primary;
+   struct by_scope_primary_hash;
    struct by_scope_secondary;
    struct by_scope_tertiary;
 
+   /// index of key_value_index used to find a row by its table and primary key
+#if ENUMIVO_HASHED_KEY_VALUE_INDEX
+   using by_point_lookup = by_scope_primary_hash;
+#else
+   using by_point_lookup = by_scope_primary;
+#endif
+
+   struct table_id_hash {
+      size_t operator()( const table_id& id )const { return std::hash<int64_t>()( id._id ); }
+   };
+
 
    struct key_value_object : public chainbase::object<key_value_object_type, key_value_object> {
       OBJECT_CTOR(key_value_object, (value))
@@ -78,6 +100,16 @@ namespace enumivo { namespace chain {
             >,
             composite_key_compare< std::less<table_id>, std::less<uint64_t> >
          >
+#if ENUMIVO_HASHED_KEY_VALUE_INDEX
+         ,
+         bmi::hashed_unique<tag<by_scope_primary_hash>,
+            composite_key< key_value_object,
+               member<key_value_object, table_id, &key_value_object::t_id>,
+               member<key_value_object, uint64_t, &key_value_object::primary_key>
+            >,
+            bmi::composite_key_hash< table_id_hash, std::hash<uint64_t> >
+         >
+#endif
       >
    >;
 
@@ -2,6 +2,7 @@
 #include <enumivo/chain/block_state.hpp>
 #include <enumivo/chain/trace.hpp>
 #include <enumivo/chain/genesis_state.hpp>
+#include <enumivo/chain/block_log.hpp>
 #include <boost/signals2/signal.hpp>
 
 #include <enumivo/chain/abi_serializer.hpp>
@@ -59,8 +60,28 @@ namespace enumivo { namespace chain {
             bool                     force_all_checks       =  false;
             bool                     contracts_console      =  false;
 
+            block_log_sync_mode      block_log_sync              = block_log_sync_mode::flush;
+            uint32_t                 block_log_batch_blocks      = chain::config::default_block_log_batch_blocks;
+            uint32_t                 block_log_batch_interval_ms = chain::config::default_block_log_batch_interval_ms;
+            uint32_t                 blocks_log_stride           = 0;
+            uint32_t                 max_retained_block_files    = std::numeric_limits<uint32_t>::max();
+            path                     blocks_archive_dir          = chain::config::default_blocks_archive_dir_name;
+            uint32_t                 block_log_compression_chunk = 0;
+            uint32_t                 replay_read_ahead_blocks    = chain::config::default_replay_read_ahead_blocks;
+            uint32_t                 replay_read_ahead_threads   = chain::config::default_replay_read_ahead_threads;
+            uint32_t                 signature_recovery_threads  = chain::config::default_signature_recovery_threads;
+            uint64_t                 signature_recovery_cache_size = chain::config::default_signature_recovery_cache_size;
+            uint32_t                 merkle_threads              = chain::config::default_merkle_threads;
+            path                     snapshot; ///< snapshot to initialize an empty state database from, if any
+            path                     replay_profile; ///< file to write a timing profile of a replay to, if any
+            uint32_t                 replay_profile_slowest_blocks = chain::config::default_replay_profile_slowest_blocks;
+
             genesis_state            genesis;
             wasm_interface::vm_type  wasm_runtime = chain::config::default_wasm_runtime;
+            path                     wasm_cache_dir; ///< directory to keep injected contract code in across restarts, if any
+            uint64_t                 wasm_instantiation_cache_size = chain::config::default_wasm_instantiation_cache_size;
+            uint32_t                 wasm_compile_threads        = chain::config::default_wasm_compile_threads;
+            uint32_t                 wasm_precompile_contracts   = chain::config::default_wasm_precompile_contracts;
 
             db_read_mode             read_mode    = db_read_mode::SPECULATIVE;
 
@@ -126,6 +147,13 @@ namespace enumivo { namespace chain {
          void commit_block();
          void pop_block();
 
+         /**
+          * Starts recovering the signing keys of the transactions in the block on the signature recovery threads,
+          * so that they are ready by the time the block is applied. May be called from any thread, as early as
+          * the block is known; push_block does so as well. Does nothing without signature recovery threads.
+          */
+         void prepare_block( const signed_block_ptr& b );
+
          void push_block( const signed_block_ptr& b, block_status s = block_status::complete );
 
          /**
@@ -138,6 +166,14 @@ namespace enumivo { namespace chain {
 
          fork_database& fork_db()const;
 
+         /**
+          * Writes the chain state as of the head block to a snapshot file, from which another node can be started
+          * along with the block log. If the head block is still reversible, the snapshot is kept in file.pending and
+          * only moved to file once the block is irreversible, or removed if the block is forked out. written is
+          * called once file is in place. Must not be called while a block is pending.
+          */
+         void write_snapshot( const path& file, std::function<void()> written = {} );
+
          const account_object&                 get_account( account_name n )const;
          const global_property_object&         get_global_properties()const;
          const dynamic_global_property_object& get_dynamic_global_properties()const;
@@ -197,6 +233,13 @@ namespace enumivo { namespace chain {
 
          int64_t set_proposed_producers( vector<producer_key> producers );
 
+         /**
+          * Activates a feature in the pending block. It is active once that block is irreversible by the block
+          * headers, so that every node switches at the same block.
+          */
+         void activate_feature( name feature );
+         bool is_feature_active( name feature )const;
+
          bool skip_auth_check()const;
 
          bool contracts_console()const;
@@ -271,7 +314,26 @@ FC_REFLECT( enumivo::chain::controller::config,
             (read_only)
             (force_all_checks)
             (contracts_console)
+            (block_log_sync)
+            (block_log_batch_blocks)
+            (block_log_batch_interval_ms)
+            (blocks_log_stride)
+            (max_retained_block_files)
+            (blocks_archive_dir)
+            (block_log_compression_chunk)
+            (replay_read_ahead_blocks)
+            (replay_read_ahead_threads)
+            (signature_recovery_threads)
+            (signature_recovery_cache_size)
+            (merkle_threads)
+            (snapshot)
+            (replay_profile)
+            (replay_profile_slowest_blocks)
             (genesis)
             (wasm_runtime)
+            (wasm_cache_dir)
+            (wasm_instantiation_cache_size)
+            (wasm_compile_threads)
+            (wasm_precompile_contracts)
             (resource_greylist)
           )
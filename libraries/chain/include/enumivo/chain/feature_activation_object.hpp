@@ -0,0 +1,40 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#pragma once
+#include <enumivo/chain/types.hpp>
+
+#include "multi_index_includes.hpp"
+
+namespace enumivo { namespace chain {
+   /**
+    *  @brief records a chain feature activated by a privileged contract
+    *  @ingroup object
+    *
+    *  The feature is active once the block that activated it is irreversible by the block headers, that is once the
+    *  dpos irreversible block number reaches activation_block_num, so that all nodes agree on it.
+    */
+   class feature_activation_object : public chainbase::object<feature_activation_object_type, feature_activation_object>
+   {
+         OBJECT_CTOR(feature_activation_object)
+
+         id_type          id;
+         name             feature;
+         block_num_type   activation_block_num = 0;
+   };
+
+   struct by_feature;
+   using feature_activation_multi_index = chainbase::shared_multi_index_container<
+      feature_activation_object,
+      indexed_by<
+         ordered_unique<tag<by_id>, BOOST_MULTI_INDEX_MEMBER(feature_activation_object, feature_activation_object::id_type, id)>,
+         ordered_unique<tag<by_feature>, BOOST_MULTI_INDEX_MEMBER(feature_activation_object, name, feature)>
+      >
+   >;
+
+} }
+
+CHAINBASE_SET_INDEX_TYPE(enumivo::chain::feature_activation_object, enumivo::chain::feature_activation_multi_index)
+
+FC_REFLECT( enumivo::chain::feature_activation_object, (feature)(activation_block_num) )
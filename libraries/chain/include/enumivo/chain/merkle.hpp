@@ -1,5 +1,6 @@
 #pragma once
 #include <enumivo/chain/types.hpp>
+#include <enumivo/chain/thread_utils.hpp>
 
 namespace enumivo { namespace chain {
 
@@ -19,4 +20,60 @@ namespace enumivo { namespace chain {
     */
    digest_type merkle( vector<digest_type> ids );
 
+   /**
+    *  Accumulates digests appended one at a time into the same root merkle() calculates for all of them.
+    *
+    *  A pair is hashed as soon as both of its digests are known, keeping only the roots of the complete subtrees
+    *  still waiting for their right sibling, one for every bit set in the number of digests. get_root() is then left
+    *  with the duplicated right edge of the tree. Unlike incremental_merkle, the partial nodes of that edge are not
+    *  recalculated on every append.
+    */
+   class merkle_accumulator {
+      public:
+         void        append( const digest_type& digest );
+
+         /**
+          *  Appends the digests in order. Every complete subtree the digests fill is calculated with
+          *  merkle( ids, pool ), so the levels of large ones are hashed in batches on the thread pool.
+          */
+         void        append( const vector<digest_type>& digests, boost::asio::thread_pool* pool );
+
+         digest_type get_root()const;
+         uint64_t    size()const { return _node_count; }
+
+      private:
+         /// appends the root of a complete subtree of 2^level digests, _node_count being a multiple of 2^level
+         void        append_subtree( digest_type root, size_t level );
+
+         uint64_t                _node_count = 0;
+         vector<digest_type>     _subtree_roots; ///< root of the complete subtree of 2^i digests at i, if bit i of _node_count is set
+   };
+
+   /// pairs of digests hashed by one task of the thread pool when calculating a merkle root on it
+   const static size_t merkle_batch_size = 1024;
+
+   /**
+    *  Calculates the same root as merkle( ids ), hashing the levels of the tree with more than merkle_batch_size
+    *  pairs in batches on the thread pool. Calculates it on the calling thread if pool is null.
+    */
+   digest_type merkle( vector<digest_type> ids, boost::asio::thread_pool* pool );
+
+   /**
+    *  Returns the digest() of every item, calculated in batches on the thread pool if there are more than
+    *  batch_size items and pool is not null.
+    */
+   template<typename T>
+   vector<digest_type> calculate_digests( const vector<T>& items, boost::asio::thread_pool* pool, size_t batch_size = 256 ) {
+      vector<digest_type> digests( items.size() );
+      auto calculate = [&]( size_t begin, size_t end ) {
+         for( size_t i = begin; i < end; ++i )
+            digests[i] = items[i].digest();
+      };
+      if( pool && items.size() > batch_size )
+         for_each_batch( *pool, items.size(), batch_size, calculate );
+      else
+         calculate( 0, items.size() );
+      return digests;
+   }
+
 } } /// enumivo::chain
@@ -0,0 +1,100 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#pragma once
+#include <enumivo/chain/trace.hpp>
+#include <fc/filesystem.hpp>
+
+namespace enumivo { namespace chain {
+
+   /**
+    * Collects the time spent applying blocks, transactions and actions while replaying the block log and writes it
+    * out as a report.
+    *
+    * Actions are aggregated by receiver, contract and action name. The time of an action is its own execution
+    * time, not including the inline actions it sends, which are accounted for separately. Transactions are
+    * attributed to the block applied next after them.
+    *
+    * The profile also tells how much of a block could run in parallel: its transactions, other than onblock which
+    * runs first, are split into conflict_groups by the accounts they touched, and the critical path of the block is
+    * the time of onblock plus the time of its slowest group. Grouping them by the accounts they declare instead
+    * yields more groups whenever notifications or inline actions connect transactions the declarations did not.
+    */
+   class replay_profiler {
+      public:
+         struct timing {
+            uint64_t            count = 0;
+            fc::microseconds    total;
+            fc::microseconds    max;
+
+            void add( fc::microseconds elapsed ) {
+               ++count;
+               total += elapsed;
+               if( elapsed > max )
+                  max = elapsed;
+            }
+         };
+
+         struct block_timing {
+            uint32_t            block_num = 0;
+            fc::microseconds    elapsed;
+            uint32_t            transactions = 0;
+            uint32_t            actions = 0;
+            uint32_t            groups = 0;          ///< independent groups of transactions by the accounts they touched
+            uint32_t            declared_groups = 0; ///< independent groups by the accounts they declared
+            fc::microseconds    critical_path;       ///< time of onblock plus the total time of the slowest group
+         };
+
+         struct action_timing {
+            account_name        receiver;
+            account_name        account;
+            action_name         name;
+            timing              time;
+         };
+
+         explicit replay_profiler( uint32_t slowest_blocks );
+
+         void add_transaction( const transaction_trace& trace );
+         void add_block( uint32_t block_num, fc::microseconds elapsed );
+
+         const vector<block_timing>& blocks()const { return block_times; }
+         const timing& transactions()const { return transaction_times; }
+
+         /// actions ordered by decreasing total time
+         vector<action_timing> actions()const;
+         /// the slowest blocks, slowest first
+         vector<block_timing> slowest_blocks()const;
+
+         /**
+          * Writes the report as CSV if the file name ends in .csv and as JSON otherwise. The CSV file has one record
+          * per line, the first column telling whether it is a block, one of the slowest blocks, the transaction
+          * totals or the totals of an action.
+          */
+         void write( const fc::path& file )const;
+
+      private:
+         void add_action( const action_trace& trace );
+
+         struct pending_transaction {
+            flat_set<account_name>  declared;
+            flat_set<account_name>  touched;
+            fc::microseconds        elapsed;
+         };
+
+         uint32_t                      max_slowest_blocks;
+         vector<block_timing>          block_times;
+         timing                        transaction_times;
+         map<std::tuple<account_name, account_name, action_name>, timing> action_times;
+         uint32_t                      pending_transactions = 0;
+         uint32_t                      pending_actions = 0;
+         vector<pending_transaction>   pending_grouped;
+         fc::microseconds              pending_serial; ///< time of the transactions run before the others, onblock
+   };
+
+} }
+
+FC_REFLECT( enumivo::chain::replay_profiler::timing, (count)(total)(max) )
+FC_REFLECT( enumivo::chain::replay_profiler::block_timing, (block_num)(elapsed)(transactions)(actions)
+                                                           (groups)(declared_groups)(critical_path) )
+FC_REFLECT( enumivo::chain::replay_profiler::action_timing, (receiver)(account)(name)(time) )
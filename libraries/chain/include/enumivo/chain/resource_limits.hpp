@@ -16,6 +16,9 @@ namespace enumivo { namespace chain { namespace resource_limits {
 
    using ratio = impl::ratio<uint64_t>;
 
+   class resource_limits_config_object;
+   class resource_limits_state_object;
+
    struct elastic_limit_parameters {
       uint64_t target;           // the desired usage
       uint64_t max;              // the maximum usage
@@ -74,9 +77,22 @@ namespace enumivo { namespace chain { namespace resource_limits {
 
          int64_t get_account_ram_usage( const account_name& name ) const;
 
+         /**
+          * Forgets the config and state objects looked up since the last call. The controller calls it at the start of
+          * every block; the objects are only created with the database, so they stay where they are until then.
+          */
+         void reset_cached_objects();
+
       private:
+         const resource_limits_config_object& get_config()const;
+         const resource_limits_state_object&  get_state()const;
+
          chainbase::database& _db;
+         mutable const resource_limits_config_object* _config = nullptr;
+         mutable const resource_limits_state_object*  _state  = nullptr;
    };
 } } } /// enumivo::chain
 
 FC_REFLECT( enumivo::chain::resource_limits::account_resource_limit, (used)(available)(max) )
+FC_REFLECT( enumivo::chain::resource_limits::ratio, (numerator)(denominator) )
+FC_REFLECT( enumivo::chain::resource_limits::elastic_limit_parameters, (target)(max)(periods)(max_multiplier)(contract_rate)(expand_rate) )
@@ -264,3 +264,5 @@ CHAINBASE_SET_INDEX_TYPE(enumivo::chain::resource_limits::resource_limits_object
 CHAINBASE_SET_INDEX_TYPE(enumivo::chain::resource_limits::resource_usage_object,         enumivo::chain::resource_limits::resource_usage_index)
 CHAINBASE_SET_INDEX_TYPE(enumivo::chain::resource_limits::resource_limits_config_object, enumivo::chain::resource_limits::resource_limits_config_index)
 CHAINBASE_SET_INDEX_TYPE(enumivo::chain::resource_limits::resource_limits_state_object,  enumivo::chain::resource_limits::resource_limits_state_index)
+
+FC_REFLECT( enumivo::chain::resource_limits::usage_accumulator, (last_ordinal)(value_ex)(consumed) )
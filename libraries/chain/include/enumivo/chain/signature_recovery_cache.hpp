@@ -0,0 +1,66 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#pragma once
+#include <enumivo/chain/types.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace enumivo { namespace chain {
+
+   /**
+    * Remembers the public keys recovered from signatures of transaction digests so the keys of a transaction are
+    * recovered once, when it is received, rather than again when it is included in a block.
+    *
+    * Entries are keyed by signature and signed digest and spread over shards, each with its own lock and least
+    * recently used eviction, so keys can be recovered on any number of threads at once. The process shares a single
+    * cache, sized by the controller from its configuration.
+    */
+   class signature_recovery_cache {
+      public:
+         struct metrics {
+            uint64_t hits      = 0;
+            uint64_t misses    = 0;
+            uint64_t evictions = 0;
+            uint64_t size      = 0;
+            uint64_t capacity  = 0;
+         };
+
+         explicit signature_recovery_cache( uint64_t capacity, uint32_t shards = default_shards );
+         ~signature_recovery_cache();
+
+         static signature_recovery_cache& instance();
+
+         /// returns the key that signed digest, recovering it and adding it to the cache if it is not cached
+         public_key_type recover( const signature_type& sig, const digest_type& digest );
+
+         optional<public_key_type> find( const signature_type& sig, const digest_type& digest );
+         void insert( const signature_type& sig, const digest_type& digest, const public_key_type& key );
+
+         /// changes the maximum number of entries, evicting the least recently used ones beyond it
+         void set_capacity( uint64_t capacity );
+         void clear();
+
+         metrics get_metrics()const;
+
+         static constexpr uint32_t default_shards = 16;
+
+      private:
+         struct shard;
+
+         shard& shard_for( const signature_type& sig, const digest_type& digest, size_t& hash )const;
+         void   evict( shard& s, uint64_t shard_capacity );
+
+         vector<std::unique_ptr<shard>>   shards;
+         std::atomic<uint64_t>            shard_capacity;
+         std::atomic<uint64_t>            hits{0};
+         std::atomic<uint64_t>            misses{0};
+         std::atomic<uint64_t>            evictions{0};
+   };
+
+} } // enumivo::chain
+
+FC_REFLECT( enumivo::chain::signature_recovery_cache::metrics, (hits)(misses)(evictions)(size)(capacity) )
@@ -0,0 +1,59 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#pragma once
+#include <enumivo/chain/block_state.hpp>
+#include <enumivo/chain/genesis_state.hpp>
+#include <chainbase/chainbase.hpp>
+#include <fc/filesystem.hpp>
+
+namespace enumivo { namespace chain {
+
+   struct snapshot_header {
+      genesis_state        genesis;
+      block_header_state   head;        ///< state of the block the snapshot was taken at
+      signed_block         head_block;
+   };
+
+   /* A snapshot is a portable copy of the chain state database taken at a block, which a node can start from
+    * instead of replaying the block log from genesis.
+    *
+    * +-------+---------+---------+-------------------+------------+-----------+-----+-----------+
+    * | Magic | Version | Genesis | Head block header | Head block | Section 1 | ... | Section N |
+    * |       |         |  state  |       state       |            |           |     |           |
+    * +-------+---------+---------+-------------------+------------+-----------+-----+-----------+
+    *
+    * Every index of the state database is written as a section holding the name of the index, its number of
+    * rows and the rows in the order of their ids. Rows are packed with fc::raw from plain structures that list
+    * every field of the object, so the file does not depend on the memory layout of the database.
+    *
+    * The ids of the rows are not kept. Reading a snapshot inserts the rows of every index in their original
+    * order into an empty database, which gives them new ids in the same order, and the fields that refer to
+    * the ids of other rows (the parent and usage of permissions and the table of contract rows) are remapped
+    * to the new ids.
+    */
+   class snapshot {
+      public:
+         static const uint32_t magic;
+         static const uint32_t supported_version;
+
+         /**
+          * Writes the contents of db along with the header state and block of head. The file is written under a
+          * temporary name and renamed once complete.
+          */
+         static void write( const fc::path& file, const chainbase::database& db,
+                            const genesis_state& gs, const block_state& head );
+
+         static snapshot_header read_header( const fc::path& file );
+
+         /**
+          * Restores the contents of a snapshot into db, which must have all indices added and be empty, and returns
+          * its header.
+          */
+         static snapshot_header read( const fc::path& file, chainbase::database& db );
+   };
+
+} }
+
+FC_REFLECT( enumivo::chain::snapshot_header, (genesis)(head)(head_block) )
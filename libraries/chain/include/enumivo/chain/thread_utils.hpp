@@ -0,0 +1,46 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#pragma once
+
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace enumivo { namespace chain {
+
+   /**
+    * Posts f to the thread pool and returns a future for its result. An exception thrown by f is stored in the
+    * future; tasks still queued when the pool is stopped are dropped, leaving their futures without a value.
+    */
+   template<typename F>
+   auto async_thread_pool( boost::asio::thread_pool& pool, F&& f ) {
+      auto task = std::make_shared<std::packaged_task<decltype( f() )()>>( std::forward<F>( f ) );
+      boost::asio::post( pool, [task]() { (*task)(); } );
+      return task->get_future();
+   }
+
+   /**
+    * Calls f( begin, end ) on the thread pool for consecutive ranges of at most batch_size indices covering
+    * [0, size) and waits for all of them, rethrowing the first exception thrown by f.
+    */
+   template<typename F>
+   void for_each_batch( boost::asio::thread_pool& pool, size_t size, size_t batch_size, const F& f ) {
+      std::vector<std::future<void>> batches;
+      batches.reserve( (size + batch_size - 1) / batch_size );
+      for( size_t begin = 0; begin < size; begin += batch_size ) {
+         auto end = std::min( size, begin + batch_size );
+         batches.emplace_back( async_thread_pool( pool, [&f, begin, end]() { f( begin, end ); } ) );
+      }
+      // f is referenced by the batches still running, so all of them must finish before an exception is rethrown
+      for( auto& b : batches )
+         b.wait();
+      for( auto& b : batches )
+         b.get();
+   }
+
+} } // enumivo::chain
@@ -0,0 +1,33 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#pragma once
+#include <enumivo/chain/trace.hpp>
+
+namespace enumivo { namespace chain {
+
+   /**
+    * Returns the accounts the transaction declares it touches, read from the top level actions of its trace: the
+    * contracts of its actions and the actors authorizing them. The contracts its actions notify or send inline
+    * actions to are left out.
+    */
+   flat_set<account_name> declared_accounts( const transaction_trace& trace );
+
+   /**
+    * Returns the accounts the transaction touched when it ran: the receivers of all of its actions, including the
+    * notified and inline ones, and the actors authorizing them.
+    */
+   flat_set<account_name> touched_accounts( const transaction_trace& trace );
+
+   /**
+    * Assigns the transactions, given by the accounts each of them touches, to groups such that transactions
+    * touching a common account, directly or through other transactions, share a group. Transactions of different
+    * groups are independent of each other and could be applied in any order relative to each other.
+    *
+    * Returns the group of every transaction. Groups are numbered from 0 in the order of their first transaction,
+    * so the result only depends on the order of the transactions.
+    */
+   vector<uint32_t> conflict_groups( const vector<flat_set<account_name>>& accounts );
+
+} } /// enumivo::chain
@@ -1,9 +1,26 @@
 #pragma once
 #include <enumivo/chain/controller.hpp>
 #include <enumivo/chain/trace.hpp>
+#include <boost/functional/hash.hpp>
+#include <unordered_map>
 
 namespace enumivo { namespace chain {
 
+   class table_id_object;
+
+   /// (code, scope, table) of a contract table
+   using table_key = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+   struct table_key_hash {
+      size_t operator()( const table_key& k )const {
+         size_t seed = 0;
+         boost::hash_combine( seed, std::get<0>( k ) );
+         boost::hash_combine( seed, std::get<1>( k ) );
+         boost::hash_combine( seed, std::get<2>( k ) );
+         return seed;
+      }
+   };
+
    class transaction_context {
       private:
          void init( uint64_t initial_net_usage);
@@ -53,6 +70,7 @@ namespace enumivo { namespace chain {
             dispatch_action(trace, a, a.account, context_free);
          };
          void schedule_transaction();
+         void apply_pending_ram_usage();
          void record_transaction( const transaction_id_type& id, fc::time_point_sec expire );
 
          void validate_cpu_usage_to_bill( int64_t u, bool check_minimum = true )const;
@@ -73,6 +91,13 @@ namespace enumivo { namespace chain {
          vector<action_receipt>        executed;
          flat_set<account_name>        bill_to_accounts;
          flat_set<account_name>        validate_ram_usage;
+         /// RAM usage deltas by payer, applied to their resource usage in one pass by finalize
+         flat_map<account_name, int64_t> pending_ram_usage;
+         /**
+          * Tables looked up by the actions of the transaction, null for those found not to exist. Kept in step by
+          * apply_context as it creates and removes tables; a table only goes away otherwise when the transaction fails.
+          */
+         std::unordered_map<table_key, const table_id_object*, table_key_hash> table_cache;
 
          /// the maximum number of virtual CPU instructions of the transaction that can be safely billed to the billable accounts
          uint64_t                      initial_max_billable_cpu = 0;
@@ -152,6 +152,7 @@ namespace enumivo { namespace chain {
       reversible_block_object_type,
       ram_action_object_type,
       account_ram_object_type,
+      feature_activation_object_type,
       OBJECT_TYPE_COUNT ///< Sentry value which contains the number of different object types
    };
 
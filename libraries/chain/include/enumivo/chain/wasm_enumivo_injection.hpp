@@ -777,6 +777,9 @@ namespace enumivo { namespace chain { namespace wasm_injections {
    };
  
    // inherit from this class and define your own injectors 
+   /// bump whenever inject() changes the code it produces, so modules injected by older versions are not reused
+   constexpr uint32_t injection_version = 1;
+
    class wasm_binary_injection {
       using standard_module_injectors = module_injectors< max_memory_injection_visitor >;
 
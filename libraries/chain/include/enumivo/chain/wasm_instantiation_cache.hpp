@@ -0,0 +1,62 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#pragma once
+#include <enumivo/chain/types.hpp>
+#include <enumivo/chain/webassembly/runtime_interface.hpp>
+
+#include <functional>
+
+namespace enumivo { namespace chain {
+
+   /**
+    * Holds the instantiated module of each contract, by code_id, up to a total memory_usage() of its capacity.
+    *
+    * The least recently used modules are destroyed to make room for new ones, although the module inserted last is
+    * always kept even when it alone exceeds the capacity. Destroyed modules are reported to the released callback
+    * once per insert, so runtimes that collect them in bulk can do so.
+    */
+   class wasm_instantiation_cache {
+      public:
+         struct metrics {
+            uint64_t hits      = 0;
+            uint64_t misses    = 0;
+            uint64_t evictions = 0;
+            uint64_t size      = 0; ///< modules held
+            uint64_t memory    = 0; ///< bytes held by the modules
+            uint64_t capacity  = 0;
+         };
+
+         explicit wasm_instantiation_cache( uint64_t capacity, std::function<void()> released = std::function<void()>() );
+         ~wasm_instantiation_cache();
+
+         /// returns the module of code_id, or null if it is not cached
+         wasm_instantiated_module_interface* find( const digest_type& code_id );
+         /// unlike find, does not count as a use of the module
+         bool contains( const digest_type& code_id )const;
+         wasm_instantiated_module_interface& insert( const digest_type& code_id, std::unique_ptr<wasm_instantiated_module_interface> module );
+
+         void set_capacity( uint64_t capacity );
+         void clear();
+
+         metrics get_metrics()const;
+
+      private:
+         struct entries;
+
+         /// evicts the least recently used modules, all but the last keep of them, until they fit in capacity
+         bool evict( uint64_t capacity, size_t keep );
+
+         std::unique_ptr<entries>   _entries;
+         std::function<void()>      _released;
+         uint64_t                   _capacity  = 0;
+         uint64_t                   _memory    = 0;
+         uint64_t                   _hits      = 0;
+         uint64_t                   _misses    = 0;
+         uint64_t                   _evictions = 0;
+   };
+
+} } // enumivo::chain
+
+FC_REFLECT( enumivo::chain::wasm_instantiation_cache::metrics, (hits)(misses)(evictions)(size)(memory)(capacity) )
@@ -1,6 +1,8 @@
 #pragma once
 #include <enumivo/chain/types.hpp>
 #include <enumivo/chain/exceptions.hpp>
+#include <enumivo/chain/wasm_instantiation_cache.hpp>
+#include <fc/filesystem.hpp>
 #include "Runtime/Linker.h"
 #include "Runtime/Runtime.h"
 
@@ -54,9 +56,13 @@ namespace enumivo { namespace chain {
          enum class vm_type {
             wavm,
             binaryen,
+            predecoded,
          };
 
-         wasm_interface(vm_type vm);
+         /// module_cache_dir is the directory injected contract code is kept in across restarts, if not empty;
+         /// instantiation_cache_size is the number of bytes of instantiated contracts kept in memory;
+         /// compile_threads is the number of threads precompile() uses, at most one, none disables it
+         wasm_interface(vm_type vm, const fc::path& module_cache_dir, uint64_t instantiation_cache_size, uint32_t compile_threads);
          ~wasm_interface();
 
          //validates code -- does a WASM validation pass and checks the wasm against Enumivo specific constraints
@@ -65,6 +71,14 @@ namespace enumivo { namespace chain {
          //Calls apply or error on a given code
          void apply(const digest_type& code_id, const shared_string& code, apply_context& context);
 
+         //Starts instantiating code in the background so it is ready by the time it is applied
+         void precompile(const digest_type& code_id, const shared_string& code);
+
+         //Waits for the code being instantiated in the background and moves it to the instantiation cache
+         void wait_for_compiles();
+
+         wasm_instantiation_cache::metrics get_instantiation_cache_metrics()const;
+
       private:
          unique_ptr<struct wasm_interface_impl> my;
          friend class enumivo::chain::webassembly::common::intrinsics_accessor;
@@ -76,4 +90,4 @@ namespace enumivo{ namespace chain {
    std::istream& operator>>(std::istream& in, wasm_interface::vm_type& runtime);
 }}
 
-FC_REFLECT_ENUM( enumivo::chain::wasm_interface::vm_type, (wavm)(binaryen) )
+FC_REFLECT_ENUM( enumivo::chain::wasm_interface::vm_type, (wavm)(binaryen)(predecoded) )
@@ -3,12 +3,20 @@
 #include <enumivo/chain/wasm_interface.hpp>
 #include <enumivo/chain/webassembly/wavm.hpp>
 #include <enumivo/chain/webassembly/binaryen.hpp>
+#include <enumivo/chain/webassembly/predecoded.hpp>
 #include <enumivo/chain/webassembly/runtime_interface.hpp>
 #include <enumivo/chain/wasm_enumivo_injection.hpp>
+#include <enumivo/chain/wasm_module_cache.hpp>
+#include <enumivo/chain/wasm_instantiation_cache.hpp>
+#include <enumivo/chain/thread_utils.hpp>
 #include <enumivo/chain/transaction_context.hpp>
 #include <enumivo/chain/exceptions.hpp>
 #include <fc/scoped_exit.hpp>
 
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
 #include "IR/Module.h"
 #include "Runtime/Intrinsics.h"
 #include "Platform/Platform.h"
@@ -23,13 +31,47 @@ using namespace Runtime;
 namespace enumivo { namespace chain {
 
    struct wasm_interface_impl {
-      wasm_interface_impl(wasm_interface::vm_type vm) {
+      wasm_interface_impl(wasm_interface::vm_type vm, const fc::path& module_cache_dir, uint64_t instantiation_cache_size,
+                          uint32_t compile_threads)
+      :instantiation_cache(instantiation_cache_size, [this]() { runtime_interface->free_unreferenced_modules(); })
+      {
          if(vm == wasm_interface::vm_type::wavm)
             runtime_interface = std::make_unique<webassembly::wavm::wavm_runtime>();
          else if(vm == wasm_interface::vm_type::binaryen)
             runtime_interface = std::make_unique<webassembly::binaryen::binaryen_runtime>();
+         else if(vm == wasm_interface::vm_type::predecoded)
+            runtime_interface = std::make_unique<webassembly::predecoded::predecoded_runtime>();
          else
             ENU_THROW(wasm_exception, "wasm_interface_impl fall through");
+
+         if(!module_cache_dir.empty())
+            module_cache = std::make_unique<wasm_module_cache>(module_cache_dir);
+
+         //only compiling modules is worth doing ahead of time; the interpreter's modules are cheap to instantiate.
+         //LLVMJIT compiles in a single process wide LLVM context, one module at a time, so one thread is all it takes
+         ENU_ASSERT(compile_threads <= 1, wasm_exception, "contracts are compiled in the background on a single thread");
+         if(vm == wasm_interface::vm_type::wavm && compile_threads > 0) {
+            compile_pool = std::make_unique<boost::asio::thread_pool>(compile_threads);
+            this->compile_threads = compile_threads;
+         }
+      }
+
+      ~wasm_interface_impl() {
+         if(compile_pool) {
+            compile_pool->stop();
+            compile_pool->join();
+         }
+         compiling.clear();
+         queued.clear();
+         //frees the modules while the runtime is still around to collect them
+         instantiation_cache.clear();
+      }
+
+      //the injection and validation visitors keep process wide state, so code is injected or validated one at a time;
+      //deserializing and linking only share IR's function types, which IR guards itself
+      static std::mutex& injection_mutex() {
+         static std::mutex m;
+         return m;
       }
 
       std::vector<uint8_t> parse_initial_memory(const Module& module) {
@@ -50,52 +92,158 @@ namespace enumivo { namespace chain {
          return mem_image;
       }
 
-      std::unique_ptr<wasm_instantiated_module_interface>& get_instantiated_module( const digest_type& code_id,
-                                                                                    const shared_string& code,
-                                                                                    transaction_context& trx_context )
-      {
-         auto it = instantiation_cache.find(code_id);
-         if(it == instantiation_cache.end()) {
-            auto timer_pause = fc::make_scoped_exit([&](){
-               trx_context.resume_billing_timer();
-            });
-            trx_context.pause_billing_timer();
-            IR::Module module;
-            try {
-               Serialization::MemoryInputStream stream((const U8*)code.data(), code.size());
-               WASM::serialize(stream, module);
-               module.userSections.clear();
-            } catch(const Serialization::FatalSerializationException& e) {
-               ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
-            } catch(const IR::ValidationException& e) {
-               ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
-            }
+      injected_wasm_module inject_module( const digest_type& code_id, const char* code, size_t code_size ) {
+         IR::Module module;
+         try {
+            Serialization::MemoryInputStream stream((const U8*)code, code_size);
+            WASM::serialize(stream, module);
+            module.userSections.clear();
+         } catch(const Serialization::FatalSerializationException& e) {
+            ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
+         } catch(const IR::ValidationException& e) {
+            ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
+         }
 
+         {
+            std::lock_guard<std::mutex> lock(injection_mutex());
             wasm_injections::wasm_binary_injection injector(module);
             injector.inject();
+         }
+
+         injected_wasm_module result;
+         result.code_id = code_id;
+         try {
+            Serialization::ArrayOutputStream outstream;
+            WASM::serialize(outstream, module);
+            result.code = outstream.getBytes();
+         } catch(const Serialization::FatalSerializationException& e) {
+            ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
+         } catch(const IR::ValidationException& e) {
+            ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
+         }
+         result.initial_memory = parse_initial_memory(module);
+         return result;
+      }
+
+      /// injects code, or loads it from the module cache if it was injected before
+      injected_wasm_module load_module( const digest_type& code_id, const char* code, size_t code_size ) {
+         if(module_cache) {
+            if(auto cached = module_cache->load(code_id))
+               return std::move(*cached);
+         }
+
+         auto module = inject_module(code_id, code, code_size);
+
+         if(module_cache) {
+            try {
+               module_cache->store(module);
+            } catch(const fc::exception& e) {
+               wlog("unable to cache injected module ${id}: ${e}", ("id", code_id)("e", e.to_string()));
+            } catch(const std::exception& e) {
+               wlog("unable to cache injected module ${id}: ${e}", ("id", code_id)("e", e.what()));
+            }
+         }
+         return module;
+      }
+
+      //may run on the compile thread while the main thread instantiates another module; LLVMJIT serializes the compiles
+      std::unique_ptr<wasm_instantiated_module_interface> instantiate_module( const digest_type& code_id, const char* code, size_t code_size ) {
+         auto module = load_module(code_id, code, code_size);
+         return runtime_interface->instantiate_module((const char*)module.code.data(), module.code.size(), std::move(module.initial_memory));
+      }
+
+      void precompile( const digest_type& code_id, const shared_string& code ) {
+         if(!compile_pool || compiling.count(code_id) || is_queued(code_id) || instantiation_cache.contains(code_id))
+            return;
+         queued.emplace_back(code_id, bytes(code.begin(), code.end()));
+         publish_compiled();
+      }
+
+      bool is_queued( const digest_type& code_id )const {
+         return std::find_if(queued.begin(), queued.end(), [&](const auto& q) { return q.first == code_id; }) != queued.end();
+      }
+
+      /**
+       * Moves the modules compiled in the background so far to the instantiation cache, where their memory is accounted
+       * for, and starts compiling the next queued ones. A module is only compiled once the one before it on the same
+       * thread was moved to the cache, so at most one module per compile thread is held outside of it.
+       */
+      void publish_compiled() {
+         for(auto itr = compiling.begin(); itr != compiling.end();) {
+            if(itr->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+               ++itr;
+               continue;
+            }
+            try {
+               instantiation_cache.insert(itr->first, itr->second.get());
+            } catch(...) {
+               //instantiated again when it is used, which reports the error in the context of the action
+            }
+            itr = compiling.erase(itr);
+         }
+
+         while(compiling.size() < compile_threads && !queued.empty()) {
+            auto code_id = queued.front().first;
+            compiling.emplace(code_id, async_thread_pool(*compile_pool, [this, code_id, code = std::move(queued.front().second)]() {
+               return instantiate_module(code_id, code.data(), code.size());
+            }));
+            queued.pop_front();
+         }
+      }
+
+      void wait_for_compiles() {
+         while(!compiling.empty()) {
+            for(auto& c : compiling)
+               c.second.wait();
+            publish_compiled();
+         }
+      }
+
+      wasm_instantiated_module_interface& get_instantiated_module( const digest_type& code_id,
+                                                                  const shared_string& code,
+                                                                  transaction_context& trx_context )
+      {
+         publish_compiled();
+         if(auto cached = instantiation_cache.find(code_id))
+            return *cached;
+
+         auto timer_pause = fc::make_scoped_exit([&](){
+            trx_context.resume_billing_timer();
+         });
+         trx_context.pause_billing_timer();
 
-            std::vector<U8> bytes;
+         std::unique_ptr<wasm_instantiated_module_interface> module;
+         auto itr = compiling.find(code_id);
+         if(itr != compiling.end()) {
+            auto compiled = std::move(itr->second);
+            compiling.erase(itr);
             try {
-               Serialization::ArrayOutputStream outstream;
-               WASM::serialize(outstream, module);
-               bytes = outstream.getBytes();
-            } catch(const Serialization::FatalSerializationException& e) {
-               ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
-            } catch(const IR::ValidationException& e) {
-               ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
+               module = compiled.get();
+            } catch(...) {
+               //instantiated again below, which reports the error in the context of the action
             }
-            it = instantiation_cache.emplace(code_id, runtime_interface->instantiate_module((const char*)bytes.data(), bytes.size(), parse_initial_memory(module))).first;
+            publish_compiled();
+         } else {
+            queued.erase(std::remove_if(queued.begin(), queued.end(), [&](const auto& q) { return q.first == code_id; }), queued.end());
          }
-         return it->second;
+         if(!module)
+            module = instantiate_module(code_id, code.data(), code.size());
+         return instantiation_cache.insert(code_id, std::move(module));
       }
 
       std::unique_ptr<wasm_runtime_interface> runtime_interface;
-      map<digest_type, std::unique_ptr<wasm_instantiated_module_interface>> instantiation_cache;
+      std::unique_ptr<wasm_module_cache> module_cache;
+      wasm_instantiation_cache instantiation_cache;
+      std::unique_ptr<boost::asio::thread_pool> compile_pool;
+      uint32_t compile_threads = 0;
+      map<digest_type, std::future<std::unique_ptr<wasm_instantiated_module_interface>>> compiling; ///< by the compile_pool
+      std::deque<std::pair<digest_type, bytes>> queued; ///< waiting for a compile thread, in the order they were precompiled
    };
 
 #define _REGISTER_INTRINSIC_EXPLICIT(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)\
    _REGISTER_WAVM_INTRINSIC(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)\
-   _REGISTER_BINARYEN_INTRINSIC(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)
+   _REGISTER_BINARYEN_INTRINSIC(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)\
+   _REGISTER_PREDECODED_INTRINSIC(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)
 
 #define _REGISTER_INTRINSIC4(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)\
    _REGISTER_INTRINSIC_EXPLICIT(CLS, MOD, METHOD, WASM_SIG, NAME, SIG )
@@ -0,0 +1,51 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#pragma once
+#include <enumivo/chain/types.hpp>
+#include <fc/filesystem.hpp>
+
+namespace enumivo { namespace chain {
+
+   /**
+    * Contract code after injection, together with the initial memory image parsed from its data segments, as it is
+    * handed to the wasm runtime to instantiate.
+    */
+   struct injected_wasm_module {
+      digest_type       code_id;
+      digest_type       injection_hash;
+      vector<uint8_t>   code;
+      vector<uint8_t>   initial_memory;
+      digest_type       checksum;
+
+      digest_type calculate_checksum()const;
+   };
+
+   /**
+    * Keeps the injected code of each contract in a directory, one file per code_id, so it does not have to be
+    * injected again after a restart.
+    *
+    * Modules injected by a different version of the injection, and files that are truncated or corrupt, are treated
+    * as missing and removed when they are loaded.
+    */
+   class wasm_module_cache {
+      public:
+         explicit wasm_module_cache( const fc::path& dir );
+
+         optional<injected_wasm_module> load( const digest_type& code_id )const;
+         /// writes module to its file, replacing it atomically if it exists
+         void store( injected_wasm_module module )const;
+
+         /// identifies the injection and the constraints it enforces
+         static const digest_type& injection_hash();
+
+      private:
+         fc::path module_file( const digest_type& code_id )const;
+
+         fc::path dir;
+   };
+
+} } // enumivo::chain
+
+FC_REFLECT( enumivo::chain::injected_wasm_module, (code_id)(injection_hash)(code)(initial_memory)(checksum) )
@@ -38,8 +38,8 @@ using import_lut_type = unordered_map<uintptr_t, intrinsic_registrator::intrinsi
 
 
 struct interpreter_interface : ModuleInstance::ExternalInterface {
-   interpreter_interface(linear_memory_type& memory, call_indirect_table_type& table, import_lut_type& import_lut, const unsigned& initial_memory_size, apply_context& context)
-   :memory(memory),table(table),import_lut(import_lut), current_memory_size(initial_memory_size), context(context)
+   interpreter_interface(linear_memory_type& memory, uint32_t& dirty_memory_size, call_indirect_table_type& table, import_lut_type& import_lut)
+   :memory(memory),dirty_memory_size(dirty_memory_size),table(table),import_lut(import_lut)
    {}
 
    void importGlobals(std::map<Name, Literal>& globals, Module& wasm) override
@@ -81,8 +81,11 @@ struct interpreter_interface : ModuleInstance::ExternalInterface {
          wasm_execution_error, "access violation");
    }
 
+   //intrinsics may write through the pointer, so its range counts as written
    char* get_validated_pointer(uint32_t offset, uint32_t size) {
       assert_memory_is_accessible(offset, size);
+      if(offset + size > dirty_memory_size)
+         dirty_memory_size = offset + size;
       return memory.data + offset;
    }
 
@@ -93,7 +96,8 @@ struct interpreter_interface : ModuleInstance::ExternalInterface {
 
    template<typename T>
    T load_memory(uint32_t offset) {
-      char *base = get_validated_pointer(offset, sizeof(T));
+      assert_memory_is_accessible(offset, sizeof(T));
+      char *base = memory.data + offset;
       if (aligned_for<T>(base)) {
          return *reinterpret_cast<T*>(base);
       } else {
@@ -113,8 +117,8 @@ struct interpreter_interface : ModuleInstance::ExternalInterface {
       }
    }
 
+   //the memory past the dirty size is already zero, and nothing past the current size can have been written
    void growMemory(Address old_size, Address new_size) override {
-      memset(memory.data + old_size.addr, 0, new_size.addr - old_size.addr);
       current_memory_size += new_size.addr - old_size.addr;
    }
 
@@ -133,10 +137,11 @@ struct interpreter_interface : ModuleInstance::ExternalInterface {
    void store64(Address addr, int64_t value) override { store_memory(addr, value); }
 
    linear_memory_type&          memory;
+   uint32_t&                    dirty_memory_size; ///< bytes at the start of memory that may not be zero
    call_indirect_table_type&    table;
    import_lut_type&             import_lut;
-   unsigned                     current_memory_size;
-   apply_context&               context;
+   unsigned                     current_memory_size = 0;
+   apply_context*               context = nullptr; ///< of the action being applied
 };
 
 class binaryen_runtime : public enumivo::chain::wasm_runtime_interface {
@@ -146,6 +151,8 @@ class binaryen_runtime : public enumivo::chain::wasm_runtime_interface {
 
    private:
       linear_memory_type                  _memory __attribute__ ((aligned (4096)));
+      //bytes at the start of _memory that may not be zero; all of it until the first module's reset clears it
+      uint32_t                            _dirty_memory_size = wasm_constraints::maximum_linear_memory;
 };
 
 /**
@@ -153,13 +160,27 @@ class binaryen_runtime : public enumivo::chain::wasm_runtime_interface {
  * it is a hint to the transcriber that the next parameter will
  * be a size (data bytes length) and that the pair are validated together
  * This triggers the template specialization of intrinsic_invoker_impl
+ * the range is validated with a single comparison, which cannot overflow in 64 bits
  * @tparam T
  */
 template<typename T>
-inline array_ptr<T> array_ptr_impl (interpreter_interface* interface, uint32_t ptr, uint32_t length)
+inline T* array_ptr_impl (interpreter_interface* interface, uint32_t ptr, uint32_t length)
+{
+   ENU_ASSERT( uint64_t(ptr) + uint64_t(length) * sizeof(T) <= interface->current_memory_size, wasm_execution_error, "access violation" );
+   return (T*)(interface->memory.data + ptr);
+}
+
+/**
+ * intrinsics may write through the pointer, so its range counts as written
+ */
+template<typename T>
+inline T* writable_array_ptr_impl (interpreter_interface* interface, uint32_t ptr, uint32_t length)
 {
-   ENU_ASSERT( length < INT_MAX/(uint32_t)sizeof(T), binaryen_exception, "length will overflow" );
-   return array_ptr<T>((T*)(interface->get_validated_pointer(ptr, length * (uint32_t)sizeof(T))));
+   T* base = array_ptr_impl<T>(interface, ptr, length);
+   const uint64_t end = uint64_t(ptr) + uint64_t(length) * sizeof(T);
+   if(end > interface->dirty_memory_size)
+      interface->dirty_memory_size = end;
+   return base;
 }
 
 /**
@@ -167,14 +188,9 @@ inline array_ptr<T> array_ptr_impl (interpreter_interface* interface, uint32_t p
  */
 inline null_terminated_ptr null_terminated_ptr_impl(interpreter_interface* interface, uint32_t ptr)
 {
-   char *value = interface->get_validated_pointer(ptr, 1);
-   const char* p = value;
-   const char* const top_of_memory = interface->memory.data + interface->current_memory_size;
-   while(p < top_of_memory)
-      if(*p++ == '\0')
-         return null_terminated_ptr(value);
-
-   FC_THROW_EXCEPTION(wasm_execution_error, "unterminated string");
+   char *value = array_ptr_impl<char>(interface, ptr, 1);
+   ENU_ASSERT( memchr(value, 0, interface->current_memory_size - ptr), wasm_execution_error, "unterminated string" );
+   return null_terminated_ptr(value);
 }
 
 
@@ -265,26 +281,28 @@ struct void_type {
 
 /**
  * Forward declaration of the invoker type which transcribes arguments to/from a native method
- * and injects the appropriate checks
+ * and injects the appropriate checks; which argument each parameter is read from is known at compile time
  *
  * @tparam Ret - the return type of the native function
  * @tparam NativeParameters - a std::tuple of the remaining native parameters to transcribe
- * @tparam WasmParameters - a std::tuple of the transribed parameters
+ * @tparam Index - the index in the argument list of the first of the remaining parameters
  */
-template<typename Ret, typename NativeParameters>
+template<typename Ret, typename NativeParameters, uint32_t Index>
 struct intrinsic_invoker_impl;
 
 /**
  * Specialization for the fully transcribed signature
  * @tparam Ret - the return type of the native function
+ * @tparam Arity - the number of wasm arguments
  */
-template<typename Ret>
-struct intrinsic_invoker_impl<Ret, std::tuple<>> {
-   using next_method_type        = Ret (*)(interpreter_interface*, LiteralList&, int);
+template<typename Ret, uint32_t Arity>
+struct intrinsic_invoker_impl<Ret, std::tuple<>, Arity> {
+   using next_method_type        = Ret (*)(interpreter_interface*, LiteralList&);
 
    template<next_method_type Method>
    static Literal invoke(interpreter_interface* interface, LiteralList& args) {
-      return convert_native_to_literal(interface, Method(interface, args, args.size() - 1));
+      ENU_ASSERT(args.size() == Arity, wasm_execution_error, "intrinsic called with the wrong number of arguments");
+      return convert_native_to_literal(interface, Method(interface, args));
    }
 
    template<next_method_type Method>
@@ -295,15 +313,16 @@ struct intrinsic_invoker_impl<Ret, std::tuple<>> {
 
 /**
  * specialization of the fully transcribed signature for void return values
- * @tparam Translated - the arguments to the wasm function
+ * @tparam Arity - the number of wasm arguments
  */
-template<>
-struct intrinsic_invoker_impl<void_type, std::tuple<>> {
-   using next_method_type        = void_type (*)(interpreter_interface*, LiteralList&, int);
+template<uint32_t Arity>
+struct intrinsic_invoker_impl<void_type, std::tuple<>, Arity> {
+   using next_method_type        = void_type (*)(interpreter_interface*, LiteralList&);
 
    template<next_method_type Method>
    static Literal invoke(interpreter_interface* interface, LiteralList& args) {
-      Method(interface, args, args.size() - 1);
+      ENU_ASSERT(args.size() == Arity, wasm_execution_error, "intrinsic called with the wrong number of arguments");
+      Method(interface, args);
       return Literal();
    }
 
@@ -318,17 +337,16 @@ struct intrinsic_invoker_impl<void_type, std::tuple<>> {
  * @tparam Ret - the return type of the native method
  * @tparam Input - the type of the native parameter to transcribe
  * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Index - the index of the argument of Input
  */
-template<typename Ret, typename Input, typename... Inputs>
-struct intrinsic_invoker_impl<Ret, std::tuple<Input, Inputs...>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>>;
-   using then_type = Ret (*)(interpreter_interface*, Input, Inputs..., LiteralList&, int);
+template<typename Ret, typename Input, typename... Inputs, uint32_t Index>
+struct intrinsic_invoker_impl<Ret, std::tuple<Input, Inputs...>, Index> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Index + 1>;
+   using then_type = Ret (*)(interpreter_interface*, Input, Inputs..., LiteralList&);
 
    template<then_type Then>
-   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) {
-      auto& last = args.at(offset);
-      auto native = convert_literal_to_native<Input>(last);
-      return Then(interface, native, rest..., args, (uint32_t)offset - 1);
+   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) {
+      return Then(interface, convert_literal_to_native<Input>(args[Index]), rest..., args);
    };
 
    template<then_type Then>
@@ -344,46 +362,45 @@ struct intrinsic_invoker_impl<Ret, std::tuple<Input, Inputs...>> {
  *
  * @tparam Ret - the return type of the native method
  * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Index - the index of the argument of the pointer
  */
-template<typename T, typename Ret, typename... Inputs>
-struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, size_t, Inputs...>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>>;
-   using then_type = Ret(*)(interpreter_interface*, array_ptr<T>, size_t, Inputs..., LiteralList&, int);
+template<typename T, typename Ret, typename... Inputs, uint32_t Index>
+struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, size_t, Inputs...>, Index> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Index + 2>;
+   using then_type = Ret(*)(interpreter_interface*, array_ptr<T>, size_t, Inputs..., LiteralList&);
 
    template<then_type Then, typename U=T>
-   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) -> std::enable_if_t<std::is_const<U>::value, Ret> {
+   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) -> std::enable_if_t<std::is_const<U>::value, Ret> {
       static_assert(!std::is_pointer<U>::value, "Currently don't support array of pointers");
-      uint32_t ptr = args.at((uint32_t)offset - 1).geti32();
-      size_t length = args.at((uint32_t)offset).geti32();
-      T* base = array_ptr_impl<T>(interface, ptr, length);
+      const uint32_t length = args[Index + 1].geti32();
+      T* base = array_ptr_impl<T>(interface, args[Index].geti32(), length);
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          wlog( "misaligned array of const values" );
          std::vector<std::remove_const_t<T> > copy(length > 0 ? length : 1);
          T* copy_ptr = &copy[0];
          memcpy( (void*)copy_ptr, (void*)base, length * sizeof(T) );
-         return Then(interface, static_cast<array_ptr<T>>(copy_ptr), length, rest..., args, (uint32_t)offset - 2);
+         return Then(interface, static_cast<array_ptr<T>>(copy_ptr), length, rest..., args);
       }
-      return Then(interface, static_cast<array_ptr<T>>(base), length, rest..., args, (uint32_t)offset - 2);
+      return Then(interface, static_cast<array_ptr<T>>(base), length, rest..., args);
    };
 
    template<then_type Then, typename U=T>
-   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
+   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
       static_assert(!std::is_pointer<U>::value, "Currently don't support array of pointers");
-      uint32_t ptr = args.at((uint32_t)offset - 1).geti32();
-      size_t length = args.at((uint32_t)offset).geti32();
-      T* base = array_ptr_impl<T>(interface, ptr, length);
+      const uint32_t length = args[Index + 1].geti32();
+      T* base = writable_array_ptr_impl<T>(interface, args[Index].geti32(), length);
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          wlog( "misaligned array of values" );
          std::vector<std::remove_const_t<T> > copy(length > 0 ? length : 1);
          T* copy_ptr = &copy[0];
          memcpy( (void*)copy_ptr, (void*)base, length * sizeof(T) );
-         Ret ret = Then(interface, static_cast<array_ptr<T>>(copy_ptr), length, rest..., args, (uint32_t)offset - 2);  
+         Ret ret = Then(interface, static_cast<array_ptr<T>>(copy_ptr), length, rest..., args);
          memcpy( (void*)base, (void*)copy_ptr, length * sizeof(T) );
          return ret;
       }
-      return Then(interface, static_cast<array_ptr<T>>(base), length, rest..., args, (uint32_t)offset - 2);
+      return Then(interface, static_cast<array_ptr<T>>(base), length, rest..., args);
    };
-   
+
    template<then_type Then>
    static const auto fn() {
       return next_step::template fn<translate_one<Then>>();
@@ -397,16 +414,16 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, size_t, Inputs...>>
  *
  * @tparam Ret - the return type of the native method
  * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Index - the index of the argument of the pointer
  */
-template<typename Ret, typename... Inputs>
-struct intrinsic_invoker_impl<Ret, std::tuple<null_terminated_ptr, Inputs...>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>>;
-   using then_type = Ret(*)(interpreter_interface*, null_terminated_ptr, Inputs..., LiteralList&, int);
+template<typename Ret, typename... Inputs, uint32_t Index>
+struct intrinsic_invoker_impl<Ret, std::tuple<null_terminated_ptr, Inputs...>, Index> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Index + 1>;
+   using then_type = Ret(*)(interpreter_interface*, null_terminated_ptr, Inputs..., LiteralList&);
 
    template<then_type Then>
-   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) {
-      uint32_t ptr = args.at((uint32_t)offset).geti32();
-      return Then(interface, null_terminated_ptr_impl(interface, ptr), rest..., args, (uint32_t)offset - 1);
+   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) {
+      return Then(interface, null_terminated_ptr_impl(interface, args[Index].geti32()), rest..., args);
    };
 
    template<then_type Then>
@@ -422,19 +439,22 @@ struct intrinsic_invoker_impl<Ret, std::tuple<null_terminated_ptr, Inputs...>> {
  *
  * @tparam Ret - the return type of the native method
  * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Index - the index of the argument of the first pointer
  */
-template<typename T, typename U, typename Ret, typename... Inputs>
-struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, array_ptr<U>, size_t, Inputs...>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>>;
-   using then_type = Ret(*)(interpreter_interface*, array_ptr<T>, array_ptr<U>, size_t, Inputs..., LiteralList&, int);
+template<typename T, typename U, typename Ret, typename... Inputs, uint32_t Index>
+struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, array_ptr<U>, size_t, Inputs...>, Index> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Index + 3>;
+   using then_type = Ret(*)(interpreter_interface*, array_ptr<T>, array_ptr<U>, size_t, Inputs..., LiteralList&);
 
    template<then_type Then>
-   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) {
-      uint32_t ptr_t = args.at((uint32_t)offset - 2).geti32();
-      uint32_t ptr_u = args.at((uint32_t)offset - 1).geti32();
-      size_t length = args.at((uint32_t)offset).geti32();
+   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) {
       static_assert(std::is_same<std::remove_const_t<T>, char>::value && std::is_same<std::remove_const_t<U>, char>::value, "Currently only support array of (const)chars");
-      return Then(interface, array_ptr_impl<T>(interface, ptr_t, length), array_ptr_impl<U>(interface, ptr_u, length), length, args, (uint32_t)offset - 3);
+      const uint32_t length = args[Index + 2].geti32();
+      T* t = std::is_const<T>::value ? array_ptr_impl<T>(interface, args[Index].geti32(), length)
+                                     : writable_array_ptr_impl<T>(interface, args[Index].geti32(), length);
+      U* u = std::is_const<U>::value ? array_ptr_impl<U>(interface, args[Index + 1].geti32(), length)
+                                     : writable_array_ptr_impl<U>(interface, args[Index + 1].geti32(), length);
+      return Then(interface, array_ptr<T>(t), array_ptr<U>(u), length, rest..., args);
    };
 
    template<then_type Then>
@@ -447,19 +467,16 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, array_ptr<U>, size_t
  * Specialization for transcribing memset parameters
  *
  * @tparam Ret - the return type of the native method
- * @tparam Inputs - the remaining native parameters to transcribe
  */
 template<typename Ret>
-struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<char>, int, size_t>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<>>;
-   using then_type = Ret(*)(interpreter_interface*, array_ptr<char>, int, size_t, LiteralList&, int);
+struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<char>, int, size_t>, 0> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<>, 3>;
+   using then_type = Ret(*)(interpreter_interface*, array_ptr<char>, int, size_t, LiteralList&);
 
    template<then_type Then>
-   static Ret translate_one(interpreter_interface* interface, LiteralList& args, int offset) {
-      uint32_t ptr = args.at((uint32_t)offset - 2).geti32();
-      uint32_t value = args.at((uint32_t)offset - 1).geti32();
-      size_t length = args.at((uint32_t)offset).geti32();
-      return Then(interface, array_ptr_impl<char>(interface, ptr, length), value, length, args, (uint32_t)offset - 3);
+   static Ret translate_one(interpreter_interface* interface, LiteralList& args) {
+      const uint32_t length = args[2].geti32();
+      return Then(interface, array_ptr<char>(writable_array_ptr_impl<char>(interface, args[0].geti32(), length)), args[1].geti32(), length, args);
    };
 
    template<then_type Then>
@@ -475,39 +492,38 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<char>, int, size_t>> {
  *
  * @tparam Ret - the return type of the native method
  * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Index - the index of the argument of the pointer
  */
-template<typename T, typename Ret, typename... Inputs>
-struct intrinsic_invoker_impl<Ret, std::tuple<T *, Inputs...>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>>;
-   using then_type = Ret (*)(interpreter_interface*, T *, Inputs..., LiteralList&, int);
+template<typename T, typename Ret, typename... Inputs, uint32_t Index>
+struct intrinsic_invoker_impl<Ret, std::tuple<T *, Inputs...>, Index> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Index + 1>;
+   using then_type = Ret (*)(interpreter_interface*, T *, Inputs..., LiteralList&);
 
    template<then_type Then, typename U=T>
-   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) -> std::enable_if_t<std::is_const<U>::value, Ret> {
-      uint32_t ptr = args.at((uint32_t)offset).geti32();
-      T* base = array_ptr_impl<T>(interface, ptr, 1);
+   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) -> std::enable_if_t<std::is_const<U>::value, Ret> {
+      T* base = array_ptr_impl<T>(interface, args[Index].geti32(), 1);
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          wlog( "misaligned const pointer" );
          std::remove_const_t<T> copy;
          T* copy_ptr = &copy;
          memcpy( (void*)copy_ptr, (void*)base, sizeof(T) );
-         return Then(interface, copy_ptr, rest..., args, (uint32_t)offset - 1);
+         return Then(interface, copy_ptr, rest..., args);
       }
-      return Then(interface, base, rest..., args, (uint32_t)offset - 1);
+      return Then(interface, base, rest..., args);
    };
 
    template<then_type Then, typename U=T>
-   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
-      uint32_t ptr = args.at((uint32_t)offset).geti32();
-      T* base = array_ptr_impl<T>(interface, ptr, 1);
+   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
+      T* base = writable_array_ptr_impl<T>(interface, args[Index].geti32(), 1);
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          wlog( "misaligned pointer" );
          T copy;
          memcpy( (void*)&copy, (void*)base, sizeof(T) );
-         Ret ret = Then(interface, &copy, rest..., args, (uint32_t)offset - 1);
+         Ret ret = Then(interface, &copy, rest..., args);
          memcpy( (void*)base, (void*)&copy, sizeof(T) );
          return ret; 
       }
-      return Then(interface, base, rest..., args, (uint32_t)offset - 1);
+      return Then(interface, base, rest..., args);
    };
 
    template<then_type Then>
@@ -523,17 +539,17 @@ struct intrinsic_invoker_impl<Ret, std::tuple<T *, Inputs...>> {
  *
  * @tparam Ret - the return type of the native method
  * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Index - the index of the argument of the name
  */
-template<typename Ret, typename... Inputs>
-struct intrinsic_invoker_impl<Ret, std::tuple<const name&, Inputs...>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>>;
-   using then_type = Ret (*)(interpreter_interface*, const name&, Inputs..., LiteralList&, int);
+template<typename Ret, typename... Inputs, uint32_t Index>
+struct intrinsic_invoker_impl<Ret, std::tuple<const name&, Inputs...>, Index> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Index + 1>;
+   using then_type = Ret (*)(interpreter_interface*, const name&, Inputs..., LiteralList&);
 
    template<then_type Then>
-   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) {
-      uint64_t wasm_value = args.at((uint32_t)offset).geti64();
-      auto value = name(wasm_value);
-      return Then(interface, value, rest..., args, (uint32_t)offset - 1);
+   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) {
+      auto value = name(uint64_t(args[Index].geti64()));
+      return Then(interface, value, rest..., args);
    }
 
    template<then_type Then>
@@ -549,17 +565,17 @@ struct intrinsic_invoker_impl<Ret, std::tuple<const name&, Inputs...>> {
  *
  * @tparam Ret - the return type of the native method
  * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Index - the index of the argument of the time
  */
-template<typename Ret, typename... Inputs>
-struct intrinsic_invoker_impl<Ret, std::tuple<const fc::time_point_sec&, Inputs...>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>>;
-   using then_type = Ret (*)(interpreter_interface*, const fc::time_point_sec&, Inputs..., LiteralList&, int);
+template<typename Ret, typename... Inputs, uint32_t Index>
+struct intrinsic_invoker_impl<Ret, std::tuple<const fc::time_point_sec&, Inputs...>, Index> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Index + 1>;
+   using then_type = Ret (*)(interpreter_interface*, const fc::time_point_sec&, Inputs..., LiteralList&);
 
    template<then_type Then>
-   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) {
-      uint32_t wasm_value = args.at((uint32_t)offset).geti32();
-      auto value = fc::time_point_sec(wasm_value);
-      return Then(interface, value, rest..., args, (uint32_t)offset - 1);
+   static Ret translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) {
+      auto value = fc::time_point_sec(uint32_t(args[Index].geti32()));
+      return Then(interface, value, rest..., args);
    }
 
    template<then_type Then>
@@ -576,16 +592,17 @@ struct intrinsic_invoker_impl<Ret, std::tuple<const fc::time_point_sec&, Inputs.
  *
  * @tparam Ret - the return type of the native method
  * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Index - the index of the argument of the pointer
  */
-template<typename T, typename Ret, typename... Inputs>
-struct intrinsic_invoker_impl<Ret, std::tuple<T &, Inputs...>> {
-   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>>;
-   using then_type = Ret (*)(interpreter_interface*, T &, Inputs..., LiteralList&, int);
+template<typename T, typename Ret, typename... Inputs, uint32_t Index>
+struct intrinsic_invoker_impl<Ret, std::tuple<T &, Inputs...>, Index> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Index + 1>;
+   using then_type = Ret (*)(interpreter_interface*, T &, Inputs..., LiteralList&);
 
    template<then_type Then, typename U=T>
-   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) -> std::enable_if_t<std::is_const<U>::value, Ret> {
+   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) -> std::enable_if_t<std::is_const<U>::value, Ret> {
       // references cannot be created for null pointers
-      uint32_t ptr = args.at((uint32_t)offset).geti32();
+      uint32_t ptr = args[Index].geti32();
       ENU_ASSERT(ptr != 0, binaryen_exception, "references cannot be created for null pointers");
       T* base = array_ptr_impl<T>(interface, ptr, 1);
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
@@ -593,26 +610,26 @@ struct intrinsic_invoker_impl<Ret, std::tuple<T &, Inputs...>> {
          std::remove_const_t<T> copy;
          T* copy_ptr = &copy;
          memcpy( (void*)copy_ptr, (void*)base, sizeof(T) );
-         return Then(interface, *copy_ptr, rest..., args, (uint32_t)offset - 1);
+         return Then(interface, *copy_ptr, rest..., args);
       }
-      return Then(interface, *base, rest..., args, (uint32_t)offset - 1);
+      return Then(interface, *base, rest..., args);
    }
 
    template<then_type Then, typename U=T>
-   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args, int offset) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
+   static auto translate_one(interpreter_interface* interface, Inputs... rest, LiteralList& args) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
       // references cannot be created for null pointers
-      uint32_t ptr = args.at((uint32_t)offset).geti32();
+      uint32_t ptr = args[Index].geti32();
       ENU_ASSERT(ptr != 0, binaryen_exception, "references cannot be created for null pointers");
-      T* base = array_ptr_impl<T>(interface, ptr, 1);
+      T* base = writable_array_ptr_impl<T>(interface, ptr, 1);
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          wlog( "misaligned reference" );
          T copy;
          memcpy( (void*)&copy, (void*)base, sizeof(T) );
-         Ret ret = Then(interface, copy, rest..., args, (uint32_t)offset - 1);
+         Ret ret = Then(interface, copy, rest..., args);
          memcpy( (void*)base, (void*)&copy, sizeof(T) );
          return ret; 
       }
-      return Then(interface, *base, rest..., args, (uint32_t)offset - 1);
+      return Then(interface, *base, rest..., args);
    }
 
 
@@ -627,12 +644,12 @@ struct intrinsic_invoker_impl<Ret, std::tuple<T &, Inputs...>> {
  */
 template<typename Ret, typename MethodSig, typename Cls, typename... Params>
 struct intrinsic_function_invoker {
-   using impl = intrinsic_invoker_impl<Ret, std::tuple<Params...>>;
+   using impl = intrinsic_invoker_impl<Ret, std::tuple<Params...>, 0>;
 
    template<MethodSig Method>
-   static Ret wrapper(interpreter_interface* interface, Params... params, LiteralList&, int) {
-      class_from_wasm<Cls>::value(interface->context).checktime();
-      return (class_from_wasm<Cls>::value(interface->context).*Method)(params...);
+   static Ret wrapper(interpreter_interface* interface, Params... params, LiteralList&) {
+      class_from_wasm<Cls>::value(*interface->context).checktime();
+      return (class_from_wasm<Cls>::value(*interface->context).*Method)(params...);
    }
 
    template<MethodSig Method>
@@ -643,12 +660,12 @@ struct intrinsic_function_invoker {
 
 template<typename MethodSig, typename Cls, typename... Params>
 struct intrinsic_function_invoker<void, MethodSig, Cls, Params...> {
-   using impl = intrinsic_invoker_impl<void_type, std::tuple<Params...>>;
+   using impl = intrinsic_invoker_impl<void_type, std::tuple<Params...>, 0>;
 
    template<MethodSig Method>
-   static void_type wrapper(interpreter_interface* interface, Params... params, LiteralList& args, int offset) {
-      class_from_wasm<Cls>::value(interface->context).checktime();
-      (class_from_wasm<Cls>::value(interface->context).*Method)(params...);
+   static void_type wrapper(interpreter_interface* interface, Params... params, LiteralList&) {
+      class_from_wasm<Cls>::value(*interface->context).checktime();
+      (class_from_wasm<Cls>::value(*interface->context).*Method)(params...);
       return void_type();
    }
 
@@ -0,0 +1,584 @@
+#pragma once
+
+#include <enumivo/chain/webassembly/common.hpp>
+#include <enumivo/chain/webassembly/runtime_interface.hpp>
+#include <enumivo/chain/exceptions.hpp>
+#include <enumivo/chain/apply_context.hpp>
+#include "IR/Types.h"
+
+#include <cstdlib>
+
+namespace enumivo { namespace chain { namespace webassembly { namespace predecoded {
+
+using namespace fc;
+using namespace enumivo::chain::webassembly::common;
+
+/**
+ * What the code of a running module and the intrinsics it calls share: its linear memory and the action it applies
+ */
+struct running_instance_context {
+   char*          memory = nullptr;
+   uint64_t       memory_size = 0;        ///< bytes of memory the running module can access
+   uint64_t       dirty_memory_size = 0;  ///< bytes at the start of memory that may not be zero
+   apply_context* apply_ctx = nullptr;
+};
+
+/**
+ * Interprets modules translated, when they are instantiated, into a stream of instructions that name the frame slots
+ * they read and write instead of going through an operand stack, and that calls intrinsics with their arguments in
+ * place
+ */
+class predecoded_runtime : public enumivo::chain::wasm_runtime_interface {
+   public:
+      predecoded_runtime();
+      std::unique_ptr<wasm_instantiated_module_interface> instantiate_module(const char* code_bytes, size_t code_size, std::vector<uint8_t> initial_memory) override;
+
+      /// shared by the modules of the runtime, which run one at a time
+      struct execution_state {
+         execution_state();
+
+         std::unique_ptr<char, decltype(&std::free)> memory; ///< maximum_linear_memory bytes
+         running_instance_context                    context;
+         std::vector<uint64_t>                       stack;   ///< frames of the functions being called
+      };
+
+   private:
+      execution_state _state;
+};
+
+/// an intrinsic reads its arguments from, and writes its result to, the slots the call put them in
+using intrinsic_fn = void(*)(running_instance_context&, uint64_t*);
+
+struct intrinsic_registrator {
+   struct intrinsic {
+      intrinsic_fn              fn;
+      const IR::FunctionType*   type;
+   };
+
+   static auto& get_map(){
+      static map<string, intrinsic> _map;
+      return _map;
+   };
+
+   intrinsic_registrator(const char* name, const IR::FunctionType* type, intrinsic_fn fn)
+   {
+      get_map()[string(name)] = intrinsic{fn, type};
+   }
+};
+
+/**
+ * validates an in-wasm-memory array with a single comparison; an empty array must still start inside the memory
+ */
+template<typename T>
+inline T* array_ptr_impl(running_instance_context& ctx, uint32_t ptr, uint32_t length)
+{
+   ENU_ASSERT( uint64_t(ptr) + std::max<uint64_t>(uint64_t(length) * sizeof(T), 1) <= ctx.memory_size,
+               wasm_execution_error, "access violation" );
+   return (T*)(ctx.memory + ptr);
+}
+
+/// intrinsics may write through the pointer, so its range counts as written
+template<typename T>
+inline T* writable_array_ptr_impl(running_instance_context& ctx, uint32_t ptr, uint32_t length)
+{
+   T* base = array_ptr_impl<T>(ctx, ptr, length);
+   const uint64_t end = uint64_t(ptr) + uint64_t(length) * sizeof(T);
+   if(end > ctx.dirty_memory_size)
+      ctx.dirty_memory_size = end;
+   return base;
+}
+
+inline null_terminated_ptr null_terminated_ptr_impl(running_instance_context& ctx, uint32_t ptr)
+{
+   ENU_ASSERT( ptr < ctx.memory_size && memchr(ctx.memory + ptr, 0, ctx.memory_size - ptr),
+               wasm_execution_error, "access violation" );
+   return null_terminated_ptr(ctx.memory + ptr);
+}
+
+template<typename T>
+inline T convert_slot_to_native(uint64_t slot) {
+   return T(slot);
+}
+
+template<>
+inline float convert_slot_to_native<float>(uint64_t slot) {
+   uint32_t bits = uint32_t(slot);
+   float f;
+   memcpy(&f, &bits, sizeof(f));
+   return f;
+}
+
+template<>
+inline double convert_slot_to_native<double>(uint64_t slot) {
+   double d;
+   memcpy(&d, &slot, sizeof(d));
+   return d;
+}
+
+template<>
+inline bool convert_slot_to_native<bool>(uint64_t slot) {
+   return uint32_t(slot) != 0;
+}
+
+template<>
+inline name convert_slot_to_native<name>(uint64_t slot) {
+   return name(slot);
+}
+
+/// i32 values are kept zero extended in their slots
+template<typename T>
+inline auto convert_native_to_slot(running_instance_context&, T val) -> std::enable_if_t<std::is_integral<T>::value, uint64_t> {
+   return sizeof(T) <= sizeof(uint32_t) ? uint64_t(uint32_t(val)) : uint64_t(val);
+}
+
+inline uint64_t convert_native_to_slot(running_instance_context&, float val) {
+   uint32_t bits;
+   memcpy(&bits, &val, sizeof(bits));
+   return bits;
+}
+
+inline uint64_t convert_native_to_slot(running_instance_context&, double val) {
+   uint64_t bits;
+   memcpy(&bits, &val, sizeof(bits));
+   return bits;
+}
+
+inline uint64_t convert_native_to_slot(running_instance_context&, const name& val) {
+   return val.value;
+}
+
+inline uint64_t convert_native_to_slot(running_instance_context&, const fc::time_point_sec& val) {
+   return val.sec_since_epoch();
+}
+
+inline uint64_t convert_native_to_slot(running_instance_context& ctx, char* ptr) {
+   ENU_ASSERT( ptr >= ctx.memory && ptr < ctx.memory + ctx.memory_size, wasm_execution_error, "returning pointer not in linear memory" );
+   return uint32_t(ptr - ctx.memory);
+}
+
+struct void_type {
+};
+
+/**
+ * Forward declaration of the invoker type which transcribes arguments from their slots to a native method
+ * and injects the appropriate checks; which slot each parameter is read from is known at compile time
+ *
+ * @tparam Ret - the return type of the native function
+ * @tparam NativeParameters - a std::tuple of the remaining native parameters to transcribe
+ * @tparam Slot - the slot of the first of the remaining parameters
+ */
+template<typename Ret, typename NativeParameters, uint32_t Slot>
+struct intrinsic_invoker_impl;
+
+/**
+ * Specialization for the fully transcribed signature, the result goes to the slot of the first argument
+ * @tparam Ret - the return type of the native function
+ * @tparam Slots - the number of slots the arguments take
+ */
+template<typename Ret, uint32_t Slots>
+struct intrinsic_invoker_impl<Ret, std::tuple<>, Slots> {
+   static constexpr uint32_t slots = Slots;
+   using next_method_type = Ret (*)(running_instance_context&, uint64_t*);
+
+   template<next_method_type Method>
+   static void invoke(running_instance_context& ctx, uint64_t* args) {
+      args[0] = convert_native_to_slot(ctx, Method(ctx, args));
+   }
+
+   template<next_method_type Method>
+   static constexpr intrinsic_fn fn() {
+      return invoke<Method>;
+   }
+};
+
+/**
+ * specialization of the fully transcribed signature for void return values
+ * @tparam Slots - the number of slots the arguments take
+ */
+template<uint32_t Slots>
+struct intrinsic_invoker_impl<void_type, std::tuple<>, Slots> {
+   static constexpr uint32_t slots = Slots;
+   using next_method_type = void_type (*)(running_instance_context&, uint64_t*);
+
+   template<next_method_type Method>
+   static void invoke(running_instance_context& ctx, uint64_t* args) {
+      Method(ctx, args);
+   }
+
+   template<next_method_type Method>
+   static constexpr intrinsic_fn fn() {
+      return invoke<Method>;
+   }
+};
+
+/**
+ * Specialization for transcribing a simple type in the native method signature
+ * @tparam Ret - the return type of the native method
+ * @tparam Input - the type of the native parameter to transcribe
+ * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Slot - the slot of Input
+ */
+template<typename Ret, typename Input, typename... Inputs, uint32_t Slot>
+struct intrinsic_invoker_impl<Ret, std::tuple<Input, Inputs...>, Slot> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Slot + 1>;
+   using then_type = Ret (*)(running_instance_context&, Input, Inputs..., uint64_t*);
+   static constexpr uint32_t slots = next_step::slots;
+
+   template<then_type Then>
+   static Ret translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) {
+      return Then(ctx, convert_slot_to_native<Input>(args[Slot]), rest..., args);
+   }
+
+   template<then_type Then>
+   static constexpr intrinsic_fn fn() {
+      return next_step::template fn<translate_one<Then>>();
+   }
+};
+
+/**
+ * Specialization for transcribing a array_ptr type in the native method signature
+ * This type transcribes 2 slots: a pointer and a length, which are validated together
+ *
+ * @tparam Ret - the return type of the native method
+ * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Slot - the slot of the pointer
+ */
+template<typename T, typename Ret, typename... Inputs, uint32_t Slot>
+struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, size_t, Inputs...>, Slot> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Slot + 2>;
+   using then_type = Ret(*)(running_instance_context&, array_ptr<T>, size_t, Inputs..., uint64_t*);
+   static constexpr uint32_t slots = next_step::slots;
+
+   template<then_type Then, typename U=T>
+   static auto translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) -> std::enable_if_t<std::is_const<U>::value, Ret> {
+      static_assert(!std::is_pointer<U>::value, "Currently don't support array of pointers");
+      const uint32_t length = uint32_t(args[Slot + 1]);
+      T* base = array_ptr_impl<T>(ctx, uint32_t(args[Slot]), length);
+      if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
+         wlog( "misaligned array of const values" );
+         std::vector<std::remove_const_t<T> > copy(length > 0 ? length : 1);
+         T* copy_ptr = &copy[0];
+         memcpy( (void*)copy_ptr, (void*)base, length * sizeof(T) );
+         return Then(ctx, static_cast<array_ptr<T>>(copy_ptr), length, rest..., args);
+      }
+      return Then(ctx, static_cast<array_ptr<T>>(base), length, rest..., args);
+   }
+
+   template<then_type Then, typename U=T>
+   static auto translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
+      static_assert(!std::is_pointer<U>::value, "Currently don't support array of pointers");
+      const uint32_t length = uint32_t(args[Slot + 1]);
+      T* base = writable_array_ptr_impl<T>(ctx, uint32_t(args[Slot]), length);
+      if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
+         wlog( "misaligned array of values" );
+         std::vector<std::remove_const_t<T> > copy(length > 0 ? length : 1);
+         T* copy_ptr = &copy[0];
+         memcpy( (void*)copy_ptr, (void*)base, length * sizeof(T) );
+         Ret ret = Then(ctx, static_cast<array_ptr<T>>(copy_ptr), length, rest..., args);
+         memcpy( (void*)base, (void*)copy_ptr, length * sizeof(T) );
+         return ret;
+      }
+      return Then(ctx, static_cast<array_ptr<T>>(base), length, rest..., args);
+   }
+
+   template<then_type Then>
+   static constexpr intrinsic_fn fn() {
+      return next_step::template fn<translate_one<Then>>();
+   }
+};
+
+/**
+ * Specialization for transcribing a null_terminated_ptr type in the native method signature
+ * This type transcribes 1 slot: a char pointer which is validated to contain a null value before the end of the memory
+ *
+ * @tparam Ret - the return type of the native method
+ * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Slot - the slot of the pointer
+ */
+template<typename Ret, typename... Inputs, uint32_t Slot>
+struct intrinsic_invoker_impl<Ret, std::tuple<null_terminated_ptr, Inputs...>, Slot> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Slot + 1>;
+   using then_type = Ret(*)(running_instance_context&, null_terminated_ptr, Inputs..., uint64_t*);
+   static constexpr uint32_t slots = next_step::slots;
+
+   template<then_type Then>
+   static Ret translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) {
+      return Then(ctx, null_terminated_ptr_impl(ctx, uint32_t(args[Slot])), rest..., args);
+   }
+
+   template<then_type Then>
+   static constexpr intrinsic_fn fn() {
+      return next_step::template fn<translate_one<Then>>();
+   }
+};
+
+/**
+ * Specialization for transcribing a pair of array_ptr types in the native method signature that share size
+ * This type transcribes 3 slots: 2 pointers and a length
+ *
+ * @tparam Ret - the return type of the native method
+ * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Slot - the slot of the first pointer
+ */
+template<typename T, typename U, typename Ret, typename... Inputs, uint32_t Slot>
+struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, array_ptr<U>, size_t, Inputs...>, Slot> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Slot + 3>;
+   using then_type = Ret(*)(running_instance_context&, array_ptr<T>, array_ptr<U>, size_t, Inputs..., uint64_t*);
+   static constexpr uint32_t slots = next_step::slots;
+
+   template<then_type Then>
+   static Ret translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) {
+      static_assert(std::is_same<std::remove_const_t<T>, char>::value && std::is_same<std::remove_const_t<U>, char>::value, "Currently only support array of (const)chars");
+      const uint32_t length = uint32_t(args[Slot + 2]);
+      T* t = std::is_const<T>::value ? array_ptr_impl<T>(ctx, uint32_t(args[Slot]), length)
+                                     : writable_array_ptr_impl<T>(ctx, uint32_t(args[Slot]), length);
+      U* u = std::is_const<U>::value ? array_ptr_impl<U>(ctx, uint32_t(args[Slot + 1]), length)
+                                     : writable_array_ptr_impl<U>(ctx, uint32_t(args[Slot + 1]), length);
+      return Then(ctx, array_ptr<T>(t), array_ptr<U>(u), length, rest..., args);
+   }
+
+   template<then_type Then>
+   static constexpr intrinsic_fn fn() {
+      return next_step::template fn<translate_one<Then>>();
+   }
+};
+
+/**
+ * Specialization for transcribing memset parameters
+ *
+ * @tparam Ret - the return type of the native method
+ */
+template<typename Ret>
+struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<char>, int, size_t>, 0> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<>, 3>;
+   using then_type = Ret(*)(running_instance_context&, array_ptr<char>, int, size_t, uint64_t*);
+   static constexpr uint32_t slots = next_step::slots;
+
+   template<then_type Then>
+   static Ret translate_one(running_instance_context& ctx, uint64_t* args) {
+      const uint32_t length = uint32_t(args[2]);
+      return Then(ctx, array_ptr<char>(writable_array_ptr_impl<char>(ctx, uint32_t(args[0]), length)), int(args[1]), length, args);
+   }
+
+   template<then_type Then>
+   static constexpr intrinsic_fn fn() {
+      return next_step::template fn<translate_one<Then>>();
+   }
+};
+
+/**
+ * Specialization for transcribing a pointer type in the native method signature
+ * This type transcribes 1 slot: a pointer to a single T
+ *
+ * @tparam Ret - the return type of the native method
+ * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Slot - the slot of the pointer
+ */
+template<typename T, typename Ret, typename... Inputs, uint32_t Slot>
+struct intrinsic_invoker_impl<Ret, std::tuple<T *, Inputs...>, Slot> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Slot + 1>;
+   using then_type = Ret (*)(running_instance_context&, T *, Inputs..., uint64_t*);
+   static constexpr uint32_t slots = next_step::slots;
+
+   template<then_type Then, typename U=T>
+   static auto translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) -> std::enable_if_t<std::is_const<U>::value, Ret> {
+      T* base = array_ptr_impl<T>(ctx, uint32_t(args[Slot]), 1);
+      if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
+         wlog( "misaligned const pointer" );
+         std::remove_const_t<T> copy;
+         T* copy_ptr = &copy;
+         memcpy( (void*)copy_ptr, (void*)base, sizeof(T) );
+         return Then(ctx, copy_ptr, rest..., args);
+      }
+      return Then(ctx, base, rest..., args);
+   }
+
+   template<then_type Then, typename U=T>
+   static auto translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
+      T* base = writable_array_ptr_impl<T>(ctx, uint32_t(args[Slot]), 1);
+      if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
+         wlog( "misaligned pointer" );
+         T copy;
+         memcpy( (void*)&copy, (void*)base, sizeof(T) );
+         Ret ret = Then(ctx, &copy, rest..., args);
+         memcpy( (void*)base, (void*)&copy, sizeof(T) );
+         return ret;
+      }
+      return Then(ctx, base, rest..., args);
+   }
+
+   template<then_type Then>
+   static constexpr intrinsic_fn fn() {
+      return next_step::template fn<translate_one<Then>>();
+   }
+};
+
+/**
+ * Specialization for transcribing a reference to a name which can be passed as a native value
+ *
+ * @tparam Ret - the return type of the native method
+ * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Slot - the slot of the name
+ */
+template<typename Ret, typename... Inputs, uint32_t Slot>
+struct intrinsic_invoker_impl<Ret, std::tuple<const name&, Inputs...>, Slot> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Slot + 1>;
+   using then_type = Ret (*)(running_instance_context&, const name&, Inputs..., uint64_t*);
+   static constexpr uint32_t slots = next_step::slots;
+
+   template<then_type Then>
+   static Ret translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) {
+      auto value = name(args[Slot]);
+      return Then(ctx, value, rest..., args);
+   }
+
+   template<then_type Then>
+   static constexpr intrinsic_fn fn() {
+      return next_step::template fn<translate_one<Then>>();
+   }
+};
+
+/**
+ * Specialization for transcribing a reference type in the native method signature
+ * This type transcribes 1 slot: a pointer which may not be null, checked the way the wavm runtime checks it
+ *
+ * @tparam Ret - the return type of the native method
+ * @tparam Inputs - the remaining native parameters to transcribe
+ * @tparam Slot - the slot of the pointer
+ */
+template<typename T, typename Ret, typename... Inputs, uint32_t Slot>
+struct intrinsic_invoker_impl<Ret, std::tuple<T &, Inputs...>, Slot> {
+   using next_step = intrinsic_invoker_impl<Ret, std::tuple<Inputs...>, Slot + 1>;
+   using then_type = Ret (*)(running_instance_context&, T &, Inputs..., uint64_t*);
+   static constexpr uint32_t slots = next_step::slots;
+
+   static T* validate(running_instance_context& ctx, uint32_t ptr) {
+      // references cannot be created for null pointers
+      ENU_ASSERT(ptr != 0, wasm_exception, "references cannot be created for null pointers");
+      ENU_ASSERT(uint64_t(ptr) + sizeof(T) < ctx.memory_size, wasm_execution_error, "access violation");
+      return (T*)(ctx.memory + ptr);
+   }
+
+   template<then_type Then, typename U=T>
+   static auto translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) -> std::enable_if_t<std::is_const<U>::value, Ret> {
+      T* base = validate(ctx, uint32_t(args[Slot]));
+      if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
+         wlog( "misaligned const reference" );
+         std::remove_const_t<T> copy;
+         T* copy_ptr = &copy;
+         memcpy( (void*)copy_ptr, (void*)base, sizeof(T) );
+         return Then(ctx, *copy_ptr, rest..., args);
+      }
+      return Then(ctx, *base, rest..., args);
+   }
+
+   template<then_type Then, typename U=T>
+   static auto translate_one(running_instance_context& ctx, Inputs... rest, uint64_t* args) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
+      const uint32_t ptr = uint32_t(args[Slot]);
+      T* base = validate(ctx, ptr);
+      if(uint64_t(ptr) + sizeof(T) > ctx.dirty_memory_size)
+         ctx.dirty_memory_size = uint64_t(ptr) + sizeof(T);
+      if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
+         wlog( "misaligned reference" );
+         T copy;
+         memcpy( (void*)&copy, (void*)base, sizeof(T) );
+         Ret ret = Then(ctx, copy, rest..., args);
+         memcpy( (void*)base, (void*)&copy, sizeof(T) );
+         return ret;
+      }
+      return Then(ctx, *base, rest..., args);
+   }
+
+   template<then_type Then>
+   static constexpr intrinsic_fn fn() {
+      return next_step::template fn<translate_one<Then>>();
+   }
+};
+
+/**
+ * wrapper class to call methods of the class
+ */
+template<typename Ret, typename MethodSig, typename Cls, typename... Params>
+struct intrinsic_function_invoker {
+   using impl = intrinsic_invoker_impl<Ret, std::tuple<Params...>, 0>;
+
+   template<MethodSig Method>
+   static Ret wrapper(running_instance_context& ctx, Params... params, uint64_t*) {
+      class_from_wasm<Cls>::value(*ctx.apply_ctx).checktime();
+      return (class_from_wasm<Cls>::value(*ctx.apply_ctx).*Method)(params...);
+   }
+
+   template<MethodSig Method>
+   static constexpr intrinsic_fn fn() {
+      return impl::template fn<wrapper<Method>>();
+   }
+};
+
+template<typename MethodSig, typename Cls, typename... Params>
+struct intrinsic_function_invoker<void, MethodSig, Cls, Params...> {
+   using impl = intrinsic_invoker_impl<void_type, std::tuple<Params...>, 0>;
+
+   template<MethodSig Method>
+   static void_type wrapper(running_instance_context& ctx, Params... params, uint64_t*) {
+      class_from_wasm<Cls>::value(*ctx.apply_ctx).checktime();
+      (class_from_wasm<Cls>::value(*ctx.apply_ctx).*Method)(params...);
+      return void_type();
+   }
+
+   template<MethodSig Method>
+   static constexpr intrinsic_fn fn() {
+      return impl::template fn<wrapper<Method>>();
+   }
+};
+
+template<typename WasmSig, typename MethodSig>
+struct intrinsic_function_invoker_wrapper;
+
+template<typename WasmSig, typename Cls, typename Ret, typename... Params>
+struct intrinsic_function_invoker_wrapper<WasmSig, Ret (Cls::*)(Params...)> {
+   using type = intrinsic_function_invoker<Ret, Ret (Cls::*)(Params...), Cls, Params...>;
+};
+
+template<typename WasmSig, typename Cls, typename Ret, typename... Params>
+struct intrinsic_function_invoker_wrapper<WasmSig, Ret (Cls::*)(Params...) const> {
+   using type = intrinsic_function_invoker<Ret, Ret (Cls::*)(Params...) const, Cls, Params...>;
+};
+
+template<typename WasmSig, typename Cls, typename Ret, typename... Params>
+struct intrinsic_function_invoker_wrapper<WasmSig, Ret (Cls::*)(Params...) volatile> {
+   using type = intrinsic_function_invoker<Ret, Ret (Cls::*)(Params...) volatile, Cls, Params...>;
+};
+
+template<typename WasmSig, typename Cls, typename Ret, typename... Params>
+struct intrinsic_function_invoker_wrapper<WasmSig, Ret (Cls::*)(Params...) const volatile> {
+   using type = intrinsic_function_invoker<Ret, Ret (Cls::*)(Params...) const volatile, Cls, Params...>;
+};
+
+/// the native parameters must take as many slots as the ABI has parameters
+template<typename WasmSig, typename MethodSig>
+struct wasm_arity_matches;
+
+template<typename WasmRet, typename... WasmParams, typename MethodSig>
+struct wasm_arity_matches<WasmRet(WasmParams...), MethodSig> {
+   static constexpr bool value = intrinsic_function_invoker_wrapper<WasmRet(WasmParams...), MethodSig>::type::impl::slots == sizeof...(WasmParams);
+};
+
+#define _ADD_PAREN_1(...) ((__VA_ARGS__)) _ADD_PAREN_2
+#define _ADD_PAREN_2(...) ((__VA_ARGS__)) _ADD_PAREN_1
+#define _ADD_PAREN_1_END
+#define _ADD_PAREN_2_END
+#define _WRAPPED_SEQ(SEQ) BOOST_PP_CAT(_ADD_PAREN_1 SEQ, _END)
+
+#define __INTRINSIC_NAME(LABEL, SUFFIX) LABEL##SUFFIX
+#define _INTRINSIC_NAME(LABEL, SUFFIX) __INTRINSIC_NAME(LABEL,SUFFIX)
+
+#define _REGISTER_PREDECODED_INTRINSIC(CLS, MOD, METHOD, WASM_SIG, NAME, SIG)\
+   static_assert(enumivo::chain::webassembly::predecoded::wasm_arity_matches<WASM_SIG, SIG>::value,\
+                 "Intrinsic function signature does not match the ABI");\
+   static enumivo::chain::webassembly::predecoded::intrinsic_registrator _INTRINSIC_NAME(__predecoded_intrinsic_fn, __COUNTER__)(\
+      MOD "." NAME,\
+      enumivo::chain::webassembly::wavm::wasm_function_type_provider<WASM_SIG>::type(),\
+      enumivo::chain::webassembly::predecoded::intrinsic_function_invoker_wrapper<WASM_SIG, SIG>::type::fn<&CLS::METHOD>()\
+   );\
+
+} } } }// enumivo::chain::webassembly::predecoded
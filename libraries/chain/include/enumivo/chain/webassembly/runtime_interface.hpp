@@ -10,6 +10,9 @@ class wasm_instantiated_module_interface {
    public:
       virtual void apply(apply_context& context) = 0;
 
+      //bytes of compiled code and initial memory image held by the module
+      virtual size_t memory_usage()const = 0;
+
       virtual ~wasm_instantiated_module_interface();
 };
 
@@ -17,7 +20,11 @@ class wasm_runtime_interface {
    public:
       virtual std::unique_ptr<wasm_instantiated_module_interface> instantiate_module(const char* code_bytes, size_t code_size, std::vector<uint8_t> initial_memory) = 0;
 
+      //releases what is left of the modules destroyed since the last call, for runtimes that cannot free a module
+      //as soon as it is destroyed
+      virtual void free_unreferenced_modules() {}
+
       virtual ~wasm_runtime_interface();
 };
 
-}}
\ No newline at end of file
+}}
@@ -20,6 +20,7 @@ class wavm_runtime : public enumivo::chain::wasm_runtime_interface {
       wavm_runtime();
       ~wavm_runtime();
       std::unique_ptr<wasm_instantiated_module_interface> instantiate_module(const char* code_bytes, size_t code_size, std::vector<uint8_t> initial_memory) override;
+      void free_unreferenced_modules() override;
 
       struct runtime_guard {
          runtime_guard();
@@ -33,31 +34,37 @@ class wavm_runtime : public enumivo::chain::wasm_runtime_interface {
 //This is a temporary hack for the single threaded implementation
 struct running_instance_context {
    MemoryInstance* memory;
+   char*           memory_base; ///< of memory, which does not move when it grows
    apply_context*  apply_ctx;
 };
 extern running_instance_context the_running_instance_context;
 
+/**
+ * bytes of memory the running instance can access
+ */
+inline uint64_t memory_size(running_instance_context& ctx)
+{
+   if(!ctx.memory)
+      Runtime::causeException(Exception::Cause::accessViolation);
+   return uint64_t(IR::numBytesPerPage) * Runtime::getMemoryNumPages(ctx.memory);
+}
+
 /**
  * class to represent an in-wasm-memory array
  * it is a hint to the transcriber that the next parameter will
  * be a size (in Ts) and that the pair are validated together
  * This triggers the template specialization of intrinsic_invoker_impl
+ * the range is validated with a single comparison, which cannot overflow in 64 bits; an empty array must still start
+ * inside the memory
  * @tparam T
  */
 template<typename T>
-inline array_ptr<T> array_ptr_impl (running_instance_context& ctx, U32 ptr, size_t length)
+inline array_ptr<T> array_ptr_impl (running_instance_context& ctx, U32 ptr, U32 length)
 {
-   MemoryInstance* mem = ctx.memory;
-   if (!mem) 
-      Runtime::causeException(Exception::Cause::accessViolation);
-
-   size_t mem_total = IR::numBytesPerPage * Runtime::getMemoryNumPages(mem);
-   if (ptr >= mem_total || length > (mem_total - ptr) / sizeof(T))
+   if (uint64_t(ptr) + std::max<uint64_t>(uint64_t(length) * sizeof(T), 1) > memory_size(ctx))
       Runtime::causeException(Exception::Cause::accessViolation);
-   
-   T* ret_ptr = (T*)(getMemoryBaseAddress(mem) + ptr);
 
-   return array_ptr<T>((T*)(getMemoryBaseAddress(mem) + ptr));
+   return array_ptr<T>((T*)(ctx.memory_base + ptr));
 }
 
 /**
@@ -65,18 +72,11 @@ inline array_ptr<T> array_ptr_impl (running_instance_context& ctx, U32 ptr, size
  */
 inline null_terminated_ptr null_terminated_ptr_impl(running_instance_context& ctx, U32 ptr)
 {
-   MemoryInstance* mem = ctx.memory;
-   if(!mem)
+   const uint64_t size = memory_size(ctx);
+   if(ptr >= size || !memchr(ctx.memory_base + ptr, 0, size - ptr))
       Runtime::causeException(Exception::Cause::accessViolation);
 
-   char *value                     = (char*)(getMemoryBaseAddress(mem) + ptr);
-   const char* p                   = value;
-   const char* const top_of_memory = (char*)(getMemoryBaseAddress(mem) + IR::numBytesPerPage*Runtime::getMemoryNumPages(mem));
-   while(p < top_of_memory)
-      if(*p++ == '\0')
-         return null_terminated_ptr(value);
-
-   Runtime::causeException(Exception::Cause::accessViolation);
+   return null_terminated_ptr(ctx.memory_base + ptr);
 }
 
 
@@ -164,11 +164,8 @@ inline auto convert_native_to_wasm(const running_instance_context& ctx, const fc
 }
 
 inline auto convert_native_to_wasm(running_instance_context& ctx, char* ptr) {
-   MemoryInstance* mem = ctx.memory;
-   if(!mem)
-      Runtime::causeException(Exception::Cause::accessViolation);
-   char* base = (char*)getMemoryBaseAddress(mem);
-   char* top_of_memory = base + IR::numBytesPerPage*Runtime::getMemoryNumPages(mem);
+   char* base = ctx.memory_base;
+   char* top_of_memory = base + memory_size(ctx);
    if(ptr < base || ptr >= top_of_memory)
       Runtime::causeException(Exception::Cause::accessViolation);
    return (U32)(ptr - base);
@@ -379,7 +376,7 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, size_t, Inputs...>,
    template<then_type Then, typename U=T>
    static auto translate_one(running_instance_context& ctx, Inputs... rest, Translated... translated, I32 ptr, I32 size) -> std::enable_if_t<std::is_const<U>::value, Ret> {
       static_assert(!std::is_pointer<U>::value, "Currently don't support array of pointers");
-      const auto length = size_t(size);
+      const auto length = size_t(U32(size));
       T* base = array_ptr_impl<T>(ctx, (U32)ptr, length);
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          wlog( "misaligned array of const values" );
@@ -394,7 +391,7 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, size_t, Inputs...>,
    template<then_type Then, typename U=T>
    static auto translate_one(running_instance_context& ctx, Inputs... rest, Translated... translated, I32 ptr, I32 size) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
       static_assert(!std::is_pointer<U>::value, "Currently don't support array of pointers");
-      const auto length = size_t(size);
+      const auto length = size_t(U32(size));
       T* base = array_ptr_impl<T>(ctx, (U32)ptr, length);
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          wlog( "misaligned array of values" );
@@ -456,7 +453,7 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, array_ptr<U>, size_t
    template<then_type Then>
    static Ret translate_one(running_instance_context& ctx, Inputs... rest, Translated... translated, I32 ptr_t, I32 ptr_u, I32 size) {
       static_assert(std::is_same<std::remove_const_t<T>, char>::value && std::is_same<std::remove_const_t<U>, char>::value, "Currently only support array of (const)chars");
-      const auto length = size_t(size);
+      const auto length = size_t(U32(size));
       return Then(ctx, array_ptr_impl<T>(ctx, (U32)ptr_t, length), array_ptr_impl<U>(ctx, (U32)ptr_u, length), length, rest..., translated...);
    };
 
@@ -480,7 +477,7 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<char>, int, size_t>, std
 
    template<then_type Then>
    static Ret translate_one(running_instance_context& ctx, I32 ptr, I32 value, I32 size) {
-      const auto length = size_t(size);
+      const auto length = size_t(U32(size));
       return Then(ctx, array_ptr_impl<char>(ctx, (U32)ptr, length), value, length);
    };
 
@@ -582,10 +579,9 @@ struct intrinsic_invoker_impl<Ret, std::tuple<T &, Inputs...>, std::tuple<Transl
    static auto translate_one(running_instance_context& ctx, Inputs... rest, Translated... translated, I32 ptr) -> std::enable_if_t<std::is_const<U>::value, Ret> {
       // references cannot be created for null pointers
       ENU_ASSERT((U32)ptr != 0, wasm_exception, "references cannot be created for null pointers");
-      MemoryInstance* mem = ctx.memory;
-      if(!mem || (U32)ptr+sizeof(T) >= IR::numBytesPerPage*Runtime::getMemoryNumPages(mem))
+      if(uint64_t(U32(ptr)) + sizeof(T) >= memory_size(ctx))
          Runtime::causeException(Exception::Cause::accessViolation);
-      T &base = *(T*)(getMemoryBaseAddress(mem)+(U32)ptr);
+      T &base = *(T*)(ctx.memory_base+(U32)ptr);
       if ( reinterpret_cast<uintptr_t>(&base) % alignof(T) != 0 ) {
          wlog( "misaligned const reference" );
          std::remove_const_t<T> copy;
@@ -600,10 +596,9 @@ struct intrinsic_invoker_impl<Ret, std::tuple<T &, Inputs...>, std::tuple<Transl
    static auto translate_one(running_instance_context& ctx, Inputs... rest, Translated... translated, I32 ptr) -> std::enable_if_t<!std::is_const<U>::value, Ret> {
       // references cannot be created for null pointers
       ENU_ASSERT((U32)ptr != 0, wasm_exception, "reference cannot be created for null pointers");
-      MemoryInstance* mem = ctx.memory;
-      if(!mem || (U32)ptr+sizeof(T) >= IR::numBytesPerPage*Runtime::getMemoryNumPages(mem))
+      if(uint64_t(U32(ptr)) + sizeof(T) >= memory_size(ctx))
          Runtime::causeException(Exception::Cause::accessViolation);
-      T &base = *(T*)(getMemoryBaseAddress(mem)+(U32)ptr);
+      T &base = *(T*)(ctx.memory_base+(U32)ptr);
       if ( reinterpret_cast<uintptr_t>(&base) % alignof(T) != 0 ) {
          wlog( "misaligned reference" );
          std::remove_const_t<T> copy;
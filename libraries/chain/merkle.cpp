@@ -32,6 +32,16 @@ bool is_canonical_right(const digest_type& val) {
 }
 
 
+/**
+ * hashes the pairs of ids [2 * begin, 2 * end) into [begin, end) of parents, which may be ids itself as a pair is
+ * read before its parent is written over it
+ */
+static void hash_pairs( const vector<digest_type>& ids, vector<digest_type>& parents, size_t begin, size_t end ) {
+   for( size_t i = begin; i < end; ++i ) {
+      parents[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
+   }
+}
+
 digest_type merkle(vector<digest_type> ids) {
    if( 0 == ids.size() ) { return digest_type(); }
 
@@ -39,9 +49,7 @@ digest_type merkle(vector<digest_type> ids) {
       if( ids.size() % 2 )
          ids.push_back(ids.back());
 
-      for (int i = 0; i < ids.size() / 2; i++) {
-         ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
-      }
+      hash_pairs( ids, ids, 0, ids.size() / 2 );
 
       ids.resize(ids.size() / 2);
    }
@@ -49,4 +57,78 @@ digest_type merkle(vector<digest_type> ids) {
    return ids.front();
 }
 
+void merkle_accumulator::append( const digest_type& digest ) {
+   append_subtree( digest, 0 );
+}
+
+void merkle_accumulator::append( const vector<digest_type>& digests, boost::asio::thread_pool* pool ) {
+   size_t i = 0;
+   while( i < digests.size() ) {
+      // the largest complete subtree that can start at _node_count and is filled by the remaining digests
+      size_t level = 0;
+      while( !(_node_count & (uint64_t(1) << level)) && (uint64_t(2) << level) <= digests.size() - i )
+         ++level;
+
+      auto count = size_t(1) << level;
+      if( level == 0 )
+         append_subtree( digests[i], 0 );
+      else
+         append_subtree( merkle( vector<digest_type>( digests.begin() + i, digests.begin() + i + count ), pool ), level );
+      i += count;
+   }
+}
+
+void merkle_accumulator::append_subtree( digest_type top, size_t level ) {
+   auto added = uint64_t(1) << level;
+   // every complete subtree with a set bit below the first clear one becomes the left sibling of the new one
+   for( ; _node_count & (uint64_t(1) << level); ++level )
+      top = digest_type::hash(make_canonical_pair(_subtree_roots[level], top));
+   if( _subtree_roots.size() <= level )
+      _subtree_roots.resize( level + 1 );
+   _subtree_roots[level] = top;
+   _node_count += added;
+}
+
+digest_type merkle_accumulator::get_root()const {
+   if( _node_count == 0 ) { return digest_type(); }
+
+   auto highest = _subtree_roots.size() - 1;
+   while( !(_node_count & (uint64_t(1) << highest)) ) --highest;
+   if( _node_count == (uint64_t(1) << highest) ) { return _subtree_roots[highest]; }
+
+   // the last node of every level with an odd number of nodes is paired with itself, as merkle() does
+   optional<digest_type> top;
+   for( size_t level = 0; level <= highest; ++level ) {
+      bool complete = _node_count & (uint64_t(1) << level);
+      if( complete && top )
+         top = digest_type::hash(make_canonical_pair(_subtree_roots[level], *top));
+      else if( complete )
+         top = digest_type::hash(make_canonical_pair(_subtree_roots[level], _subtree_roots[level]));
+      else if( top )
+         top = digest_type::hash(make_canonical_pair(*top, *top));
+   }
+   return *top;
+}
+
+digest_type merkle( vector<digest_type> ids, boost::asio::thread_pool* pool ) {
+   if( !pool ) { return merkle( move(ids) ); }
+
+   // batches of a level read pairs other batches write over, so each level is written to the other vector
+   vector<digest_type> parents;
+   while( ids.size() / 2 > merkle_batch_size ) {
+      if( ids.size() % 2 )
+         ids.push_back(ids.back());
+
+      parents.resize( ids.size() / 2 );
+      for_each_batch( *pool, parents.size(), merkle_batch_size, [&]( size_t begin, size_t end ) {
+         hash_pairs( ids, parents, begin, end );
+      });
+
+      std::swap( ids, parents );
+   }
+
+   // the remaining levels are too small to be worth handing out
+   return merkle( move(ids) );
+}
+
 } } // enumivo::chain
@@ -0,0 +1,133 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#include <enumivo/chain/replay_profiler.hpp>
+#include <enumivo/chain/transaction_conflicts.hpp>
+#include <enumivo/chain/config.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <fstream>
+
+namespace enumivo { namespace chain {
+
+   replay_profiler::replay_profiler( uint32_t slowest_blocks )
+   :max_slowest_blocks( slowest_blocks )
+   {}
+
+   void replay_profiler::add_transaction( const transaction_trace& trace ) {
+      transaction_times.add( trace.elapsed );
+      ++pending_transactions;
+      for( const auto& at : trace.action_traces )
+         add_action( at );
+
+      if( trace.action_traces.size() == 1 && trace.action_traces.front().act.account == config::system_account_name
+          && trace.action_traces.front().act.name == N(onblock) ) {
+         pending_serial += trace.elapsed;
+         return;
+      }
+      pending_grouped.push_back( pending_transaction{ declared_accounts( trace ), touched_accounts( trace ), trace.elapsed } );
+   }
+
+   void replay_profiler::add_action( const action_trace& trace ) {
+      action_times[std::make_tuple( trace.receipt.receiver, trace.act.account, trace.act.name )].add( trace.elapsed );
+      ++pending_actions;
+      for( const auto& inline_trace : trace.inline_traces )
+         add_action( inline_trace );
+   }
+
+   void replay_profiler::add_block( uint32_t block_num, fc::microseconds elapsed ) {
+      block_timing b{ block_num, elapsed, pending_transactions, pending_actions };
+
+      vector<flat_set<account_name>> declared, touched;
+      for( auto& t : pending_grouped ) {
+         declared.push_back( std::move( t.declared ) );
+         touched.push_back( std::move( t.touched ) );
+      }
+      auto groups = conflict_groups( touched );
+      auto declared_groups = conflict_groups( declared );
+      vector<fc::microseconds> group_times;
+      for( size_t i = 0; i < groups.size(); ++i ) {
+         if( groups[i] >= group_times.size() )
+            group_times.resize( groups[i] + 1 );
+         group_times[groups[i]] += pending_grouped[i].elapsed;
+         b.declared_groups = std::max( b.declared_groups, declared_groups[i] + 1 );
+      }
+      b.groups = group_times.size();
+      b.critical_path = pending_serial;
+      if( !group_times.empty() )
+         b.critical_path += *std::max_element( group_times.begin(), group_times.end() );
+      block_times.push_back( b );
+
+      pending_transactions = 0;
+      pending_actions = 0;
+      pending_grouped.clear();
+      pending_serial = fc::microseconds();
+   }
+
+   vector<replay_profiler::action_timing> replay_profiler::actions()const {
+      vector<action_timing> result;
+      result.reserve( action_times.size() );
+      for( const auto& a : action_times )
+         result.push_back( action_timing{ std::get<0>( a.first ), std::get<1>( a.first ), std::get<2>( a.first ), a.second } );
+      std::stable_sort( result.begin(), result.end(), []( const action_timing& l, const action_timing& r ) {
+         return l.time.total > r.time.total;
+      });
+      return result;
+   }
+
+   vector<replay_profiler::block_timing> replay_profiler::slowest_blocks()const {
+      vector<block_timing> result( block_times );
+      auto n = std::min<size_t>( max_slowest_blocks, result.size() );
+      std::partial_sort( result.begin(), result.begin() + n, result.end(), []( const block_timing& l, const block_timing& r ) {
+         return l.elapsed > r.elapsed;
+      });
+      result.resize( n );
+      return result;
+   }
+
+   void replay_profiler::write( const fc::path& file )const {
+      fc::microseconds total, critical_path;
+      for( const auto& b : block_times ) {
+         total += b.elapsed;
+         critical_path += b.critical_path;
+      }
+
+      if( file.extension().generic_string() != ".csv" ) {
+         fc::mutable_variant_object report;
+         report( "blocks", block_times.size() )
+               ( "total", total )
+               ( "critical_path", critical_path )
+               ( "transactions", transaction_times )
+               ( "slowest_blocks", slowest_blocks() )
+               ( "actions", actions() )
+               ( "block_times", block_times );
+         fc::json::save_to_file( report, file, true );
+         return;
+      }
+
+      std::ofstream out;
+      out.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+      out.open( file.generic_string().c_str(), std::ios::out | std::ios::trunc );
+
+      out << "record,block_num,receiver,contract,action,transactions,actions,count,total_us,max_us,"
+             "groups,declared_groups,critical_path_us\n";
+      auto write_block = [&]( const char* record, const block_timing& b ) {
+         out << record << ',' << b.block_num << ",,,," << b.transactions << ',' << b.actions << ",1,"
+             << b.elapsed.count() << ',' << b.elapsed.count() << ',' << b.groups << ',' << b.declared_groups << ','
+             << b.critical_path.count() << '\n';
+      };
+      for( const auto& b : block_times )
+         write_block( "block", b );
+      for( const auto& b : slowest_blocks() )
+         write_block( "slowest_block", b );
+      out << "transaction,,,,,,," << transaction_times.count << ',' << transaction_times.total.count() << ','
+          << transaction_times.max.count() << ",,,\n";
+      for( const auto& a : actions() )
+         out << "action,," << a.receiver.to_string() << ',' << a.account.to_string() << ',' << a.name.to_string() << ",,,"
+             << a.time.count << ',' << a.time.total.count() << ',' << a.time.max.count() << ",,,\n";
+   }
+
+} } // enumivo::chain
@@ -69,10 +69,27 @@ void resource_limits_manager::initialize_account(const account_name& account) {
    });
 }
 
+void resource_limits_manager::reset_cached_objects() {
+   _config = nullptr;
+   _state  = nullptr;
+}
+
+const resource_limits_config_object& resource_limits_manager::get_config()const {
+   if( !_config )
+      _config = &_db.get<resource_limits_config_object>();
+   return *_config;
+}
+
+const resource_limits_state_object& resource_limits_manager::get_state()const {
+   if( !_state )
+      _state = &_db.get<resource_limits_state_object>();
+   return *_state;
+}
+
 void resource_limits_manager::set_block_parameters(const elastic_limit_parameters& cpu_limit_parameters, const elastic_limit_parameters& net_limit_parameters ) {
    cpu_limit_parameters.validate();
    net_limit_parameters.validate();
-   const auto& config = _db.get<resource_limits_config_object>();
+   const auto& config = get_config();
    _db.modify(config, [&](resource_limits_config_object& c){
       c.cpu_limit_parameters = cpu_limit_parameters;
       c.net_limit_parameters = net_limit_parameters;
@@ -80,7 +97,7 @@ void resource_limits_manager::set_block_parameters(const elastic_limit_parameter
 }
 
 void resource_limits_manager::update_account_usage(const flat_set<account_name>& accounts, uint32_t time_slot ) {
-   const auto& config = _db.get<resource_limits_config_object>();
+   const auto& config = get_config();
    for( const auto& a : accounts ) {
       const auto& usage = _db.get<resource_usage_object,by_owner>( a );
       _db.modify( usage, [&]( auto& bu ){
@@ -91,8 +108,8 @@ void resource_limits_manager::update_account_usage(const flat_set<account_name>&
 }
 
 void resource_limits_manager::add_transaction_usage(const flat_set<account_name>& accounts, uint64_t cpu_usage, uint64_t net_usage, uint32_t time_slot ) {
-   const auto& state = _db.get<resource_limits_state_object>();
-   const auto& config = _db.get<resource_limits_config_object>();
+   const auto& state = get_state();
+   const auto& config = get_config();
 
    for( const auto& a : accounts ) {
 
@@ -274,7 +291,7 @@ void resource_limits_manager::process_account_limit_updates() {
       value = pending_value;
    };
 
-   const auto& state = _db.get<resource_limits_state_object>();
+   const auto& state = get_state();
    _db.modify(state, [&](resource_limits_state_object& rso){
       while(!by_owner_index.empty()) {
          const auto& itr = by_owner_index.lower_bound(boost::make_tuple(true));
@@ -295,8 +312,8 @@ void resource_limits_manager::process_account_limit_updates() {
 }
 
 void resource_limits_manager::process_block_usage(uint32_t block_num) {
-   const auto& s = _db.get<resource_limits_state_object>();
-   const auto& config = _db.get<resource_limits_config_object>();
+   const auto& s = get_state();
+   const auto& config = get_config();
    _db.modify(s, [&](resource_limits_state_object& state){
       // apply pending usage, update virtual limits and reset the pending
 
@@ -313,24 +330,24 @@ void resource_limits_manager::process_block_usage(uint32_t block_num) {
 }
 
 uint64_t resource_limits_manager::get_virtual_block_cpu_limit() const {
-   const auto& state = _db.get<resource_limits_state_object>();
+   const auto& state = get_state();
    return state.virtual_cpu_limit;
 }
 
 uint64_t resource_limits_manager::get_virtual_block_net_limit() const {
-   const auto& state = _db.get<resource_limits_state_object>();
+   const auto& state = get_state();
    return state.virtual_net_limit;
 }
 
 uint64_t resource_limits_manager::get_block_cpu_limit() const {
-   const auto& state = _db.get<resource_limits_state_object>();
-   const auto& config = _db.get<resource_limits_config_object>();
+   const auto& state = get_state();
+   const auto& config = get_config();
    return config.cpu_limit_parameters.max - state.pending_cpu_usage;
 }
 
 uint64_t resource_limits_manager::get_block_net_limit() const {
-   const auto& state = _db.get<resource_limits_state_object>();
-   const auto& config = _db.get<resource_limits_config_object>();
+   const auto& state = get_state();
+   const auto& config = get_config();
    return config.net_limit_parameters.max - state.pending_net_usage;
 }
 
@@ -341,9 +358,9 @@ int64_t resource_limits_manager::get_account_cpu_limit( const account_name& name
 
 account_resource_limit resource_limits_manager::get_account_cpu_limit_ex( const account_name& name, bool elastic) const {
 
-   const auto& state = _db.get<resource_limits_state_object>();
+   const auto& state = get_state();
    const auto& usage = _db.get<resource_usage_object, by_owner>(name);
-   const auto& config = _db.get<resource_limits_config_object>();
+   const auto& config = get_config();
 
    int64_t cpu_weight, x, y;
    get_account_limits( name, x, y, cpu_weight );
@@ -379,8 +396,8 @@ int64_t resource_limits_manager::get_account_net_limit( const account_name& name
 }
 
 account_resource_limit resource_limits_manager::get_account_net_limit_ex( const account_name& name, bool elastic) const {
-   const auto& config = _db.get<resource_limits_config_object>();
-   const auto& state  = _db.get<resource_limits_state_object>();
+   const auto& config = get_config();
+   const auto& state  = get_state();
    const auto& usage  = _db.get<resource_usage_object, by_owner>(name);
 
    int64_t net_weight, x, y;
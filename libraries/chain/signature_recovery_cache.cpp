@@ -0,0 +1,151 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#include <enumivo/chain/signature_recovery_cache.hpp>
+#include <enumivo/chain/config.hpp>
+
+#include <boost/functional/hash.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+
+namespace enumivo { namespace chain {
+
+   using namespace boost::multi_index;
+
+   namespace {
+      struct cached_pub_key {
+         signature_type    sig;
+         digest_type       digest;
+         public_key_type   pub_key;
+         size_t            hash;
+      };
+      struct by_hash{};
+
+      typedef multi_index_container<
+         cached_pub_key,
+         indexed_by<
+            sequenced<>,
+            hashed_non_unique<
+               tag<by_hash>,
+               member<cached_pub_key, size_t, &cached_pub_key::hash>
+            >
+         >
+      > recovery_cache_type;
+
+      uint64_t capacity_per_shard( uint64_t capacity, size_t shards ) {
+         return capacity / shards + (capacity % shards ? 1 : 0);
+      }
+   }
+
+   struct signature_recovery_cache::shard {
+      std::mutex           mtx;
+      recovery_cache_type  entries; ///< least recently used first
+
+      recovery_cache_type::index<by_hash>::type::iterator find( const signature_type& sig, const digest_type& digest, size_t hash ) {
+         auto& idx = entries.get<by_hash>();
+         auto range = idx.equal_range( hash );
+         for( auto itr = range.first; itr != range.second; ++itr ) {
+            if( itr->digest == digest && itr->sig == sig )
+               return itr;
+         }
+         return idx.end();
+      }
+   };
+
+   signature_recovery_cache::signature_recovery_cache( uint64_t capacity, uint32_t shard_count )
+   :shard_capacity( capacity_per_shard( capacity, std::max<uint32_t>( shard_count, 1 ) ) )
+   {
+      shards.resize( std::max<uint32_t>( shard_count, 1 ) );
+      for( auto& s : shards )
+         s.reset( new shard() );
+   }
+
+   signature_recovery_cache::~signature_recovery_cache() = default;
+
+   signature_recovery_cache& signature_recovery_cache::instance() {
+      static signature_recovery_cache cache( config::default_signature_recovery_cache_size );
+      return cache;
+   }
+
+   signature_recovery_cache::shard& signature_recovery_cache::shard_for( const signature_type& sig, const digest_type& digest,
+                                                                        size_t& hash )const {
+      hash = boost::hash<signature_type>()( sig );
+      boost::hash_combine( hash, digest._hash[0] );
+      return *shards[hash % shards.size()];
+   }
+
+   optional<public_key_type> signature_recovery_cache::find( const signature_type& sig, const digest_type& digest ) {
+      size_t hash = 0;
+      auto& s = shard_for( sig, digest, hash );
+      std::lock_guard<std::mutex> lock( s.mtx );
+      auto itr = s.find( sig, digest, hash );
+      if( itr == s.entries.get<by_hash>().end() ) {
+         ++misses;
+         return optional<public_key_type>();
+      }
+      ++hits;
+      s.entries.relocate( s.entries.end(), s.entries.project<0>( itr ) );
+      return itr->pub_key;
+   }
+
+   void signature_recovery_cache::insert( const signature_type& sig, const digest_type& digest, const public_key_type& key ) {
+      size_t hash = 0;
+      auto& s = shard_for( sig, digest, hash );
+      std::lock_guard<std::mutex> lock( s.mtx );
+      auto capacity = shard_capacity.load();
+      if( capacity == 0 )
+         return;
+      // another thread may have recovered the same key in the meantime
+      if( s.find( sig, digest, hash ) == s.entries.get<by_hash>().end() )
+         s.entries.push_back( cached_pub_key{ sig, digest, key, hash } );
+      evict( s, capacity );
+   }
+
+   public_key_type signature_recovery_cache::recover( const signature_type& sig, const digest_type& digest ) {
+      if( auto key = find( sig, digest ) )
+         return *key;
+      // recovered outside of the lock so other threads are not held up by it
+      public_key_type key( sig, digest );
+      insert( sig, digest, key );
+      return key;
+   }
+
+   void signature_recovery_cache::evict( shard& s, uint64_t capacity ) {
+      while( s.entries.size() > capacity ) {
+         s.entries.pop_front();
+         ++evictions;
+      }
+   }
+
+   void signature_recovery_cache::set_capacity( uint64_t capacity ) {
+      shard_capacity = capacity_per_shard( capacity, shards.size() );
+      for( auto& s : shards ) {
+         std::lock_guard<std::mutex> lock( s->mtx );
+         evict( *s, shard_capacity );
+      }
+   }
+
+   void signature_recovery_cache::clear() {
+      for( auto& s : shards ) {
+         std::lock_guard<std::mutex> lock( s->mtx );
+         s->entries.clear();
+      }
+   }
+
+   signature_recovery_cache::metrics signature_recovery_cache::get_metrics()const {
+      metrics m;
+      m.hits      = hits;
+      m.misses    = misses;
+      m.evictions = evictions;
+      m.capacity  = shard_capacity * shards.size();
+      for( auto& s : shards ) {
+         std::lock_guard<std::mutex> lock( s->mtx );
+         m.size += s->entries.size();
+      }
+      return m;
+   }
+
+} } // enumivo::chain
@@ -0,0 +1,591 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#include <enumivo/chain/snapshot.hpp>
+#include <enumivo/chain/exceptions.hpp>
+
+#include <enumivo/chain/account_object.hpp>
+#include <enumivo/chain/block_summary_object.hpp>
+#include <enumivo/chain/feature_activation_object.hpp>
+#include <enumivo/chain/global_property_object.hpp>
+#include <enumivo/chain/contract_table_objects.hpp>
+#include <enumivo/chain/generated_transaction_object.hpp>
+#include <enumivo/chain/transaction_object.hpp>
+#include <enumivo/chain/permission_object.hpp>
+#include <enumivo/chain/permission_link_object.hpp>
+#include <enumivo/chain/resource_limits.hpp>
+#include <enumivo/chain/resource_limits_private.hpp>
+
+#include <fstream>
+
+namespace enumivo { namespace chain { namespace detail {
+
+   using namespace resource_limits;
+
+   struct account_row {
+      account_name         name;
+      uint8_t              vm_type      = 0;
+      uint8_t              vm_version   = 0;
+      bool                 privileged   = false;
+      time_point           last_code_update;
+      digest_type          code_version;
+      block_timestamp_type creation_date;
+      bytes                code;
+      bytes                abi;
+   };
+
+   struct account_sequence_row {
+      account_name name;
+      uint64_t     recv_sequence = 0;
+      uint64_t     auth_sequence = 0;
+      uint64_t     code_sequence = 0;
+      uint64_t     abi_sequence  = 0;
+   };
+
+   struct table_id_row {
+      int64_t        id = 0;
+      account_name   code;
+      scope_name     scope;
+      table_name     table;
+      account_name   payer;
+      uint32_t       count = 0;
+   };
+
+   struct key_value_row {
+      int64_t        t_id = 0;
+      uint64_t       primary_key = 0;
+      account_name   payer;
+      bytes          value;
+   };
+
+   /// secondary keys are stored as integers: softfloat keys by their bit pattern, 256 bit keys as a pair of halves
+   template<typename Key>
+   struct secondary_index_row {
+      int64_t        t_id = 0;
+      uint64_t       primary_key = 0;
+      account_name   payer;
+      Key            secondary_key = Key();
+   };
+
+   struct global_property_row {
+      optional<block_num_type>   proposed_schedule_block_num;
+      producer_schedule_type     proposed_schedule;
+      chain_config               configuration;
+   };
+
+   struct dynamic_global_property_row {
+      uint64_t   global_action_sequence = 0;
+   };
+
+   struct block_summary_row {
+      block_id_type  block_id;
+   };
+
+   struct feature_activation_row {
+      name             feature;
+      block_num_type   activation_block_num = 0;
+   };
+
+   struct transaction_row {
+      time_point_sec      expiration;
+      transaction_id_type trx_id;
+   };
+
+   struct generated_transaction_row {
+      transaction_id_type  trx_id;
+      account_name         sender;
+      uint128_t            sender_id = 0;
+      account_name         payer;
+      time_point           delay_until;
+      time_point           expiration;
+      time_point           published;
+      bytes                packed_trx;
+   };
+
+   struct permission_usage_row {
+      int64_t     id = 0;
+      time_point  last_used;
+   };
+
+   struct permission_row {
+      int64_t           id = 0;
+      int64_t           usage_id = 0;
+      int64_t           parent = 0;
+      account_name      owner;
+      permission_name   name;
+      time_point        last_updated;
+      authority         auth;
+   };
+
+   struct permission_link_row {
+      account_name      account;
+      account_name      code;
+      action_name       message_type;
+      permission_name   required_permission;
+   };
+
+   struct resource_limits_row {
+      account_name   owner;
+      bool           pending = false;
+      int64_t        net_weight = -1;
+      int64_t        cpu_weight = -1;
+      int64_t        ram_bytes = -1;
+   };
+
+   struct resource_usage_row {
+      account_name        owner;
+      usage_accumulator   net_usage;
+      usage_accumulator   cpu_usage;
+      uint64_t            ram_usage = 0;
+   };
+
+   struct resource_limits_config_row {
+      elastic_limit_parameters   cpu_limit_parameters;
+      elastic_limit_parameters   net_limit_parameters;
+      uint32_t                   account_cpu_usage_average_window = 0;
+      uint32_t                   account_net_usage_average_window = 0;
+   };
+
+   struct resource_limits_state_row {
+      usage_accumulator   average_block_net_usage;
+      usage_accumulator   average_block_cpu_usage;
+      uint64_t            pending_net_usage = 0;
+      uint64_t            pending_cpu_usage = 0;
+      uint64_t            total_net_weight = 0;
+      uint64_t            total_cpu_weight = 0;
+      uint64_t            total_ram_bytes = 0;
+      uint64_t            virtual_net_limit = 0;
+      uint64_t            virtual_cpu_limit = 0;
+   };
+
+} } } // enumivo::chain::detail
+
+FC_REFLECT( enumivo::chain::detail::account_row,
+            (name)(vm_type)(vm_version)(privileged)(last_code_update)(code_version)(creation_date)(code)(abi) )
+FC_REFLECT( enumivo::chain::detail::account_sequence_row, (name)(recv_sequence)(auth_sequence)(code_sequence)(abi_sequence) )
+FC_REFLECT( enumivo::chain::detail::table_id_row, (id)(code)(scope)(table)(payer)(count) )
+FC_REFLECT( enumivo::chain::detail::key_value_row, (t_id)(primary_key)(payer)(value) )
+FC_REFLECT_TEMPLATE( (typename Key), enumivo::chain::detail::secondary_index_row<Key>, (t_id)(primary_key)(payer)(secondary_key) )
+FC_REFLECT( enumivo::chain::detail::global_property_row, (proposed_schedule_block_num)(proposed_schedule)(configuration) )
+FC_REFLECT( enumivo::chain::detail::dynamic_global_property_row, (global_action_sequence) )
+FC_REFLECT( enumivo::chain::detail::block_summary_row, (block_id) )
+FC_REFLECT( enumivo::chain::detail::feature_activation_row, (feature)(activation_block_num) )
+FC_REFLECT( enumivo::chain::detail::transaction_row, (expiration)(trx_id) )
+FC_REFLECT( enumivo::chain::detail::generated_transaction_row,
+            (trx_id)(sender)(sender_id)(payer)(delay_until)(expiration)(published)(packed_trx) )
+FC_REFLECT( enumivo::chain::detail::permission_usage_row, (id)(last_used) )
+FC_REFLECT( enumivo::chain::detail::permission_row, (id)(usage_id)(parent)(owner)(name)(last_updated)(auth) )
+FC_REFLECT( enumivo::chain::detail::permission_link_row, (account)(code)(message_type)(required_permission) )
+FC_REFLECT( enumivo::chain::detail::resource_limits_row, (owner)(pending)(net_weight)(cpu_weight)(ram_bytes) )
+FC_REFLECT( enumivo::chain::detail::resource_usage_row, (owner)(net_usage)(cpu_usage)(ram_usage) )
+FC_REFLECT( enumivo::chain::detail::resource_limits_config_row,
+            (cpu_limit_parameters)(net_limit_parameters)(account_cpu_usage_average_window)(account_net_usage_average_window) )
+FC_REFLECT( enumivo::chain::detail::resource_limits_state_row,
+            (average_block_net_usage)(average_block_cpu_usage)(pending_net_usage)(pending_cpu_usage)
+            (total_net_weight)(total_cpu_weight)(total_ram_bytes)(virtual_net_limit)(virtual_cpu_limit) )
+
+namespace enumivo { namespace chain {
+
+   const uint32_t snapshot::magic             = 0x30510550;
+   const uint32_t snapshot::supported_version = 1;
+
+   namespace detail {
+
+      using key256_row   = std::pair<uint128_t,uint128_t>;
+      using float128_row = std::pair<uint64_t,uint64_t>;
+
+      inline uint64_t     to_row_key( uint64_t k )          { return k; }
+      inline uint128_t    to_row_key( const uint128_t& k )  { return k; }
+      inline key256_row   to_row_key( const key256_t& k )   { return key256_row( k[0], k[1] ); }
+      inline uint64_t     to_row_key( const float64_t& k )  { return k.v; }
+      inline float128_row to_row_key( const float128_t& k ) { return float128_row( k.v[0], k.v[1] ); }
+
+      inline void from_row_key( uint64_t r, uint64_t& k )               { k = r; }
+      inline void from_row_key( const uint128_t& r, uint128_t& k )      { k = r; }
+      inline void from_row_key( const key256_row& r, key256_t& k )      { k[0] = r.first; k[1] = r.second; }
+      inline void from_row_key( uint64_t r, float64_t& k )              { k.v = r; }
+      inline void from_row_key( const float128_row& r, float128_t& k )  { k.v[0] = r.first; k.v[1] = r.second; }
+
+      template<typename Object>
+      using row_key_type = decltype( to_row_key( std::declval<typename Object::secondary_key_type>() ) );
+
+      inline bytes to_bytes( const shared_string& s ) {
+         return bytes( s.begin(), s.end() );
+      }
+
+      /**
+       * Maps the ids rows had when the snapshot was written to the ids they are given when it is read. Rows are
+       * inserted in the order of their original ids, so the new id of a row is its position in that order.
+       */
+      class id_map {
+         public:
+            void add( int64_t old_id ) {
+               ENU_ASSERT( old_ids.empty() || old_ids.back() < old_id, snapshot_validation_exception,
+                           "rows of a snapshot section are not in the order of their ids" );
+               old_ids.push_back( old_id );
+            }
+
+            int64_t operator()( int64_t old_id )const {
+               auto itr = std::lower_bound( old_ids.begin(), old_ids.end(), old_id );
+               ENU_ASSERT( itr != old_ids.end() && *itr == old_id, snapshot_validation_exception,
+                           "snapshot refers to a missing row ${id}", ("id", old_id) );
+               return itr - old_ids.begin();
+            }
+
+         private:
+            vector<int64_t> old_ids;
+      };
+
+      template<typename Index, typename ToRow>
+      void write_section( std::ostream& out, const chainbase::database& db, const char* name, ToRow&& to_row ) {
+         const auto& idx = db.get_index<Index, by_id>();
+         fc::raw::pack( out, string( name ) );
+         fc::raw::pack( out, uint64_t( idx.size() ) );
+         for( const auto& o : idx )
+            fc::raw::pack( out, to_row( o ) );
+      }
+
+      template<typename Row, typename FromRow>
+      void read_section( std::istream& in, const char* name, FromRow&& from_row ) {
+         string section;
+         fc::raw::unpack( in, section );
+         ENU_ASSERT( section == name, snapshot_validation_exception,
+                     "expected section ${expected} in snapshot but found ${found}", ("expected", name)("found", section) );
+         uint64_t count = 0;
+         fc::raw::unpack( in, count );
+         for( uint64_t i = 0; i < count; ++i ) {
+            Row row;
+            fc::raw::unpack( in, row );
+            from_row( row );
+         }
+      }
+
+      template<typename Index>
+      void write_secondary_section( std::ostream& out, const chainbase::database& db, const char* name ) {
+         using object_type = typename Index::value_type;
+         write_section<Index>( out, db, name, []( const object_type& o ) {
+            secondary_index_row<row_key_type<object_type>> row;
+            row.t_id          = o.t_id._id;
+            row.primary_key   = o.primary_key;
+            row.payer         = o.payer;
+            row.secondary_key = to_row_key( o.secondary_key );
+            return row;
+         });
+      }
+
+      template<typename Index>
+      void read_secondary_section( std::istream& in, chainbase::database& db, const char* name, const id_map& table_ids ) {
+         using object_type = typename Index::value_type;
+         using row_type    = secondary_index_row<row_key_type<object_type>>;
+         read_section<row_type>( in, name, [&]( const row_type& row ) {
+            db.create<object_type>( [&]( auto& o ) {
+               o.t_id        = table_id( table_ids( row.t_id ) );
+               o.primary_key = row.primary_key;
+               o.payer       = row.payer;
+               from_row_key( row.secondary_key, o.secondary_key );
+            });
+         });
+      }
+
+      void check_header( std::istream& in ) {
+         uint32_t file_magic = 0;
+         uint32_t version = 0;
+         fc::raw::unpack( in, file_magic );
+         ENU_ASSERT( file_magic == snapshot::magic, snapshot_validation_exception, "file is not a snapshot" );
+         fc::raw::unpack( in, version );
+         ENU_ASSERT( version == snapshot::supported_version, snapshot_validation_exception,
+                     "unsupported snapshot version ${version}, this node supports version ${supported}",
+                     ("version", version)("supported", snapshot::supported_version) );
+      }
+
+      void open_snapshot( std::ifstream& in, const fc::path& file ) {
+         ENU_ASSERT( fc::is_regular_file( file ), snapshot_exception, "snapshot '${file}' does not exist",
+                     ("file", file.generic_string()) );
+         in.exceptions( std::ifstream::failbit | std::ifstream::badbit );
+         in.open( file.generic_string().c_str(), std::ios::in | std::ios::binary );
+      }
+
+   } // namespace detail
+
+   using namespace detail;
+   using namespace resource_limits;
+
+   void snapshot::write( const fc::path& file, const chainbase::database& db, const genesis_state& gs, const block_state& head ) {
+      try {
+         ENU_ASSERT( head.block, snapshot_exception, "the head block of a snapshot is required" );
+
+         fc::path tmp_file = file.generic_string() + ".tmp";
+         std::ofstream out;
+         out.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+         out.open( tmp_file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+
+         fc::raw::pack( out, magic );
+         fc::raw::pack( out, supported_version );
+         fc::raw::pack( out, gs );
+         fc::raw::pack( out, static_cast<const block_header_state&>( head ) );
+         fc::raw::pack( out, *head.block );
+
+         write_section<account_index>( out, db, "account", []( const account_object& o ) {
+            return account_row{ o.name, o.vm_type, o.vm_version, o.privileged, o.last_code_update, o.code_version,
+                                o.creation_date, to_bytes( o.code ), to_bytes( o.abi ) };
+         });
+         write_section<account_sequence_index>( out, db, "account_sequence", []( const account_sequence_object& o ) {
+            return account_sequence_row{ o.name, o.recv_sequence, o.auth_sequence, o.code_sequence, o.abi_sequence };
+         });
+
+         write_section<table_id_multi_index>( out, db, "table_id", []( const table_id_object& o ) {
+            return table_id_row{ o.id._id, o.code, o.scope, o.table, o.payer, o.count };
+         });
+         write_section<key_value_index>( out, db, "key_value", []( const key_value_object& o ) {
+            return key_value_row{ o.t_id._id, o.primary_key, o.payer, to_bytes( o.value ) };
+         });
+         write_secondary_section<index64_index>( out, db, "index64" );
+         write_secondary_section<index128_index>( out, db, "index128" );
+         write_secondary_section<index256_index>( out, db, "index256" );
+         write_secondary_section<index_double_index>( out, db, "index_double" );
+         write_secondary_section<index_long_double_index>( out, db, "index_long_double" );
+
+         write_section<global_property_multi_index>( out, db, "global_property", []( const global_property_object& o ) {
+            return global_property_row{ o.proposed_schedule_block_num, producer_schedule_type( o.proposed_schedule ), o.configuration };
+         });
+         write_section<dynamic_global_property_multi_index>( out, db, "dynamic_global_property", []( const dynamic_global_property_object& o ) {
+            return dynamic_global_property_row{ o.global_action_sequence };
+         });
+         write_section<block_summary_multi_index>( out, db, "block_summary", []( const block_summary_object& o ) {
+            return block_summary_row{ o.block_id };
+         });
+         write_section<feature_activation_multi_index>( out, db, "feature_activation", []( const feature_activation_object& o ) {
+            return feature_activation_row{ o.feature, o.activation_block_num };
+         });
+         write_section<transaction_multi_index>( out, db, "transaction", []( const transaction_object& o ) {
+            return transaction_row{ o.expiration, o.trx_id };
+         });
+         write_section<generated_transaction_multi_index>( out, db, "generated_transaction", []( const generated_transaction_object& o ) {
+            return generated_transaction_row{ o.trx_id, o.sender, o.sender_id, o.payer, o.delay_until, o.expiration, o.published,
+                                              to_bytes( o.packed_trx ) };
+         });
+
+         write_section<permission_usage_index>( out, db, "permission_usage", []( const permission_usage_object& o ) {
+            return permission_usage_row{ o.id._id, o.last_used };
+         });
+         write_section<permission_index>( out, db, "permission", []( const permission_object& o ) {
+            return permission_row{ o.id._id, o.usage_id._id, o.parent._id, o.owner, o.name, o.last_updated, o.auth.to_authority() };
+         });
+         write_section<permission_link_index>( out, db, "permission_link", []( const permission_link_object& o ) {
+            return permission_link_row{ o.account, o.code, o.message_type, o.required_permission };
+         });
+
+         write_section<resource_limits_index>( out, db, "resource_limits", []( const resource_limits_object& o ) {
+            return resource_limits_row{ o.owner, o.pending, o.net_weight, o.cpu_weight, o.ram_bytes };
+         });
+         write_section<resource_usage_index>( out, db, "resource_usage", []( const resource_usage_object& o ) {
+            return resource_usage_row{ o.owner, o.net_usage, o.cpu_usage, o.ram_usage };
+         });
+         write_section<resource_limits_config_index>( out, db, "resource_limits_config", []( const resource_limits_config_object& o ) {
+            return resource_limits_config_row{ o.cpu_limit_parameters, o.net_limit_parameters,
+                                               o.account_cpu_usage_average_window, o.account_net_usage_average_window };
+         });
+         write_section<resource_limits_state_index>( out, db, "resource_limits_state", []( const resource_limits_state_object& o ) {
+            return resource_limits_state_row{ o.average_block_net_usage, o.average_block_cpu_usage,
+                                              o.pending_net_usage, o.pending_cpu_usage,
+                                              o.total_net_weight, o.total_cpu_weight, o.total_ram_bytes,
+                                              o.virtual_net_limit, o.virtual_cpu_limit };
+         });
+
+         out.close();
+         fc::rename( tmp_file, file );
+      }
+      FC_LOG_AND_RETHROW()
+   }
+
+   snapshot_header snapshot::read_header( const fc::path& file ) {
+      std::ifstream in;
+      open_snapshot( in, file );
+      check_header( in );
+      snapshot_header header;
+      fc::raw::unpack( in, header );
+      return header;
+   }
+
+   snapshot_header snapshot::read( const fc::path& file, chainbase::database& db ) {
+      try {
+         std::ifstream in;
+         open_snapshot( in, file );
+         check_header( in );
+         snapshot_header header;
+         fc::raw::unpack( in, header );
+         ENU_ASSERT( header.head_block.id() == header.head.id, snapshot_validation_exception,
+                     "head block of the snapshot does not match its block header state" );
+
+         ENU_ASSERT( db.get_index<account_index>().indices().empty(), snapshot_exception,
+                     "a snapshot can only be read into an empty database" );
+
+         read_section<account_row>( in, "account", [&]( const account_row& row ) {
+            db.create<account_object>( [&]( auto& a ) {
+               a.name             = row.name;
+               a.vm_type          = row.vm_type;
+               a.vm_version       = row.vm_version;
+               a.privileged       = row.privileged;
+               a.last_code_update = row.last_code_update;
+               a.code_version     = row.code_version;
+               a.creation_date    = row.creation_date;
+               a.code.assign( row.code.data(), row.code.size() );
+               a.abi.assign( row.abi.data(), row.abi.size() );
+            });
+         });
+         read_section<account_sequence_row>( in, "account_sequence", [&]( const account_sequence_row& row ) {
+            db.create<account_sequence_object>( [&]( auto& a ) {
+               a.name          = row.name;
+               a.recv_sequence = row.recv_sequence;
+               a.auth_sequence = row.auth_sequence;
+               a.code_sequence = row.code_sequence;
+               a.abi_sequence  = row.abi_sequence;
+            });
+         });
+
+         id_map table_ids;
+         read_section<table_id_row>( in, "table_id", [&]( const table_id_row& row ) {
+            table_ids.add( row.id );
+            db.create<table_id_object>( [&]( auto& t ) {
+               t.code  = row.code;
+               t.scope = row.scope;
+               t.table = row.table;
+               t.payer = row.payer;
+               t.count = row.count;
+            });
+         });
+         read_section<key_value_row>( in, "key_value", [&]( const key_value_row& row ) {
+            db.create<key_value_object>( [&]( auto& kv ) {
+               kv.t_id        = table_id( table_ids( row.t_id ) );
+               kv.primary_key = row.primary_key;
+               kv.payer       = row.payer;
+               kv.value.assign( row.value.data(), row.value.size() );
+            });
+         });
+         read_secondary_section<index64_index>( in, db, "index64", table_ids );
+         read_secondary_section<index128_index>( in, db, "index128", table_ids );
+         read_secondary_section<index256_index>( in, db, "index256", table_ids );
+         read_secondary_section<index_double_index>( in, db, "index_double", table_ids );
+         read_secondary_section<index_long_double_index>( in, db, "index_long_double", table_ids );
+
+         read_section<global_property_row>( in, "global_property", [&]( const global_property_row& row ) {
+            db.create<global_property_object>( [&]( auto& gpo ) {
+               gpo.proposed_schedule_block_num = row.proposed_schedule_block_num;
+               gpo.proposed_schedule           = row.proposed_schedule;
+               gpo.configuration               = row.configuration;
+            });
+         });
+         read_section<dynamic_global_property_row>( in, "dynamic_global_property", [&]( const dynamic_global_property_row& row ) {
+            db.create<dynamic_global_property_object>( [&]( auto& dgpo ) {
+               dgpo.global_action_sequence = row.global_action_sequence;
+            });
+         });
+         read_section<block_summary_row>( in, "block_summary", [&]( const block_summary_row& row ) {
+            db.create<block_summary_object>( [&]( auto& bs ) {
+               bs.block_id = row.block_id;
+            });
+         });
+         read_section<feature_activation_row>( in, "feature_activation", [&]( const feature_activation_row& row ) {
+            db.create<feature_activation_object>( [&]( auto& f ) {
+               f.feature              = row.feature;
+               f.activation_block_num = row.activation_block_num;
+            });
+         });
+         read_section<transaction_row>( in, "transaction", [&]( const transaction_row& row ) {
+            db.create<transaction_object>( [&]( auto& t ) {
+               t.expiration = row.expiration;
+               t.trx_id     = row.trx_id;
+            });
+         });
+         read_section<generated_transaction_row>( in, "generated_transaction", [&]( const generated_transaction_row& row ) {
+            db.create<generated_transaction_object>( [&]( auto& gto ) {
+               gto.trx_id      = row.trx_id;
+               gto.sender      = row.sender;
+               gto.sender_id   = row.sender_id;
+               gto.payer       = row.payer;
+               gto.delay_until = row.delay_until;
+               gto.expiration  = row.expiration;
+               gto.published   = row.published;
+               gto.packed_trx.assign( row.packed_trx.data(), row.packed_trx.size() );
+            });
+         });
+
+         id_map usage_ids;
+         read_section<permission_usage_row>( in, "permission_usage", [&]( const permission_usage_row& row ) {
+            usage_ids.add( row.id );
+            db.create<permission_usage_object>( [&]( auto& u ) {
+               u.last_used = row.last_used;
+            });
+         });
+         // a parent may refer to any permission of the section, so all of its ids are needed before the first insert
+         vector<permission_row> permissions;
+         id_map permission_ids;
+         read_section<permission_row>( in, "permission", [&]( const permission_row& row ) {
+            permission_ids.add( row.id );
+            permissions.push_back( row );
+         });
+         for( const auto& row : permissions ) {
+            db.create<permission_object>( [&]( auto& p ) {
+               p.usage_id     = permission_usage_object::id_type( usage_ids( row.usage_id ) );
+               p.parent       = permission_object::id_type( permission_ids( row.parent ) );
+               p.owner        = row.owner;
+               p.name         = row.name;
+               p.last_updated = row.last_updated;
+               p.auth         = row.auth;
+            });
+         }
+         read_section<permission_link_row>( in, "permission_link", [&]( const permission_link_row& row ) {
+            db.create<permission_link_object>( [&]( auto& link ) {
+               link.account             = row.account;
+               link.code                = row.code;
+               link.message_type        = row.message_type;
+               link.required_permission = row.required_permission;
+            });
+         });
+
+         read_section<resource_limits_row>( in, "resource_limits", [&]( const resource_limits_row& row ) {
+            db.create<resource_limits_object>( [&]( auto& rlo ) {
+               rlo.owner      = row.owner;
+               rlo.pending    = row.pending;
+               rlo.net_weight = row.net_weight;
+               rlo.cpu_weight = row.cpu_weight;
+               rlo.ram_bytes  = row.ram_bytes;
+            });
+         });
+         read_section<resource_usage_row>( in, "resource_usage", [&]( const resource_usage_row& row ) {
+            db.create<resource_usage_object>( [&]( auto& ruo ) {
+               ruo.owner     = row.owner;
+               ruo.net_usage = row.net_usage;
+               ruo.cpu_usage = row.cpu_usage;
+               ruo.ram_usage = row.ram_usage;
+            });
+         });
+         read_section<resource_limits_config_row>( in, "resource_limits_config", [&]( const resource_limits_config_row& row ) {
+            db.create<resource_limits_config_object>( [&]( auto& config ) {
+               config.cpu_limit_parameters             = row.cpu_limit_parameters;
+               config.net_limit_parameters             = row.net_limit_parameters;
+               config.account_cpu_usage_average_window = row.account_cpu_usage_average_window;
+               config.account_net_usage_average_window = row.account_net_usage_average_window;
+            });
+         });
+         read_section<resource_limits_state_row>( in, "resource_limits_state", [&]( const resource_limits_state_row& row ) {
+            db.create<resource_limits_state_object>( [&]( auto& state ) {
+               state.average_block_net_usage = row.average_block_net_usage;
+               state.average_block_cpu_usage = row.average_block_cpu_usage;
+               state.pending_net_usage       = row.pending_net_usage;
+               state.pending_cpu_usage       = row.pending_cpu_usage;
+               state.total_net_weight        = row.total_net_weight;
+               state.total_cpu_weight        = row.total_cpu_weight;
+               state.total_ram_bytes         = row.total_ram_bytes;
+               state.virtual_net_limit       = row.virtual_net_limit;
+               state.virtual_cpu_limit       = row.virtual_cpu_limit;
+            });
+         });
+
+         return header;
+      }
+      FC_LOG_AND_RETHROW()
+   }
+
+} } // enumivo::chain
@@ -0,0 +1,73 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#include <enumivo/chain/transaction_conflicts.hpp>
+
+namespace enumivo { namespace chain {
+
+   namespace {
+      void add_declared( flat_set<account_name>& accounts, const action& act ) {
+         accounts.insert( act.account );
+         for( const auto& auth : act.authorization )
+            accounts.insert( auth.actor );
+      }
+
+      void add_touched( flat_set<account_name>& accounts, const action_trace& trace ) {
+         accounts.insert( trace.receipt.receiver );
+         add_declared( accounts, trace.act );
+         for( const auto& inline_trace : trace.inline_traces )
+            add_touched( accounts, inline_trace );
+      }
+
+      /// union-find over transactions, the root of a set being its first transaction
+      uint32_t find_root( vector<uint32_t>& parents, uint32_t i ) {
+         while( parents[i] != i ) {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+         }
+         return i;
+      }
+   }
+
+   flat_set<account_name> declared_accounts( const transaction_trace& trace ) {
+      flat_set<account_name> accounts;
+      for( const auto& at : trace.action_traces )
+         add_declared( accounts, at.act );
+      return accounts;
+   }
+
+   flat_set<account_name> touched_accounts( const transaction_trace& trace ) {
+      flat_set<account_name> accounts;
+      for( const auto& at : trace.action_traces )
+         add_touched( accounts, at );
+      return accounts;
+   }
+
+   vector<uint32_t> conflict_groups( const vector<flat_set<account_name>>& accounts ) {
+      vector<uint32_t> parents( accounts.size() );
+      map<account_name, uint32_t> first_toucher;
+      for( uint32_t i = 0; i < accounts.size(); ++i ) {
+         parents[i] = i;
+         for( const auto& a : accounts[i] ) {
+            auto itr = first_toucher.emplace( a, i ).first;
+            auto root = find_root( parents, itr->second );
+            auto own_root = find_root( parents, i );
+            // the earlier transaction stays the root so groups are numbered by their first transaction
+            if( root < own_root )
+               parents[own_root] = root;
+            else if( own_root < root )
+               parents[root] = own_root;
+         }
+      }
+
+      vector<uint32_t> groups( accounts.size() );
+      map<uint32_t, uint32_t> group_of_root;
+      for( uint32_t i = 0; i < accounts.size(); ++i ) {
+         auto root = find_root( parents, i );
+         groups[i] = group_of_root.emplace( root, group_of_root.size() ).first->second;
+      }
+      return groups;
+   }
+
+} } // enumivo::chain
@@ -209,6 +209,8 @@ namespace enumivo { namespace chain {
          }
       }
 
+      apply_pending_ram_usage();
+
       auto& rl = control.get_mutable_resource_limits_manager();
       for( auto a : validate_ram_usage ) {
          rl.verify_account_ram_usage( a );
@@ -347,13 +349,20 @@ namespace enumivo { namespace chain {
    }
 
    void transaction_context::add_ram_usage( account_name account, int64_t ram_delta ) {
-      auto& rl = control.get_mutable_resource_limits_manager();
-      rl.add_pending_ram_usage( account, ram_delta );
+      pending_ram_usage[account] += ram_delta;
       if( ram_delta > 0 ) {
          validate_ram_usage.insert( account );
       }
    }
 
+   void transaction_context::apply_pending_ram_usage() {
+      auto& rl = control.get_mutable_resource_limits_manager();
+      for( const auto& p : pending_ram_usage ) {
+         rl.add_pending_ram_usage( p.first, p.second );
+      }
+      pending_ram_usage.clear();
+   }
+
    uint32_t transaction_context::update_billed_cpu_time( fc::time_point now ) {
       if( explicit_billed_cpu_time ) return static_cast<uint32_t>(billed_cpu_time_us);
 
@@ -0,0 +1,126 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#include <enumivo/chain/wasm_instantiation_cache.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+
+namespace enumivo { namespace chain {
+
+   using namespace boost::multi_index;
+
+   namespace {
+      struct cached_module {
+         digest_type                                                   code_id;
+         std::shared_ptr<wasm_instantiated_module_interface>           module;
+         uint64_t                                                      memory = 0;
+      };
+      struct by_code_id{};
+   }
+
+   struct wasm_instantiation_cache::entries {
+      typedef multi_index_container<
+         cached_module,
+         indexed_by<
+            sequenced<>,
+            hashed_unique<
+               tag<by_code_id>,
+               member<cached_module, digest_type, &cached_module::code_id>,
+               std::hash<digest_type>
+            >
+         >
+      > container_type;
+
+      container_type modules; ///< least recently used first
+   };
+
+   wasm_instantiation_cache::wasm_instantiation_cache( uint64_t capacity, std::function<void()> released )
+   :_entries( new entries() )
+   ,_released( std::move( released ) )
+   ,_capacity( capacity )
+   {}
+
+   wasm_instantiation_cache::~wasm_instantiation_cache() = default;
+
+   wasm_instantiated_module_interface* wasm_instantiation_cache::find( const digest_type& code_id ) {
+      auto& idx = _entries->modules.get<by_code_id>();
+      auto itr = idx.find( code_id );
+      if( itr == idx.end() ) {
+         ++_misses;
+         return nullptr;
+      }
+      ++_hits;
+      _entries->modules.relocate( _entries->modules.end(), _entries->modules.project<0>( itr ) );
+      return itr->module.get();
+   }
+
+   bool wasm_instantiation_cache::contains( const digest_type& code_id )const {
+      return _entries->modules.get<by_code_id>().count( code_id ) > 0;
+   }
+
+   wasm_instantiated_module_interface& wasm_instantiation_cache::insert( const digest_type& code_id,
+                                                                         std::unique_ptr<wasm_instantiated_module_interface> module ) {
+      bool released = false;
+      auto& idx = _entries->modules.get<by_code_id>();
+      auto existing = idx.find( code_id );
+      if( existing != idx.end() ) {
+         _memory -= existing->memory;
+         idx.erase( existing );
+         released = true;
+      }
+
+      auto memory = module->memory_usage();
+      auto& inserted = *module;
+      _entries->modules.push_back( cached_module{ code_id, std::shared_ptr<wasm_instantiated_module_interface>( std::move( module ) ), memory } );
+      _memory += memory;
+
+      // the module just inserted is about to be used, so it is kept even if it alone exceeds the capacity
+      released |= evict( _capacity, 1 );
+      if( released && _released )
+         _released();
+
+      return inserted;
+   }
+
+   bool wasm_instantiation_cache::evict( uint64_t capacity, size_t keep ) {
+      bool evicted = false;
+      while( _entries->modules.size() > keep && _memory > capacity ) {
+         _memory -= _entries->modules.front().memory;
+         _entries->modules.pop_front();
+         ++_evictions;
+         evicted = true;
+      }
+      return evicted;
+   }
+
+   void wasm_instantiation_cache::set_capacity( uint64_t capacity ) {
+      _capacity = capacity;
+      if( evict( capacity, 0 ) && _released )
+         _released();
+   }
+
+   void wasm_instantiation_cache::clear() {
+      if( _entries->modules.empty() )
+         return;
+      _entries->modules.clear();
+      _memory = 0;
+      if( _released )
+         _released();
+   }
+
+   wasm_instantiation_cache::metrics wasm_instantiation_cache::get_metrics()const {
+      metrics m;
+      m.hits      = _hits;
+      m.misses    = _misses;
+      m.evictions = _evictions;
+      m.size      = _entries->modules.size();
+      m.memory    = _memory;
+      m.capacity  = _capacity;
+      return m;
+   }
+
+} } // enumivo::chain
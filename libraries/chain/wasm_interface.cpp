@@ -27,7 +27,8 @@ namespace enumivo { namespace chain {
    using namespace webassembly;
    using namespace webassembly::common;
 
-   wasm_interface::wasm_interface(vm_type vm) : my( new wasm_interface_impl(vm) ) {}
+   wasm_interface::wasm_interface(vm_type vm, const fc::path& module_cache_dir, uint64_t instantiation_cache_size, uint32_t compile_threads)
+   : my( new wasm_interface_impl(vm, module_cache_dir, instantiation_cache_size, compile_threads) ) {}
 
    wasm_interface::~wasm_interface() {}
 
@@ -42,19 +43,44 @@ namespace enumivo { namespace chain {
          ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
       }
 
-      wasm_validations::wasm_binary_validation validator(control, module);
-      validator.validate();
+      {
+         std::lock_guard<std::mutex> lock(wasm_interface_impl::injection_mutex());
+         wasm_validations::wasm_binary_validation validator(control, module);
+         validator.validate();
+      }
+
+      // the batched table intrinsics are part of the consensus import set only once the chain activated them
+      if( !control.is_feature_active( config::batch_db_feature_name ) ) {
+         for( const auto& import : module.functions.imports ) {
+            ENU_ASSERT( import.exportName != "db_get_batch_i64" && import.exportName != "db_store_batch_i64" &&
+                        import.exportName != "db_update_batch_i64", wasm_exception,
+                        "${name} is not available until feature ${feature} is active",
+                        ("name", import.exportName)("feature", name( config::batch_db_feature_name )) );
+         }
+      }
 
       root_resolver resolver(true);
       LinkResult link_result = linkModule(module, resolver);
 
-      //there are a couple opportunties for improvement here--
+      //there is an opportunity for improvement here--
       //Easy: Cache the Module created here so it can be reused for instantiaion
-      //Hard: Kick off instantiation in a separate thread at this location
+      //instantiation is kicked off in the background by precompile() once the code is set
 	 }
 
    void wasm_interface::apply( const digest_type& code_id, const shared_string& code, apply_context& context ) {
-      my->get_instantiated_module(code_id, code, context.trx_context)->apply(context);
+      my->get_instantiated_module(code_id, code, context.trx_context).apply(context);
+   }
+
+   void wasm_interface::precompile( const digest_type& code_id, const shared_string& code ) {
+      my->precompile(code_id, code);
+   }
+
+   void wasm_interface::wait_for_compiles() {
+      my->wait_for_compiles();
+   }
+
+   wasm_instantiation_cache::metrics wasm_interface::get_instantiation_cache_metrics()const {
+      return my->instantiation_cache.get_metrics();
    }
 
    wasm_instantiated_module_interface::~wasm_instantiated_module_interface() {}
@@ -111,7 +137,7 @@ class privileged_api : public context_aware_api {
        * irreversiblity only by block headers not by BFT short-cut.
        */
       int is_feature_active( int64_t feature_name ) {
-         return false;
+         return context.control.is_feature_active( name( feature_name ) );
       }
 
       /**
@@ -122,7 +148,7 @@ class privileged_api : public context_aware_api {
        *  Feature name should be base32 encoded name.
        */
       void activate_feature( int64_t feature_name ) {
-         ENU_ASSERT( false, unsupported_feature, "Unsupported Hardfork Detected" );
+         context.control.activate_feature( name( feature_name ) );
       }
 
       /**
@@ -1263,6 +1289,15 @@ class database_api : public context_aware_api {
       int db_end_i64( uint64_t code, uint64_t scope, uint64_t table ) {
          return context.db_end_i64( code, scope, table );
       }
+      int db_get_batch_i64( int itr, array_ptr<char> buffer, size_t buffer_size, uint32_t max_rows, int& next ) {
+         return context.db_get_batch_i64( itr, buffer, buffer_size, max_rows, next );
+      }
+      int db_store_batch_i64( uint64_t scope, uint64_t table, uint64_t payer, array_ptr<const char> buffer, size_t buffer_size ) {
+         return context.db_store_batch_i64( scope, table, payer, buffer, buffer_size );
+      }
+      void db_update_batch_i64( uint64_t payer, array_ptr<const char> buffer, size_t buffer_size ) {
+         context.db_update_batch_i64( payer, buffer, buffer_size );
+      }
 
       DB_API_METHOD_WRAPPERS_SIMPLE_SECONDARY(idx64,  uint64_t)
       DB_API_METHOD_WRAPPERS_SIMPLE_SECONDARY(idx128, uint128_t)
@@ -1747,6 +1782,9 @@ REGISTER_INTRINSICS( database_api,
    (db_lowerbound_i64,   int(int64_t,int64_t,int64_t,int64_t))
    (db_upperbound_i64,   int(int64_t,int64_t,int64_t,int64_t))
    (db_end_i64,          int(int64_t,int64_t,int64_t))
+   (db_get_batch_i64,    int(int,int,int,int,int))
+   (db_store_batch_i64,  int(int64_t,int64_t,int64_t,int,int))
+   (db_update_batch_i64, void(int64_t,int,int))
 
    DB_SECONDARY_INDEX_METHODS_SIMPLE(idx64)
    DB_SECONDARY_INDEX_METHODS_SIMPLE(idx128)
@@ -1913,6 +1951,8 @@ std::istream& operator>>(std::istream& in, wasm_interface::vm_type& runtime) {
       runtime = enumivo::chain::wasm_interface::vm_type::wavm;
    else if (s == "binaryen")
       runtime = enumivo::chain::wasm_interface::vm_type::binaryen;
+   else if (s == "predecoded")
+      runtime = enumivo::chain::wasm_interface::vm_type::predecoded;
    else
       in.setstate(std::ios_base::failbit);
    return in;
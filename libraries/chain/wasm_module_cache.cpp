@@ -0,0 +1,92 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+#include <enumivo/chain/wasm_module_cache.hpp>
+#include <enumivo/chain/wasm_enumivo_constraints.hpp>
+#include <enumivo/chain/wasm_enumivo_injection.hpp>
+
+#include <fc/io/raw.hpp>
+#include <fc/log/logger.hpp>
+
+#include <fstream>
+
+namespace enumivo { namespace chain {
+
+   digest_type injected_wasm_module::calculate_checksum()const {
+      digest_type::encoder enc;
+      fc::raw::pack( enc, code_id );
+      fc::raw::pack( enc, injection_hash );
+      fc::raw::pack( enc, code );
+      fc::raw::pack( enc, initial_memory );
+      return enc.result();
+   }
+
+   wasm_module_cache::wasm_module_cache( const fc::path& dir )
+   :dir( dir )
+   {
+      if( !fc::exists( dir ) )
+         fc::create_directories( dir );
+   }
+
+   const digest_type& wasm_module_cache::injection_hash() {
+      static const digest_type hash = []() {
+         using namespace wasm_constraints;
+         digest_type::encoder enc;
+         fc::raw::pack( enc, wasm_injections::injection_version );
+         for( uint32_t c : { maximum_linear_memory, maximum_mutable_globals, maximum_table_elements, maximum_section_elements,
+                             maximum_linear_memory_init, maximum_func_local_bytes, maximum_call_depth, maximum_code_size } )
+            fc::raw::pack( enc, c );
+         return enc.result();
+      }();
+      return hash;
+   }
+
+   fc::path wasm_module_cache::module_file( const digest_type& code_id )const {
+      return dir / ( code_id.str() + ".wasm" );
+   }
+
+   optional<injected_wasm_module> wasm_module_cache::load( const digest_type& code_id )const {
+      auto file = module_file( code_id );
+      if( !fc::exists( file ) )
+         return optional<injected_wasm_module>();
+
+      try {
+         std::ifstream in;
+         in.exceptions( std::ifstream::failbit | std::ifstream::badbit );
+         in.open( file.generic_string().c_str(), std::ios::in | std::ios::binary );
+         vector<char> data( fc::file_size( file ) );
+         in.read( data.data(), data.size() );
+
+         auto module = fc::raw::unpack<injected_wasm_module>( data );
+         if( module.code_id == code_id && module.injection_hash == injection_hash() && module.checksum == module.calculate_checksum() )
+            return module;
+         if( module.injection_hash == injection_hash() )
+            wlog( "discarding corrupt injected module ${file}", ("file", file.generic_string()) );
+      } catch( const fc::exception& e ) {
+         wlog( "discarding unreadable injected module ${file}: ${e}", ("file", file.generic_string())("e", e.to_string()) );
+      } catch( const std::exception& e ) {
+         wlog( "discarding unreadable injected module ${file}: ${e}", ("file", file.generic_string())("e", e.what()) );
+      }
+
+      fc::remove( file );
+      return optional<injected_wasm_module>();
+   }
+
+   void wasm_module_cache::store( injected_wasm_module module )const {
+      module.injection_hash = injection_hash();
+      module.checksum = module.calculate_checksum();
+
+      auto file = module_file( module.code_id );
+      fc::path tmp( file.generic_string() + ".tmp" );
+      {
+         auto data = fc::raw::pack( module );
+         std::ofstream out;
+         out.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+         out.open( tmp.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+         out.write( data.data(), data.size() );
+      }
+      fc::rename( tmp, file );
+   }
+
+} } // enumivo::chain
@@ -1,5 +1,6 @@
 #include <enumivo/chain/webassembly/binaryen.hpp>
 #include <enumivo/chain/apply_context.hpp>
+#include <fc/scoped_exit.hpp>
 
 #include <wasm-binary.h>
 
@@ -9,18 +10,30 @@ namespace enumivo { namespace chain { namespace webassembly { namespace binaryen
 class binaryen_instantiated_module : public wasm_instantiated_module_interface {
    public:
       binaryen_instantiated_module(linear_memory_type& shared_linear_memory,
+                                   uint32_t& shared_dirty_memory_size,
                                    std::vector<uint8_t> initial_memory,
                                    call_indirect_table_type table,
                                    import_lut_type import_lut,
-                                   unique_ptr<Module>&& module) :
+                                   unique_ptr<Module>&& module,
+                                   TrivialGlobalManager initial_globals,
+                                   size_t code_size) :
          _shared_linear_memory(shared_linear_memory),
+         _shared_dirty_memory_size(shared_dirty_memory_size),
          _initial_memory(initial_memory),
          _table(forward<decltype(table)>(table)),
          _import_lut(forward<decltype(import_lut)>(import_lut)),
-         _module(forward<decltype(module)>(module)) {
+         _module(forward<decltype(module)>(module)),
+         _initial_globals(std::move(initial_globals)),
+         _code_size(code_size),
+         _interface(_shared_linear_memory, _shared_dirty_memory_size, _table, _import_lut) {
 
       }
 
+      //the interpreter's tree of the code is not measured, its size in the binary stands in for it
+      size_t memory_usage()const override {
+         return _code_size + _initial_memory.size();
+      }
+
       void apply(apply_context& context) override {
          LiteralList args = {Literal(uint64_t(context.receiver)),
 	                     Literal(uint64_t(context.act.account)),
@@ -29,24 +42,47 @@ class binaryen_instantiated_module : public wasm_instantiated_module_interface {
       }
 
    private:
-      linear_memory_type&        _shared_linear_memory;      
+      linear_memory_type&        _shared_linear_memory;
+      uint32_t&                  _shared_dirty_memory_size;
       std::vector<uint8_t>       _initial_memory;
       call_indirect_table_type   _table;
       import_lut_type            _import_lut;
       unique_ptr<Module>          _module;
+      TrivialGlobalManager       _initial_globals;
+      size_t                     _code_size;
+      interpreter_interface      _interface;
+      //kept across actions, which only reset its globals; it is rebuilt when an action grows the memory, since
+      // the interpreter keeps the size of the memory to itself
+      unique_ptr<ModuleInstance> _instance;
 
       void call(const string& entry_point, LiteralList& args, apply_context& context){
          const unsigned initial_memory_size = _module->memory.initial*Memory::kPageSize;
-         interpreter_interface local_interface(_shared_linear_memory, _table, _import_lut, initial_memory_size, context);
-
-         //zero out the initial pages
-         memset(_shared_linear_memory.data, 0, initial_memory_size);
+         _interface.context = &context;
+         _interface.current_memory_size = initial_memory_size;
+         auto reset = fc::make_scoped_exit([&](){
+            if(_interface.current_memory_size != initial_memory_size)
+               _instance.reset();
+            _interface.context = nullptr;
+         });
+
+         //zero out what was written since the last reset, the rest of the memory is still zero
+         if(_shared_dirty_memory_size > _initial_memory.size())
+            memset(_shared_linear_memory.data + _initial_memory.size(), 0, _shared_dirty_memory_size - _initial_memory.size());
          //copy back in the initial data
          memcpy(_shared_linear_memory.data, _initial_memory.data(), _initial_memory.size());
-         
-         //be aware that construction of the ModuleInstance implictly fires the start function
-         ModuleInstance instance(*_module.get(), &local_interface);
-         instance.callExport(Name(entry_point), args);
+         _shared_dirty_memory_size = _initial_memory.size();
+
+         if(!_instance) {
+            //be aware that construction of the ModuleInstance implictly fires the start function
+            _instance = std::make_unique<ModuleInstance>(*_module.get(), &_interface);
+         } else {
+            _instance->globals = _initial_globals;
+            if(_module->start.is()) {
+               LiteralList start_args;
+               _instance->callFunction(_module->start, start_args);
+            }
+         }
+         _instance->callExport(Name(entry_point), args);
       }
 };
 
@@ -96,7 +132,7 @@ std::unique_ptr<wasm_instantiated_module_interface> binaryen_runtime::instantiat
          ENU_ASSERT( !"unresolvable", wasm_exception, "${module}.${export} unresolveable", ("module",import->module.c_str())("export",import->base.c_str()) );
       }
 
-      return std::make_unique<binaryen_instantiated_module>(_memory, initial_memory, move(table), move(import_lut), move(module));
+      return std::make_unique<binaryen_instantiated_module>(_memory, _dirty_memory_size, initial_memory, move(table), move(import_lut), move(module), move(globals), code_size);
    } catch (const ParseException &e) {
       FC_THROW_EXCEPTION(wasm_execution_error, "Error building interpreter: ${s}", ("s", e.text));
    }
@@ -0,0 +1,1028 @@
+#include <enumivo/chain/webassembly/predecoded.hpp>
+#include <enumivo/chain/wasm_enumivo_constraints.hpp>
+#include <enumivo/chain/apply_context.hpp>
+#include <enumivo/chain/exceptions.hpp>
+#include <fc/scoped_exit.hpp>
+
+#include "IR/Module.h"
+#include "IR/Operators.h"
+#include "IR/Validate.h"
+#include "WASM/WASM.h"
+#include "Inline/Serialization.h"
+
+#include <unordered_map>
+
+using namespace IR;
+
+namespace enumivo { namespace chain { namespace webassembly { namespace predecoded {
+
+/*
+ * The instructions of the runtime. Each names the slots of the frame of the running function it reads and writes: a
+ * function's locals come first, then a slot for every height its operand stack reaches. A call passes the slots its
+ * arguments are in as the first slots of the callee's frame, and gets the result back in the first of them.
+ */
+#define PREDECODED_CONTROL_OPCODES(op) \
+   op(unreachable) \
+   op(br) \
+   op(br_if) \
+   op(br_unless) \
+   op(br_table) \
+   op(return_value) \
+   op(return_void) \
+   op(call) \
+   op(call_host) \
+   op(call_indirect)
+
+#define PREDECODED_VARIABLE_OPCODES(op) \
+   op(copy) \
+   op(select) \
+   op(const32) \
+   op(const64) \
+   op(get_global) \
+   op(set_global) \
+   op(current_memory) \
+   op(grow_memory)
+
+// floating point values are loaded and stored as the integers of the same size
+#define PREDECODED_LOAD_OPCODES(op) \
+   op(i32_load,     uint32_t, uint32_t) \
+   op(i64_load,     uint64_t, uint64_t) \
+   op(i32_load8_s,  int8_t,   uint32_t) \
+   op(i32_load8_u,  uint8_t,  uint32_t) \
+   op(i32_load16_s, int16_t,  uint32_t) \
+   op(i32_load16_u, uint16_t, uint32_t) \
+   op(i64_load8_s,  int8_t,   uint64_t) \
+   op(i64_load8_u,  uint8_t,  uint64_t) \
+   op(i64_load16_s, int16_t,  uint64_t) \
+   op(i64_load16_u, uint16_t, uint64_t) \
+   op(i64_load32_s, int32_t,  uint64_t) \
+   op(i64_load32_u, uint32_t, uint64_t)
+
+#define PREDECODED_STORE_OPCODES(op) \
+   op(i32_store,   uint32_t) \
+   op(i64_store,   uint64_t) \
+   op(i32_store8,  uint8_t) \
+   op(i32_store16, uint16_t) \
+   op(i64_store8,  uint8_t) \
+   op(i64_store16, uint16_t) \
+   op(i64_store32, uint32_t)
+
+#define PREDECODED_UNARY_OPCODES(op) \
+   op(i32_eqz,          uint32_t, a == 0) \
+   op(i32_clz,          uint32_t, a ? __builtin_clz(a) : 32) \
+   op(i32_ctz,          uint32_t, a ? __builtin_ctz(a) : 32) \
+   op(i32_popcnt,       uint32_t, __builtin_popcount(a)) \
+   op(i64_eqz,          uint64_t, a == 0) \
+   op(i64_clz,          uint64_t, a ? __builtin_clzll(a) : 64) \
+   op(i64_ctz,          uint64_t, a ? __builtin_ctzll(a) : 64) \
+   op(i64_popcnt,       uint64_t, __builtin_popcountll(a)) \
+   op(i32_wrap_i64,     uint64_t, uint32_t(a)) \
+   op(i64_extend_s_i32, uint32_t, int64_t(int32_t(a))) \
+   op(i64_extend_u_i32, uint32_t, a)
+
+#define PREDECODED_BINARY_OPCODES(op) \
+   op(i32_eq,   uint32_t, l == r) \
+   op(i32_ne,   uint32_t, l != r) \
+   op(i32_lt_s, uint32_t, int32_t(l) < int32_t(r)) \
+   op(i32_lt_u, uint32_t, l < r) \
+   op(i32_gt_s, uint32_t, int32_t(l) > int32_t(r)) \
+   op(i32_gt_u, uint32_t, l > r) \
+   op(i32_le_s, uint32_t, int32_t(l) <= int32_t(r)) \
+   op(i32_le_u, uint32_t, l <= r) \
+   op(i32_ge_s, uint32_t, int32_t(l) >= int32_t(r)) \
+   op(i32_ge_u, uint32_t, l >= r) \
+   op(i32_add,  uint32_t, l + r) \
+   op(i32_sub,  uint32_t, l - r) \
+   op(i32_mul,  uint32_t, l * r) \
+   op(i32_and,  uint32_t, l & r) \
+   op(i32_or,   uint32_t, l | r) \
+   op(i32_xor,  uint32_t, l ^ r) \
+   op(i32_shl,  uint32_t, l << (r & 31)) \
+   op(i32_shr_s, uint32_t, uint32_t(int32_t(l) >> (r & 31))) \
+   op(i32_shr_u, uint32_t, l >> (r & 31)) \
+   op(i32_rotl, uint32_t, (l << (r & 31)) | (l >> ((32 - (r & 31)) & 31))) \
+   op(i32_rotr, uint32_t, (l >> (r & 31)) | (l << ((32 - (r & 31)) & 31))) \
+   op(i64_eq,   uint64_t, l == r) \
+   op(i64_ne,   uint64_t, l != r) \
+   op(i64_lt_s, uint64_t, int64_t(l) < int64_t(r)) \
+   op(i64_lt_u, uint64_t, l < r) \
+   op(i64_gt_s, uint64_t, int64_t(l) > int64_t(r)) \
+   op(i64_gt_u, uint64_t, l > r) \
+   op(i64_le_s, uint64_t, int64_t(l) <= int64_t(r)) \
+   op(i64_le_u, uint64_t, l <= r) \
+   op(i64_ge_s, uint64_t, int64_t(l) >= int64_t(r)) \
+   op(i64_ge_u, uint64_t, l >= r) \
+   op(i64_add,  uint64_t, l + r) \
+   op(i64_sub,  uint64_t, l - r) \
+   op(i64_mul,  uint64_t, l * r) \
+   op(i64_and,  uint64_t, l & r) \
+   op(i64_or,   uint64_t, l | r) \
+   op(i64_xor,  uint64_t, l ^ r) \
+   op(i64_shl,  uint64_t, l << (r & 63)) \
+   op(i64_shr_s, uint64_t, uint64_t(int64_t(l) >> (r & 63))) \
+   op(i64_shr_u, uint64_t, l >> (r & 63)) \
+   op(i64_rotl, uint64_t, (l << (r & 63)) | (l >> ((64 - (r & 63)) & 63))) \
+   op(i64_rotr, uint64_t, (l >> (r & 63)) | (l << ((64 - (r & 63)) & 63)))
+
+#define PREDECODED_DIVISION_OPCODES(op) \
+   op(i32_div_s, int32_t) \
+   op(i32_div_u, uint32_t) \
+   op(i32_rem_s, int32_t) \
+   op(i32_rem_u, uint32_t) \
+   op(i64_div_s, int64_t) \
+   op(i64_div_u, uint64_t) \
+   op(i64_rem_s, int64_t) \
+   op(i64_rem_u, uint64_t)
+
+#define PREDECODED_OPCODES(op) \
+   PREDECODED_CONTROL_OPCODES(op) \
+   PREDECODED_VARIABLE_OPCODES(op) \
+   PREDECODED_LOAD_OPCODES(op) \
+   PREDECODED_STORE_OPCODES(op) \
+   PREDECODED_UNARY_OPCODES(op) \
+   PREDECODED_BINARY_OPCODES(op) \
+   PREDECODED_DIVISION_OPCODES(op)
+
+enum opcode : uint32_t {
+#define DECLARE_OPCODE(name, ...) op_##name,
+   PREDECODED_OPCODES(DECLARE_OPCODE)
+#undef DECLARE_OPCODE
+};
+
+/**
+ * a: the slot written, or the first operand of instructions that write none
+ * b, c: the slots read, or immediates; branches keep their target in b
+ */
+struct instruction {
+   uint32_t op;
+   uint32_t a;
+   uint32_t b;
+   uint32_t c;
+};
+
+struct function_info {
+   intrinsic_fn   host = nullptr;  ///< of imported functions
+   uint32_t       type_id = 0;
+   uint32_t       num_params = 0;
+   uint32_t       num_locals = 0;  ///< including the parameters
+   uint32_t       frame_size = 0;  ///< slots
+   uint32_t       entry = 0;       ///< index of the first instruction
+};
+
+/// br_table instructions index a header whose target is the number of entries, which are followed by the default one
+struct br_table_entry {
+   uint32_t target;
+   uint32_t slot;  ///< the value is copied to
+};
+
+constexpr uint32_t no_slot = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t no_function = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t no_instruction = std::numeric_limits<uint32_t>::max();
+
+struct translated_module {
+   vector<instruction>     code;
+   vector<function_info>   functions;
+   vector<br_table_entry>  br_tables;
+   vector<uint32_t>        table;  ///< function indices, no_function for uninitialized elements
+   vector<uint64_t>        initial_globals;
+   uint32_t                memory_pages = 0;
+   uint32_t                max_memory_pages = 0;
+   uint32_t                apply_function = no_function;
+   uint32_t                start_function = no_function;
+   uint32_t                max_frame_size = 0;
+};
+
+/**
+ * Translates the code of a function, which has been validated when it was deserialized. Values are not copied to
+ * the operand stack until they have to be: a local that is read stays where it is until it is written or control
+ * flow merges, and an operation whose result is written to a local right away writes it there itself.
+ */
+class function_translator {
+   public:
+      typedef void Result;
+
+      function_translator(translated_module& m, const Module& module, const std::unordered_map<const FunctionType*, uint32_t>& type_ids,
+                          uint32_t function_index)
+      :_m(m),
+       _module(module),
+       _type_ids(type_ids),
+       _def(module.functions.defs[function_index - module.functions.imports.size()]),
+       _type(module.types[_def.type.index]),
+       _function_index(function_index),
+       _num_locals(_type->parameters.size() + _def.nonParameterLocalTypes.size())
+      {}
+
+      void translate() {
+         function_info& f = _m.functions[_function_index];
+         f.entry = _m.code.size();
+         _controls.push_back(control{control::function_kind, 0, _type->ret != ResultType::none});
+         OperatorDecoderStream decoder(_def.code);
+         while(decoder)
+            decoder.decodeOp(*this);
+         ENU_ASSERT(_controls.empty(), wasm_execution_error, "function ends inside a block");
+         f.frame_size = _num_locals + _max_height;
+         _m.max_frame_size = std::max(_m.max_frame_size, f.frame_size);
+      }
+
+      void unknown(Opcode opcode) {
+         ENU_ASSERT(false, wasm_execution_error, "unknown opcode ${op}", ("op", uint32_t(opcode)));
+      }
+
+      void block(ControlStructureImm imm) {
+         if(!_reachable) {
+            ++_dead_depth;
+            return;
+         }
+         materialize_all();
+         _controls.push_back(control{control::block_kind, height(), imm.resultType != ResultType::none});
+      }
+
+      void loop(ControlStructureImm imm) {
+         if(!_reachable) {
+            ++_dead_depth;
+            return;
+         }
+         materialize_all();
+         bind_label();
+         _controls.push_back(control{control::loop_kind, height(), imm.resultType != ResultType::none, uint32_t(_m.code.size())});
+      }
+
+      void if_(ControlStructureImm imm) {
+         if(!_reachable) {
+            ++_dead_depth;
+            return;
+         }
+         uint32_t cond = pop();
+         materialize_all();
+         control c{control::if_kind, height(), imm.resultType != ResultType::none};
+         c.else_branch = emit(op_br_unless, cond, 0);
+         _controls.push_back(std::move(c));
+      }
+
+      void else_(NoImm) {
+         if(_dead_depth)
+            return;
+         control& c = _controls.back();
+         if(_reachable) {
+            if(c.has_result)
+               move_top(c.height);
+            c.fixups.push_back(fixup{false, emit(op_br, 0, 0)});
+         }
+         _m.code[c.else_branch].b = _m.code.size();
+         c.else_branch = no_instruction;
+         bind_label();
+         _stack.resize(c.height);
+         _reachable = true;
+      }
+
+      void end(NoImm) {
+         if(_dead_depth) {
+            --_dead_depth;
+            return;
+         }
+         control c = std::move(_controls.back());
+         _controls.pop_back();
+         if(_reachable && c.has_result)
+            move_top(c.height);
+         if(c.else_branch != no_instruction)
+            _m.code[c.else_branch].b = _m.code.size();
+         for(const auto& f : c.fixups) {
+            if(f.in_table)
+               _m.br_tables[f.index].target = _m.code.size();
+            else
+               _m.code[f.index].b = _m.code.size();
+         }
+         bind_label();
+         _stack.resize(c.height);
+         if(c.has_result)
+            push();
+         _reachable = true;
+
+         if(c.kind == control::function_kind) {
+            if(c.has_result)
+               emit(op_return_value, slot(0));
+            else
+               emit(op_return_void);
+         }
+      }
+
+      void unreachable(NoImm) {
+         if(!_reachable)
+            return;
+         emit(op_unreachable);
+         _reachable = false;
+      }
+
+      void br(BranchImm imm) {
+         if(!_reachable)
+            return;
+         branch(target(imm.targetDepth));
+         _reachable = false;
+      }
+
+      void br_if(BranchImm imm) {
+         if(!_reachable)
+            return;
+         uint32_t cond = pop();
+         control& c = target(imm.targetDepth);
+         if(c.kind == control::loop_kind) {
+            emit(op_br_if, cond, c.start);
+         } else if(!c.has_result || _stack.back() == slot(c.height)) {
+            c.fixups.push_back(fixup{false, emit(op_br_if, cond, 0)});
+         } else {
+            //the value is moved to where the block leaves its result only if the branch is taken
+            uint32_t skip = emit(op_br_unless, cond, 0);
+            emit(op_copy, slot(c.height), _stack.back());
+            c.fixups.push_back(fixup{false, emit(op_br, 0, 0)});
+            _m.code[skip].b = _m.code.size();
+            bind_label();
+         }
+      }
+
+      void br_table(BranchTableImm imm) {
+         if(!_reachable)
+            return;
+         uint32_t index = pop();
+         const auto& depths = _def.branchTables[imm.branchTableIndex];
+         const bool has_value = branch_has_value(target(imm.defaultTargetDepth));
+         const uint32_t value = has_value ? _stack.back() : no_slot;
+
+         const uint32_t table = _m.br_tables.size();
+         _m.br_tables.push_back(br_table_entry{uint32_t(depths.size()), no_slot});
+         auto add_entry = [&](uint32_t depth) {
+            control& c = target(depth);
+            if(c.kind == control::loop_kind) {
+               _m.br_tables.push_back(br_table_entry{c.start, no_slot});
+            } else {
+               c.fixups.push_back(fixup{true, uint32_t(_m.br_tables.size())});
+               _m.br_tables.push_back(br_table_entry{0, has_value ? slot(c.height) : no_slot});
+            }
+         };
+         for(auto depth : depths)
+            add_entry(depth);
+         add_entry(imm.defaultTargetDepth);
+
+         emit(op_br_table, index, value, table);
+         _reachable = false;
+      }
+
+      void return_(NoImm) {
+         if(!_reachable)
+            return;
+         if(_type->ret != ResultType::none)
+            emit(op_return_value, pop());
+         else
+            emit(op_return_void);
+         _reachable = false;
+      }
+
+      void call(CallImm imm) {
+         if(!_reachable)
+            return;
+         const FunctionType* type = function_type(imm.functionIndex);
+         const uint32_t base = arguments(type->parameters.size());
+         emit(imm.functionIndex < _module.functions.imports.size() ? op_call_host : op_call, base, imm.functionIndex);
+         if(type->ret != ResultType::none)
+            push();
+      }
+
+      void call_indirect(CallIndirectImm imm) {
+         if(!_reachable)
+            return;
+         const FunctionType* type = _module.types[imm.type.index];
+         uint32_t index = pop();
+         const uint32_t base = arguments(type->parameters.size());
+         emit(op_call_indirect, base, index, _type_ids.at(type));
+         if(type->ret != ResultType::none)
+            push();
+      }
+
+      void drop(NoImm) {
+         if(!_reachable)
+            return;
+         pop();
+      }
+
+      void select(NoImm) {
+         if(!_reachable)
+            return;
+         uint32_t cond = pop();
+         uint32_t if_false = pop();
+         materialize(height() - 1);
+         emit(op_select, slot(height() - 1), if_false, cond);
+      }
+
+      void get_local(GetOrSetVariableImm<false> imm) {
+         if(!_reachable)
+            return;
+         push_local(imm.variableIndex);
+      }
+
+      void set_local(GetOrSetVariableImm<false> imm) {
+         if(!_reachable)
+            return;
+         store_local(imm.variableIndex, pop());
+      }
+
+      void tee_local(GetOrSetVariableImm<false> imm) {
+         if(!_reachable)
+            return;
+         store_local(imm.variableIndex, pop());
+         push_local(imm.variableIndex);
+      }
+
+      void get_global(GetOrSetVariableImm<true> imm) {
+         if(!_reachable)
+            return;
+         emit_result(op_get_global, imm.variableIndex);
+      }
+
+      void set_global(GetOrSetVariableImm<true> imm) {
+         if(!_reachable)
+            return;
+         emit(op_set_global, imm.variableIndex, pop());
+      }
+
+#define VISIT_OPCODE(_, name, nameString, Imm, ...) \
+      void name(Imm imm) { \
+         if(_reachable) \
+            translate_operator(Opcode::name, imm); \
+      }
+      ENUM_NONCONTROL_NONPARAMETRIC_OPERATORS(VISIT_OPCODE)
+#undef VISIT_OPCODE
+
+   private:
+      struct fixup {
+         bool     in_table;
+         uint32_t index;  ///< of the instruction or br_table entry whose target is the end of the block
+      };
+
+      struct control {
+         enum kind_type { block_kind, loop_kind, if_kind, function_kind };
+
+         kind_type      kind;
+         uint32_t       height;  ///< of the operand stack at the start
+         bool           has_result;
+         uint32_t       start = no_instruction;        ///< of a loop
+         uint32_t       else_branch = no_instruction;  ///< of an if, whose target is its else or end
+         vector<fixup>  fixups;
+      };
+
+      void translate_operator(Opcode opcode, NoImm) {
+         switch(opcode) {
+#define UNARY_CASE(name, ...) case Opcode::name: emit_result(op_##name, pop()); return;
+            PREDECODED_UNARY_OPCODES(UNARY_CASE)
+#undef UNARY_CASE
+#define BINARY_CASE(name, ...) case Opcode::name: { uint32_t r = pop(); uint32_t l = pop(); emit_result(op_##name, l, r); return; }
+            PREDECODED_BINARY_OPCODES(BINARY_CASE)
+            PREDECODED_DIVISION_OPCODES(BINARY_CASE)
+#undef BINARY_CASE
+            case Opcode::nop:
+            //the bits stay as they are
+            case Opcode::i32_reinterpret_f32:
+            case Opcode::i64_reinterpret_f64:
+            case Opcode::f32_reinterpret_i32:
+            case Opcode::f64_reinterpret_i64:
+               return;
+            default:
+               //floating point arithmetic has been replaced with calls to softfloat by the injection
+               ENU_ASSERT(false, wasm_execution_error, "${op} is not supported by the predecoded runtime", ("op", getOpcodeName(opcode)));
+         }
+      }
+
+      void translate_operator(Opcode opcode, MemoryImm) {
+         if(opcode == Opcode::current_memory)
+            emit_result(op_current_memory);
+         else
+            emit_result(op_grow_memory, pop());
+      }
+
+      template<Uptr naturalAlignmentLog2>
+      void translate_operator(Opcode opcode, LoadOrStoreImm<naturalAlignmentLog2> imm) {
+         switch(opcode) {
+#define LOAD_CASE(name, ...) case Opcode::name: emit_result(op_##name, pop(), imm.offset); return;
+            PREDECODED_LOAD_OPCODES(LOAD_CASE)
+#undef LOAD_CASE
+            case Opcode::f32_load: emit_result(op_i32_load, pop(), imm.offset); return;
+            case Opcode::f64_load: emit_result(op_i64_load, pop(), imm.offset); return;
+            default: break;
+         }
+         uint32_t value = pop();
+         uint32_t address = pop();
+         switch(opcode) {
+#define STORE_CASE(name, ...) case Opcode::name: emit(op_##name, address, value, imm.offset); return;
+            PREDECODED_STORE_OPCODES(STORE_CASE)
+#undef STORE_CASE
+            case Opcode::f32_store: emit(op_i32_store, address, value, imm.offset); return;
+            case Opcode::f64_store: emit(op_i64_store, address, value, imm.offset); return;
+            default:
+               ENU_ASSERT(false, wasm_execution_error, "${op} is not supported by the predecoded runtime", ("op", getOpcodeName(opcode)));
+         }
+      }
+
+      void translate_operator(Opcode, LiteralImm<I32> imm) {
+         emit_result(op_const32, uint32_t(imm.value));
+      }
+
+      void translate_operator(Opcode, LiteralImm<I64> imm) {
+         emit_result(op_const64, uint32_t(imm.value), uint32_t(uint64_t(imm.value) >> 32));
+      }
+
+      void translate_operator(Opcode, LiteralImm<F32> imm) {
+         uint32_t bits;
+         memcpy(&bits, &imm.value, sizeof(bits));
+         emit_result(op_const32, bits);
+      }
+
+      void translate_operator(Opcode, LiteralImm<F64> imm) {
+         uint64_t bits;
+         memcpy(&bits, &imm.value, sizeof(bits));
+         emit_result(op_const64, uint32_t(bits), uint32_t(bits >> 32));
+      }
+
+      const FunctionType* function_type(uint32_t function_index)const {
+         if(function_index < _module.functions.imports.size())
+            return _module.types[_module.functions.imports[function_index].type.index];
+         return _module.types[_module.functions.defs[function_index - _module.functions.imports.size()].type.index];
+      }
+
+      uint32_t slot(uint32_t height)const { return _num_locals + height; }
+      uint32_t height()const { return _stack.size(); }
+
+      control& target(uint32_t depth) {
+         ENU_ASSERT(depth < _controls.size(), wasm_execution_error, "branch target out of range");
+         return _controls[_controls.size() - 1 - depth];
+      }
+
+      //loops are branched to at their start, which takes no values
+      static bool branch_has_value(const control& c) {
+         return c.kind != control::loop_kind && c.has_result;
+      }
+
+      void push() {
+         _stack.push_back(slot(height()));
+         _max_height = std::max(_max_height, height());
+      }
+
+      void push_local(uint32_t local) {
+         ENU_ASSERT(local < _num_locals, wasm_execution_error, "local out of range");
+         _stack.push_back(local);
+         _max_height = std::max(_max_height, height());
+      }
+
+      uint32_t pop() {
+         ENU_ASSERT(!_stack.empty(), wasm_execution_error, "operand stack underflow");
+         uint32_t s = _stack.back();
+         _stack.pop_back();
+         return s;
+      }
+
+      uint32_t emit(opcode op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0) {
+         _m.code.push_back(instruction{op, a, b, c});
+         return _m.code.size() - 1;
+      }
+
+      /// pushes the result of an instruction that writes nothing but it, which a set_local may have write to the local
+      void emit_result(opcode op, uint32_t b = 0, uint32_t c = 0) {
+         push();
+         _last_result = emit(op, _stack.back(), b, c);
+      }
+
+      void bind_label() {
+         _label = _m.code.size();
+      }
+
+      void materialize(uint32_t height) {
+         if(_stack[height] != slot(height)) {
+            emit(op_copy, slot(height), _stack[height]);
+            _stack[height] = slot(height);
+         }
+      }
+
+      /// the values on the operand stack must be in their slots where control flow merges
+      void materialize_all() {
+         for(uint32_t i = 0; i < height(); ++i)
+            materialize(i);
+      }
+
+      void move_top(uint32_t height) {
+         if(_stack.back() != slot(height))
+            emit(op_copy, slot(height), _stack.back());
+      }
+
+      /// returns the first slot of the arguments
+      uint32_t arguments(uint32_t count) {
+         ENU_ASSERT(count <= height(), wasm_execution_error, "operand stack underflow");
+         for(uint32_t i = height() - count; i < height(); ++i)
+            materialize(i);
+         _stack.resize(height() - count);
+         return slot(height());
+      }
+
+      void branch(control& c) {
+         if(c.kind == control::loop_kind) {
+            emit(op_br, 0, c.start);
+            return;
+         }
+         if(c.has_result)
+            move_top(c.height);
+         c.fixups.push_back(fixup{false, emit(op_br, 0, 0)});
+      }
+
+      void store_local(uint32_t local, uint32_t value) {
+         ENU_ASSERT(local < _num_locals, wasm_execution_error, "local out of range");
+         if(value == local)
+            return;
+         //what is still to read the old value gets a copy of it first
+         for(uint32_t i = 0; i < height(); ++i) {
+            if(_stack[i] == local)
+               materialize(i);
+         }
+         if(_last_result == _m.code.size() - 1 && _label != _m.code.size() && value == slot(height())
+            && _m.code[_last_result].a == value) {
+            _m.code[_last_result].a = local;
+         } else {
+            emit(op_copy, local, value);
+         }
+      }
+
+      translated_module&                                    _m;
+      const Module&                                         _module;
+      const std::unordered_map<const FunctionType*, uint32_t>& _type_ids;
+      const FunctionDef&                                    _def;
+      const FunctionType*                                   _type;
+      uint32_t                                              _function_index;
+      uint32_t                                              _num_locals;
+      vector<uint32_t>                                      _stack;  ///< the slot each operand is in
+      uint32_t                                              _max_height = 0;
+      vector<control>                                       _controls;
+      bool                                                  _reachable = true;
+      uint32_t                                              _dead_depth = 0;  ///< of blocks in unreachable code
+      uint32_t                                              _label = no_instruction;        ///< last instruction branched to
+      uint32_t                                              _last_result = no_instruction;  ///< see emit_result
+};
+
+static translated_module translate_module(const Module& module) {
+   translated_module m;
+
+   std::unordered_map<const FunctionType*, uint32_t> type_ids;
+   for(const FunctionType* type : module.types)
+      type_ids.emplace(type, type_ids.size());
+
+   for(const auto& import : module.functions.imports) {
+      auto& intrinsic_map = intrinsic_registrator::get_map();
+      auto intrinsic_itr = intrinsic_map.find(import.moduleName + "." + import.exportName);
+      ENU_ASSERT( intrinsic_itr != intrinsic_map.end() && intrinsic_itr->second.type == module.types[import.type.index], wasm_exception,
+                  "${module}.${export} unresolveable", ("module",import.moduleName)("export",import.exportName) );
+      function_info f;
+      f.host = intrinsic_itr->second.fn;
+      f.type_id = type_ids.at(module.types[import.type.index]);
+      f.num_params = f.num_locals = module.types[import.type.index]->parameters.size();
+      m.functions.push_back(f);
+   }
+   ENU_ASSERT( module.tables.imports.empty() && module.memories.imports.empty() && module.globals.imports.empty(), wasm_exception,
+               "only functions can be imported" );
+
+   for(const auto& def : module.functions.defs) {
+      function_info f;
+      f.type_id = type_ids.at(module.types[def.type.index]);
+      f.num_params = module.types[def.type.index]->parameters.size();
+      f.num_locals = f.num_params + def.nonParameterLocalTypes.size();
+      m.functions.push_back(f);
+   }
+   for(uint32_t i = module.functions.imports.size(); i < m.functions.size(); ++i)
+      function_translator(m, module, type_ids, i).translate();
+
+   for(const auto& global : module.globals.defs) {
+      uint64_t value = 0;
+      switch(global.initializer.type) {
+         case InitializerExpression::Type::i32_const: value = uint32_t(global.initializer.i32); break;
+         case InitializerExpression::Type::i64_const: value = uint64_t(global.initializer.i64); break;
+         case InitializerExpression::Type::f32_const: memcpy(&value, &global.initializer.f32, sizeof(F32)); break;
+         case InitializerExpression::Type::f64_const: memcpy(&value, &global.initializer.f64, sizeof(F64)); break;
+         default: ENU_ASSERT(false, wasm_exception, "unsupported global initializer");
+      }
+      m.initial_globals.push_back(value);
+   }
+
+   if(module.memories.defs.size()) {
+      const auto& size = module.memories.defs[0].type.size;
+      const uint64_t max_pages = wasm_constraints::maximum_linear_memory / wasm_constraints::wasm_page_size;
+      ENU_ASSERT(size.min <= max_pages, wasm_execution_error, "exceeds maximum linear memory");
+      m.memory_pages = size.min;
+      m.max_memory_pages = std::min(size.max, max_pages);
+   }
+
+   if(module.tables.defs.size()) {
+      m.table.resize(module.tables.defs[0].type.size.min, no_function);
+      for(const auto& segment : module.tableSegments) {
+         ENU_ASSERT(segment.baseOffset.type == InitializerExpression::Type::i32_const, wasm_exception, "");
+         const uint64_t offset = uint32_t(segment.baseOffset.i32);
+         ENU_ASSERT(offset + segment.indices.size() <= m.table.size(), wasm_exception, "table segment outside of the table");
+         for(size_t i = 0; i < segment.indices.size(); ++i)
+            m.table[offset + i] = segment.indices[i];
+      }
+   }
+
+   for(const auto& e : module.exports) {
+      if(e.kind == ObjectKind::function && e.name == "apply") {
+         m.apply_function = e.index;
+         ENU_ASSERT(m.functions[e.index].num_params == 3, wasm_exception, "");
+      }
+   }
+   if(module.startFunctionIndex != UINTPTR_MAX)
+      m.start_function = module.startFunctionIndex;
+
+   return m;
+}
+
+class predecoded_instantiated_module : public wasm_instantiated_module_interface {
+   public:
+      predecoded_instantiated_module(predecoded_runtime::execution_state& state, translated_module&& module,
+                                     std::vector<uint8_t> initial_memory) :
+         _state(state),
+         _module(std::move(module)),
+         _initial_memory(std::move(initial_memory)),
+         _globals(_module.initial_globals.size())
+      {}
+
+      size_t memory_usage()const override {
+         return _module.code.size() * sizeof(instruction) + _module.br_tables.size() * sizeof(br_table_entry)
+              + _module.functions.size() * sizeof(function_info) + _module.table.size() * sizeof(uint32_t) + _initial_memory.size();
+      }
+
+      void apply(apply_context& context) override {
+         running_instance_context& ctx = _state.context;
+         //zero out what was written since the last reset, the rest of the memory is still zero
+         if(ctx.dirty_memory_size > _initial_memory.size())
+            memset(ctx.memory + _initial_memory.size(), 0, ctx.dirty_memory_size - _initial_memory.size());
+         memcpy(ctx.memory, _initial_memory.data(), _initial_memory.size());
+         ctx.dirty_memory_size = _initial_memory.size();
+         ctx.memory_size = uint64_t(_module.memory_pages) * wasm_constraints::wasm_page_size;
+         ctx.apply_ctx = &context;
+         auto reset = fc::make_scoped_exit([&](){
+            ctx.apply_ctx = nullptr;
+         });
+         std::copy(_module.initial_globals.begin(), _module.initial_globals.end(), _globals.begin());
+
+         //a frame starts within the one of its caller, so the deepest chain of calls fits in this many slots
+         const size_t stack_size = size_t(_module.max_frame_size + 3) * (wasm_constraints::maximum_call_depth + 2);
+         if(_state.stack.size() < stack_size)
+            _state.stack.resize(stack_size);
+
+         try {
+            if(_module.start_function != no_function)
+               run(_module.start_function, _state.stack.data());
+            if(_module.apply_function == no_function)
+               return;
+            uint64_t* args = _state.stack.data();
+            args[0] = uint64_t(context.receiver);
+            args[1] = uint64_t(context.act.account);
+            args[2] = uint64_t(context.act.name);
+            run(_module.apply_function, args);
+         } catch( const wasm_exit& e ) {
+         }
+      }
+
+   private:
+      [[noreturn]] static void trap(const char* why) {
+         FC_THROW_EXCEPTION(wasm_execution_error, why);
+      }
+
+      void run(uint32_t function, uint64_t* fp) {
+         static const void* const dispatch[] = {
+#define DISPATCH_LABEL(name, ...) &&op_##name,
+            PREDECODED_OPCODES(DISPATCH_LABEL)
+#undef DISPATCH_LABEL
+         };
+#define DISPATCH() goto *dispatch[ip->op]
+#define NEXT() { ++ip; DISPATCH(); }
+
+         struct call_frame {
+            const instruction* return_ip;
+            uint64_t*          fp;
+         };
+         call_frame frames[wasm_constraints::maximum_call_depth + 2];
+         uint32_t depth = 0;
+
+         running_instance_context& ctx = _state.context;
+         char* const memory = ctx.memory;
+         uint64_t memory_size = ctx.memory_size;
+         uint64_t* const stack_end = _state.stack.data() + _state.stack.size();
+         uint64_t* const globals = _globals.data();
+         const instruction* const code = _module.code.data();
+         const function_info* const functions = _module.functions.data();
+         const instruction* ip = nullptr;
+         const function_info* callee = &functions[function];
+
+         if(callee->host) {
+            callee->host(ctx, fp);
+            return;
+         }
+         goto enter;
+
+      call_function:
+         if(depth == wasm_constraints::maximum_call_depth + 2)
+            trap("call depth exceeded");
+         frames[depth++] = call_frame{ip + 1, fp};
+         fp += ip->a;
+      enter:
+         if(fp + callee->frame_size > stack_end)
+            trap("call stack exhausted");
+         memset(fp + callee->num_params, 0, (callee->num_locals - callee->num_params) * sizeof(uint64_t));
+         ip = code + callee->entry;
+         DISPATCH();
+
+      op_unreachable:
+         trap("unreachable");
+      op_br:
+         ip = code + ip->b;
+         DISPATCH();
+      op_br_if:
+         ip = uint32_t(fp[ip->a]) ? code + ip->b : ip + 1;
+         DISPATCH();
+      op_br_unless:
+         ip = uint32_t(fp[ip->a]) ? ip + 1 : code + ip->b;
+         DISPATCH();
+      op_br_table: {
+         const br_table_entry* table = _module.br_tables.data() + ip->c;
+         const br_table_entry& e = table[1 + std::min(uint32_t(fp[ip->a]), table->target)];
+         if(e.slot != no_slot)
+            fp[e.slot] = fp[ip->b];
+         ip = code + e.target;
+         DISPATCH();
+      }
+      op_return_value:
+         fp[0] = fp[ip->a];
+      op_return_void:
+         if(depth == 0)
+            return;
+         --depth;
+         ip = frames[depth].return_ip;
+         fp = frames[depth].fp;
+         DISPATCH();
+      op_call:
+         callee = &functions[ip->b];
+         goto call_function;
+      op_call_host:
+         functions[ip->b].host(ctx, fp + ip->a);
+         NEXT();
+      op_call_indirect: {
+         const uint32_t element = uint32_t(fp[ip->b]);
+         if(element >= _module.table.size())
+            trap("callIndirect: bad pointer");
+         if(_module.table[element] == no_function)
+            trap("callIndirect: uninitialized element");
+         callee = &functions[_module.table[element]];
+         if(callee->type_id != ip->c)
+            trap("callIndirect: bad function type");
+         if(!callee->host)
+            goto call_function;
+         callee->host(ctx, fp + ip->a);
+         NEXT();
+      }
+
+      op_copy:
+         fp[ip->a] = fp[ip->b];
+         NEXT();
+      op_select:
+         if(!uint32_t(fp[ip->c]))
+            fp[ip->a] = fp[ip->b];
+         NEXT();
+      op_const32:
+         fp[ip->a] = ip->b;
+         NEXT();
+      op_const64:
+         fp[ip->a] = uint64_t(ip->b) | (uint64_t(ip->c) << 32);
+         NEXT();
+      op_get_global:
+         fp[ip->a] = globals[ip->b];
+         NEXT();
+      op_set_global:
+         globals[ip->a] = fp[ip->b];
+         NEXT();
+      op_current_memory:
+         fp[ip->a] = memory_size / wasm_constraints::wasm_page_size;
+         NEXT();
+      op_grow_memory: {
+         //the memory past the dirty size is already zero, and nothing past the current size can have been written
+         const uint64_t pages = memory_size / wasm_constraints::wasm_page_size;
+         const uint64_t delta = uint32_t(fp[ip->b]);
+         if(pages + delta > _module.max_memory_pages) {
+            fp[ip->a] = uint32_t(-1);
+         } else {
+            memory_size += delta * wasm_constraints::wasm_page_size;
+            ctx.memory_size = memory_size;
+            fp[ip->a] = pages;
+         }
+         NEXT();
+      }
+
+#define LOAD_HANDLER(name, T, R) \
+      op_##name: { \
+         const uint64_t address = uint64_t(uint32_t(fp[ip->b])) + ip->c; \
+         if(address + sizeof(T) > memory_size) \
+            trap("access violation"); \
+         T value; \
+         memcpy(&value, memory + address, sizeof(T)); \
+         fp[ip->a] = R(value); \
+         NEXT(); \
+      }
+      PREDECODED_LOAD_OPCODES(LOAD_HANDLER)
+#undef LOAD_HANDLER
+
+#define STORE_HANDLER(name, T) \
+      op_##name: { \
+         const uint64_t address = uint64_t(uint32_t(fp[ip->a])) + ip->c; \
+         if(address + sizeof(T) > memory_size) \
+            trap("access violation"); \
+         const T value = T(fp[ip->b]); \
+         memcpy(memory + address, &value, sizeof(T)); \
+         if(address + sizeof(T) > ctx.dirty_memory_size) \
+            ctx.dirty_memory_size = address + sizeof(T); \
+         NEXT(); \
+      }
+      PREDECODED_STORE_OPCODES(STORE_HANDLER)
+#undef STORE_HANDLER
+
+#define UNARY_HANDLER(name, T, expr) \
+      op_##name: { \
+         const T a = T(fp[ip->b]); \
+         fp[ip->a] = uint64_t(expr); \
+         NEXT(); \
+      }
+      PREDECODED_UNARY_OPCODES(UNARY_HANDLER)
+#undef UNARY_HANDLER
+
+#define BINARY_HANDLER(name, T, expr) \
+      op_##name: { \
+         const T l = T(fp[ip->b]); \
+         const T r = T(fp[ip->c]); \
+         fp[ip->a] = T(expr); \
+         NEXT(); \
+      }
+      PREDECODED_BINARY_OPCODES(BINARY_HANDLER)
+#undef BINARY_HANDLER
+
+#define DIVISION_HANDLER(name, T) \
+      op_##name: { \
+         const T l = T(fp[ip->b]); \
+         const T r = T(fp[ip->c]); \
+         if(r == 0) \
+            trap("integer divide by zero"); \
+         fp[ip->a] = std::make_unsigned_t<T>(divide<T>(opcode::op_##name, l, r)); \
+         NEXT(); \
+      }
+      PREDECODED_DIVISION_OPCODES(DIVISION_HANDLER)
+#undef DIVISION_HANDLER
+
+#undef NEXT
+#undef DISPATCH
+      }
+
+      /// the divisor is not zero
+      template<typename T>
+      static T divide(opcode op, T l, T r) {
+         const bool remainder = op == op_i32_rem_s || op == op_i32_rem_u || op == op_i64_rem_s || op == op_i64_rem_u;
+         if(std::is_signed<T>::value && r == T(-1)) {
+            if(remainder)
+               return 0;
+            if(l == std::numeric_limits<T>::min())
+               trap("integer overflow");
+         }
+         return remainder ? l % r : l / r;
+      }
+
+      predecoded_runtime::execution_state&   _state;
+      translated_module                      _module;
+      std::vector<uint8_t>                   _initial_memory;
+      std::vector<uint64_t>                  _globals;
+};
+
+predecoded_runtime::execution_state::execution_state()
+//pages of the memory are only committed once they are written
+:memory((char*)std::calloc(wasm_constraints::maximum_linear_memory, 1), &std::free)
+{
+   ENU_ASSERT(memory, wasm_exception, "unable to allocate the linear memory");
+   context.memory = memory.get();
+}
+
+predecoded_runtime::predecoded_runtime() {
+
+}
+
+std::unique_ptr<wasm_instantiated_module_interface> predecoded_runtime::instantiate_module(const char* code_bytes, size_t code_size, std::vector<uint8_t> initial_memory) {
+   Module module;
+   try {
+      Serialization::MemoryInputStream stream((const U8*)code_bytes, code_size);
+      WASM::serialize(stream, module);
+   } catch(const Serialization::FatalSerializationException& e) {
+      ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
+   } catch(const IR::ValidationException& e) {
+      ENU_ASSERT(false, wasm_serialization_error, e.message.c_str());
+   }
+
+   return std::make_unique<predecoded_instantiated_module>(_state, translate_module(module), std::move(initial_memory));
+}
+
+}}}}
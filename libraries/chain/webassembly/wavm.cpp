@@ -13,6 +13,7 @@
 #include "Runtime/Intrinsics.h"
 
 #include <mutex>
+#include <set>
 
 using namespace IR;
 using namespace Runtime;
@@ -21,14 +22,30 @@ namespace enumivo { namespace chain { namespace webassembly { namespace wavm {
 
 running_instance_context the_running_instance_context;
 
+//instances of every live wavm_instantiated_module, of all runtimes; the roots WAVM's garbage collection starts from
+static std::set<ModuleInstance*> __live_instances;
+static std::mutex __live_instances_lock;
+//held while instances are created and while garbage is collected, so an instance is not collected before it is a root
+static std::mutex __collect_lock;
+
 class wavm_instantiated_module : public wasm_instantiated_module_interface {
    public:
       wavm_instantiated_module(ModuleInstance* instance, std::unique_ptr<Module> module, std::vector<uint8_t> initial_mem) :
          _initial_memory(initial_mem),
          _instance(instance),
-         _module(std::move(module))
+         _module(std::move(module)),
+         _compiled_code_size(getCompiledCodeSize(instance))
       {}
 
+      ~wavm_instantiated_module() {
+         std::lock_guard<std::mutex> l(__live_instances_lock);
+         __live_instances.erase(_instance);
+      }
+
+      size_t memory_usage()const override {
+         return _compiled_code_size + _initial_memory.size();
+      }
+
       void apply(apply_context& context) override {
          vector<Value> args = {Value(uint64_t(context.receiver)),
 	                       Value(uint64_t(context.act.account)),
@@ -50,15 +67,13 @@ class wavm_instantiated_module : public wasm_instantiated_module_interface {
             // that didn't declare "memory", getDefaultMemory() won't see it
             MemoryInstance* default_mem = getDefaultMemory(_instance);
             if(default_mem) {
-               //reset memory resizes the sandbox'ed memory to the module's init memory size and then
-               // (effectively) memzeros it all
-               resetMemory(default_mem, _module->memories.defs[0].type);
-
-               char* memstart = &memoryRef<char>(getDefaultMemory(_instance), 0);
-               memcpy(memstart, _initial_memory.data(), _initial_memory.size());
+               //reset memory resizes the sandbox'ed memory to the module's init memory size, (effectively) memzeros
+               // it all, and copies in the initial data; the pages past the first are zeroed as they are touched
+               resetMemory(default_mem, _module->memories.defs[0].type, _initial_memory.data(), _initial_memory.size());
             }
 
             the_running_instance_context.memory = default_mem;
+            the_running_instance_context.memory_base = default_mem ? (char*)getMemoryBaseAddress(default_mem) : nullptr;
             the_running_instance_context.apply_ctx = &context;
 
             resetGlobalInstances(_instance);
@@ -76,9 +91,11 @@ class wavm_instantiated_module : public wasm_instantiated_module_interface {
 
       std::vector<uint8_t>     _initial_memory;
       //naked pointer because ModuleInstance is opaque
-      //_instance is deleted via WAVM's object garbage collection when wavm_rutime is deleted
+      //_instance is deleted via WAVM's object garbage collection, by free_unreferenced_modules() once this module is
+      //destroyed or when the last wavm_runtime is deleted
       ModuleInstance*          _instance;
       std::unique_ptr<Module>  _module;
+      size_t                   _compiled_code_size;
 };
 
 
@@ -108,6 +125,19 @@ wavm_runtime::wavm_runtime() {
 wavm_runtime::~wavm_runtime() {
 }
 
+void wavm_runtime::free_unreferenced_modules() {
+   //a module being compiled in the background holds the lock for a while; its garbage is collected the next time instead
+   std::unique_lock<std::mutex> collect(__collect_lock, std::try_to_lock);
+   if(!collect.owns_lock())
+      return;
+   std::vector<ObjectInstance*> roots;
+   {
+      std::lock_guard<std::mutex> l(__live_instances_lock);
+      roots.assign(__live_instances.begin(), __live_instances.end());
+   }
+   Runtime::freeUnreferencedObjects(std::move(roots));
+}
+
 std::unique_ptr<wasm_instantiated_module_interface> wavm_runtime::instantiate_module(const char* code_bytes, size_t code_size, std::vector<uint8_t> initial_memory) {
    std::unique_ptr<Module> module = std::make_unique<Module>();
    try {
@@ -121,8 +151,15 @@ std::unique_ptr<wasm_instantiated_module_interface> wavm_runtime::instantiate_mo
 
    enumivo::chain::webassembly::common::root_resolver resolver;
    LinkResult link_result = linkModule(*module, resolver);
-   ModuleInstance *instance = instantiateModule(*module, std::move(link_result.resolvedImports));
-   ENU_ASSERT(instance != nullptr, wasm_exception, "Fail to Instantiate WAVM Module");
+   ModuleInstance *instance = nullptr;
+   {
+      //the instance becomes a root under the lock garbage collection runs under, so it cannot be collected before
+      std::lock_guard<std::mutex> collect(__collect_lock);
+      instance = instantiateModule(*module, std::move(link_result.resolvedImports));
+      ENU_ASSERT(instance != nullptr, wasm_exception, "Fail to Instantiate WAVM Module");
+      std::lock_guard<std::mutex> l(__live_instances_lock);
+      __live_instances.insert(instance);
+   }
 
    return std::make_unique<wavm_instantiated_module>(instance, std::move(module), initial_memory);
 }
@@ -84,6 +84,9 @@ namespace enumivo { namespace testing {
          void              init(bool push_genesis = true, db_read_mode read_mode = db_read_mode::SPECULATIVE);
          void              init(controller::config config);
 
+         /// the configuration init uses, with the blocks and state kept in dir, for tests setting up their own chains
+         static controller::config default_config( const fc::path& dir );
+
          void              close();
          void              open();
          bool              is_same_chain( base_tester& other );
@@ -332,6 +335,8 @@ namespace enumivo { namespace testing {
                vcfg.wasm_runtime = chain::wasm_interface::vm_type::binaryen;
             else if(boost::unit_test::framework::master_test_suite().argv[i] == std::string("--wavm"))
                vcfg.wasm_runtime = chain::wasm_interface::vm_type::wavm;
+            else if(boost::unit_test::framework::master_test_suite().argv[i] == std::string("--predecoded"))
+               vcfg.wasm_runtime = chain::wasm_interface::vm_type::predecoded;
          }
 
 
@@ -82,15 +82,15 @@ namespace enumivo { namespace testing {
      return control->head_block_id() == other.control->head_block_id();
    }
 
-   void base_tester::init(bool push_genesis, db_read_mode read_mode) {
-      cfg.blocks_dir      = tempdir.path() / config::default_blocks_dir_name;
-      cfg.state_dir  = tempdir.path() / config::default_state_dir_name;
+   controller::config base_tester::default_config( const fc::path& dir ) {
+      controller::config cfg;
+      cfg.blocks_dir      = dir / config::default_blocks_dir_name;
+      cfg.state_dir  = dir / config::default_state_dir_name;
       cfg.state_size = 1024*1024*8;
       cfg.state_guard_size = 0;
       cfg.reversible_cache_size = 1024*1024*8;
       cfg.reversible_guard_size = 0;
       cfg.contracts_console = true;
-      cfg.read_mode = read_mode;
 
       cfg.genesis.initial_timestamp = fc::time_point::from_iso_string("2020-01-01T00:00:00.000");
       cfg.genesis.initial_key = get_public_key( config::system_account_name, "active" );
@@ -100,9 +100,17 @@ namespace enumivo { namespace testing {
             cfg.wasm_runtime = chain::wasm_interface::vm_type::binaryen;
          else if(boost::unit_test::framework::master_test_suite().argv[i] == std::string("--wavm"))
             cfg.wasm_runtime = chain::wasm_interface::vm_type::wavm;
+         else if(boost::unit_test::framework::master_test_suite().argv[i] == std::string("--predecoded"))
+            cfg.wasm_runtime = chain::wasm_interface::vm_type::predecoded;
          else
             cfg.wasm_runtime = chain::wasm_interface::vm_type::binaryen;
       }
+      return cfg;
+   }
+
+   void base_tester::init(bool push_genesis, db_read_mode read_mode) {
+      cfg = default_config( tempdir.path() );
+      cfg.read_mode = read_mode;
 
       open();
 
@@ -210,9 +210,13 @@ namespace Runtime
 	RUNTIME_API uint64_t getDefaultMemorySize(ModuleInstance* moduleInstance);
 	RUNTIME_API TableInstance* getDefaultTable(ModuleInstance* moduleInstance);
 
+	// Gets the number of bytes of native code the module's functions were compiled to.
+	RUNTIME_API Uptr getCompiledCodeSize(ModuleInstance* moduleInstance);
+
 	RUNTIME_API void runInstanceStartFunc(ModuleInstance* moduleInstance);
 	RUNTIME_API void resetGlobalInstances(ModuleInstance* moduleInstance);
-	RUNTIME_API void resetMemory(MemoryInstance* memory, IR::MemoryType& newMemoryType);
+	// Resizes the memory to the type's minimum size, zeroes it, and copies initialData to its start.
+	RUNTIME_API void resetMemory(MemoryInstance* memory, IR::MemoryType& newMemoryType, const U8* initialData = nullptr, Uptr numInitialDataBytes = 0);
 
 	// Gets an object exported by a ModuleInstance by name.
 	RUNTIME_API ObjectInstance* getInstanceExport(ModuleInstance* moduleInstance,const std::string& name);
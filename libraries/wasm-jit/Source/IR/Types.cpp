@@ -1,4 +1,5 @@
 #include "Types.h"
+#include "Platform/Platform.h"
 
 #include <map>
 
@@ -20,11 +21,19 @@ namespace IR
 			static std::map<Key,FunctionType*> map;
 			return map;
 		}
+
+		// Modules are deserialized and validated on more than one thread, so the map is shared between them.
+		static Platform::Mutex* getMutex()
+		{
+			static Platform::Mutex* mutex = Platform::createMutex();
+			return mutex;
+		}
 	};
 
 	template<typename Key,typename Value,typename CreateValueThunk>
-	Value findExistingOrCreateNew(std::map<Key,Value>& map,Key&& key,CreateValueThunk createValueThunk)
+	Value findExistingOrCreateNew(std::map<Key,Value>& map,Platform::Mutex* mutex,Key&& key,CreateValueThunk createValueThunk)
 	{
+		Platform::Lock lock(mutex);
 		auto mapIt = map.find(key);
 		if(mapIt != map.end()) { return mapIt->second; }
 		else
@@ -36,9 +45,9 @@ namespace IR
 	}
 
 	const FunctionType* FunctionType::get(ResultType ret,const std::initializer_list<ValueType>& parameters)
-	{ return findExistingOrCreateNew(FunctionTypeMap::get(),FunctionTypeMap::Key {ret,parameters},[=]{return new FunctionType(ret,parameters);}); }
+	{ return findExistingOrCreateNew(FunctionTypeMap::get(),FunctionTypeMap::getMutex(),FunctionTypeMap::Key {ret,parameters},[=]{return new FunctionType(ret,parameters);}); }
 	const FunctionType* FunctionType::get(ResultType ret,const std::vector<ValueType>& parameters)
-	{ return findExistingOrCreateNew(FunctionTypeMap::get(),FunctionTypeMap::Key {ret,parameters},[=]{return new FunctionType(ret,parameters);}); }
+	{ return findExistingOrCreateNew(FunctionTypeMap::get(),FunctionTypeMap::getMutex(),FunctionTypeMap::Key {ret,parameters},[=]{return new FunctionType(ret,parameters);}); }
 	const FunctionType* FunctionType::get(ResultType ret)
-	{ return findExistingOrCreateNew(FunctionTypeMap::get(),FunctionTypeMap::Key {ret,{}},[=]{return new FunctionType(ret,{});}); }
+	{ return findExistingOrCreateNew(FunctionTypeMap::get(),FunctionTypeMap::getMutex(),FunctionTypeMap::Key {ret,{}},[=]{return new FunctionType(ret,{});}); }
 }
\ No newline at end of file
@@ -57,8 +57,12 @@ namespace LLVMJIT
 	std::map<Uptr,struct JITSymbol*> addressToSymbolMap;
 
 	// A map from function types to function indices in the invoke thunk unit.
+	Platform::Mutex* invokeThunkTypeToSymbolMapMutex = Platform::createMutex();
 	std::map<const FunctionType*,struct JITSymbol*> invokeThunkTypeToSymbolMap;
 
+	// Serializes use of the LLVM context, so modules may be compiled on other threads than the one invoking functions.
+	Platform::Mutex* compileMutex = Platform::createMutex();
+
 	// Information about a JIT symbol, used to map instruction pointers to descriptive names.
 	struct JITSymbol
 	{
@@ -612,6 +616,8 @@ namespace LLVMJIT
 
 	void instantiateModule(const IR::Module& module,ModuleInstance* moduleInstance)
 	{
+		Platform::Lock compileLock(compileMutex);
+
 		// Emit LLVM IR for the module.
 		auto llvmModule = emitModule(module,moduleInstance);
 
@@ -623,6 +629,15 @@ namespace LLVMJIT
 		jitModule->compile(llvmModule);
 	}
 
+	Uptr getCompiledCodeSize(JITModuleBase* jitModuleBase)
+	{
+		JITModule* jitModule = dynamic_cast<JITModule*>(jitModuleBase);
+		if(!jitModule) { return 0; }
+		Uptr numBytes = 0;
+		for(auto symbol : jitModule->functionDefSymbols) { numBytes += symbol->numBytes; }
+		return numBytes;
+	}
+
 	std::string getExternalFunctionName(ModuleInstance* moduleInstance,Uptr functionDefIndex)
 	{
 		WAVM_ASSERT_THROW(functionDefIndex < moduleInstance->functionDefs.size());
@@ -687,8 +702,19 @@ namespace LLVMJIT
 	InvokeFunctionPointer getInvokeThunk(const FunctionType* functionType)
 	{
 		// Reuse cached invoke thunks for the same function type.
-		auto mapIt = invokeThunkTypeToSymbolMap.find(functionType);
-		if(mapIt != invokeThunkTypeToSymbolMap.end()) { return reinterpret_cast<InvokeFunctionPointer>(mapIt->second->baseAddress); }
+		{
+			Platform::Lock invokeThunkLock(invokeThunkTypeToSymbolMapMutex);
+			auto mapIt = invokeThunkTypeToSymbolMap.find(functionType);
+			if(mapIt != invokeThunkTypeToSymbolMap.end()) { return reinterpret_cast<InvokeFunctionPointer>(mapIt->second->baseAddress); }
+		}
+
+		// Only a missing thunk waits for the module being compiled, if any.
+		Platform::Lock compileLock(compileMutex);
+		{
+			Platform::Lock invokeThunkLock(invokeThunkTypeToSymbolMapMutex);
+			auto mapIt = invokeThunkTypeToSymbolMap.find(functionType);
+			if(mapIt != invokeThunkTypeToSymbolMap.end()) { return reinterpret_cast<InvokeFunctionPointer>(mapIt->second->baseAddress); }
+		}
 
 		auto llvmModule = new llvm::Module("",context);
 		auto llvmFunctionType = llvm::FunctionType::get(
@@ -737,7 +763,10 @@ namespace LLVMJIT
 		jitUnit->compile(llvmModule);
 
 		WAVM_ASSERT_THROW(jitUnit->symbol);
-		invokeThunkTypeToSymbolMap[functionType] = jitUnit->symbol;
+		{
+			Platform::Lock invokeThunkLock(invokeThunkTypeToSymbolMapMutex);
+			invokeThunkTypeToSymbolMap[functionType] = jitUnit->symbol;
+		}
 
 		{
 			Platform::Lock addressToSymbolMapLock(addressToSymbolMapMutex);
@@ -88,15 +88,22 @@ namespace Runtime
 		return Uptr(memory->type.size.max);
 	}
 
-	void resetMemory(MemoryInstance* memory, MemoryType& newMemoryType) {
+	void resetMemory(MemoryInstance* memory, MemoryType& newMemoryType, const U8* initialData, Uptr numInitialDataBytes) {
+		// Decommitting the pages past the first discards them, so they read as zero once they are committed again.
+		// Only the pages that were touched cost anything to discard, and only the ones touched again cost a page fault.
 		memory->type.size.min = 1;
 		if(shrinkMemory(memory, memory->numPages - 1) == -1)
 			causeException(Exception::Cause::outOfMemory);
-		memset(memory->baseAddress, 0, 1<<IR::numBytesPerPageLog2);
 		memory->type = newMemoryType;
 		if(growMemory(memory, memory->type.size.min - 1) == -1)
 			causeException(Exception::Cause::outOfMemory);
-   }
+
+		// The first page is nearly always touched, so it is overwritten rather than discarded.
+		const Uptr numFirstPageBytes = Uptr(1)<<IR::numBytesPerPageLog2;
+		WAVM_ASSERT_THROW(numInitialDataBytes <= (memory->numPages << IR::numBytesPerPageLog2));
+		if(numInitialDataBytes) { memcpy(memory->baseAddress, initialData, numInitialDataBytes); }
+		if(numInitialDataBytes < numFirstPageBytes) { memset(memory->baseAddress + numInitialDataBytes, 0, numFirstPageBytes - numInitialDataBytes); }
+	}
 
 	Iptr growMemory(MemoryInstance* memory,Uptr numNewPages)
 	{
@@ -114,7 +121,7 @@ namespace Runtime
 			{
 				return -1;
 			}
-			memset(memory->baseAddress + (memory->numPages << IR::numBytesPerPageLog2), 0, numNewPages << IR::numBytesPerPageLog2);
+			// The pages are zero: they were either never committed or discarded when they were decommitted.
 			memory->numPages += numNewPages;
 		}
 		return previousNumPages;
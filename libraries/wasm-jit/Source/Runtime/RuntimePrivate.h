@@ -21,6 +21,7 @@ namespace LLVMJIT
 
 	void init();
 	void instantiateModule(const IR::Module& module,Runtime::ModuleInstance* moduleInstance);
+	Uptr getCompiledCodeSize(JITModuleBase* jitModule);
 	bool describeInstructionPointer(Uptr ip,std::string& outDescription);
 	
 	typedef void (*InvokeFunctionPointer)(void*,U64*);
@@ -995,6 +995,8 @@ namespace enumivo {
            }
            status( "received block " + std::to_string(b->block_num()) );
            //ilog( "recv block ${n}", ("n", b->block_num()) );
+           // start recovering the transaction signatures while the block waits for the main thread
+           app().get_plugin<chain_plugin>().chain().prepare_block( b );
            auto id = b->id();
            mark_block_status( id, true, true );
 
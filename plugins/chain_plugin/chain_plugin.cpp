@@ -5,6 +5,8 @@
 #include <enumivo/chain_plugin/chain_plugin.hpp>
 #include <enumivo/chain/fork_database.hpp>
 #include <enumivo/chain/block_log.hpp>
+#include <enumivo/chain/snapshot.hpp>
+#include <enumivo/chain/signature_recovery_cache.hpp>
 #include <enumivo/chain/exceptions.hpp>
 #include <enumivo/chain/authorization_manager.hpp>
 #include <enumivo/chain/producer_object.hpp>
@@ -72,6 +74,40 @@ void validate(boost::any& v,
   }
 }
 
+std::ostream& operator<<(std::ostream& osm, enumivo::chain::block_log_sync_mode m) {
+   if ( m == enumivo::chain::block_log_sync_mode::none ) {
+      osm << "none";
+   } else if ( m == enumivo::chain::block_log_sync_mode::flush ) {
+      osm << "flush";
+   } else if ( m == enumivo::chain::block_log_sync_mode::fdatasync ) {
+      osm << "fdatasync";
+   }
+
+   return osm;
+}
+
+void validate(boost::any& v,
+              std::vector<std::string> const& values,
+              enumivo::chain::block_log_sync_mode* /* target_type */,
+              int)
+{
+  using namespace boost::program_options;
+
+  validators::check_first_occurrence(v);
+
+  std::string const& s = validators::get_single_string(values);
+
+  if ( s == "none" ) {
+     v = boost::any(enumivo::chain::block_log_sync_mode::none);
+  } else if ( s == "flush" ) {
+     v = boost::any(enumivo::chain::block_log_sync_mode::flush);
+  } else if ( s == "fdatasync" ) {
+     v = boost::any(enumivo::chain::block_log_sync_mode::fdatasync);
+  } else {
+     throw validation_error(validation_error::invalid_option_value);
+  }
+}
+
 }
 
 using namespace enumivo;
@@ -176,13 +212,56 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          ("blocks-dir", bpo::value<bfs::path>()->default_value("blocks"),
           "the location of the blocks directory (absolute path or relative to application data dir)")
          ("checkpoint", bpo::value<vector<string>>()->composing(), "Pairs of [BLOCK_NUM,BLOCK_ID] that should be enforced as checkpoints.")
-         ("wasm-runtime", bpo::value<enumivo::chain::wasm_interface::vm_type>()->value_name("wavm/binaryen"), "Override default WASM runtime")
+         ("wasm-runtime", bpo::value<enumivo::chain::wasm_interface::vm_type>()->value_name("wavm/binaryen/predecoded"), "Override default WASM runtime")
+         ("wasm-cache-dir", bpo::value<bfs::path>()->default_value(config::default_wasm_cache_dir_name),
+          "the location of the directory injected contract code is kept in across restarts (absolute path or relative to application data dir, empty to disable)")
+         ("wasm-instantiation-cache-size-mb", bpo::value<uint64_t>()->default_value(config::default_wasm_instantiation_cache_size / (1024 * 1024)),
+          "Maximum size (in MiB) of the compiled code and initial memory of the contracts kept instantiated in memory")
+         ("wasm-compile-threads", bpo::value<uint32_t>()->default_value(config::default_wasm_compile_threads),
+          "Number of threads compiling contracts in the background when their code is set and at startup (wavm only, 0 disables it). "
+          "At most 1, as LLVM compiles one contract at a time")
+         ("wasm-precompile-contracts", bpo::value<uint32_t>()->default_value(config::default_wasm_precompile_contracts),
+          "Number of the most used contracts compiled in the background at startup")
          ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_ms),
           "Override default maximum ABI serialization time allowed in ms")
          ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024  * 1024)), "Maximum size (in MiB) of the chain state database")
          ("chain-state-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_guard_size / (1024  * 1024)), "Safely shut down node when free space remaining in the chain state database drops below this size (in MiB).")
          ("reversible-blocks-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_reversible_cache_size / (1024  * 1024)), "Maximum size (in MiB) of the reversible blocks database")
          ("reversible-blocks-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_reversible_guard_size / (1024  * 1024)), "Safely shut down node when free space remaining in the reverseible blocks database drops below this size (in MiB).")
+         ("block-log-sync-mode", bpo::value<enumivo::chain::block_log_sync_mode>()->default_value(enumivo::chain::block_log_sync_mode::flush),
+          "How appended irreversible blocks are written to the block log (\"none\", \"flush\" or \"fdatasync\").\n"
+          "Every block is flushed to the block log as soon as it becomes irreversible.\n"
+          "In \"flush\" and \"none\" mode the block log is never synchronized to disk.\n"
+          "In \"fdatasync\" mode the block log is synchronized to disk once per batch.\n")
+         ("block-log-batch-blocks", bpo::value<uint32_t>()->default_value(config::default_block_log_batch_blocks),
+          "Maximum number of blocks in a block log batch (\"fdatasync\" mode only)")
+         ("block-log-batch-ms", bpo::value<uint32_t>()->default_value(config::default_block_log_batch_interval_ms),
+          "Maximum time in milliseconds a block may wait in a block log batch before the batch ends (\"fdatasync\" mode only)")
+         ("blocks-log-stride", bpo::value<uint32_t>()->default_value(0),
+          "Split the block log into files of this many blocks; the current file is sealed and renamed to blocks-<first>-<last>.log "
+          "whenever the block number reaches a multiple of the stride (0 keeps a single block log file)")
+         ("max-retained-block-files", bpo::value<uint32_t>()->default_value(std::numeric_limits<uint32_t>::max()),
+          "Maximum number of sealed block log files kept in the blocks directory when blocks-log-stride is set")
+         ("blocks-archive-dir", bpo::value<bfs::path>()->default_value(config::default_blocks_archive_dir_name),
+          "the location of the directory sealed block log files are moved to once there are more than max-retained-block-files "
+          "of them (absolute path or relative to the blocks dir); if empty, those files are deleted instead")
+         ("replay-read-ahead-blocks", bpo::value<uint32_t>()->default_value(config::default_replay_read_ahead_blocks),
+          "Maximum number of blocks read from the block log ahead of the block being applied during a replay")
+         ("replay-read-ahead-threads", bpo::value<uint32_t>()->default_value(config::default_replay_read_ahead_threads),
+          "Number of threads reading blocks from the block log ahead of the block being applied during a replay (0 to read them on the main thread)")
+         ("signature-recovery-threads", bpo::value<uint32_t>()->default_value(config::default_signature_recovery_threads),
+          "Number of threads recovering the signing keys of transactions in blocks before the blocks are applied (0 to recover them while applying)")
+         ("signature-recovery-cache-size", bpo::value<uint64_t>()->default_value(config::default_signature_recovery_cache_size),
+          "Maximum number of recovered transaction signing keys remembered so they are not recovered again when a received transaction is applied (0 to disable)")
+         ("merkle-threads", bpo::value<uint32_t>()->default_value(config::default_merkle_threads),
+          "Number of threads hashing the action receipts of transactions with many actions into the action merkle of a block (0 to hash them while applying)")
+         ("replay-profile", bpo::value<bfs::path>(),
+          "Write the time spent on every block, the transaction totals and the totals of every action (by receiver, contract "
+          "and action name) during a replay of the block log to this file, as CSV if its name ends in .csv and as JSON otherwise")
+         ("replay-profile-slowest-blocks", bpo::value<uint32_t>()->default_value(config::default_replay_profile_slowest_blocks),
+          "Number of slowest blocks listed in the replay profile")
+         ("block-log-compression-chunk", bpo::value<uint32_t>()->default_value(0),
+          "Compress sealed block log files in zlib compressed chunks of this many blocks as they are sealed (0 to leave them uncompressed)")
          ("contracts-console", bpo::bool_switch()->default_value(false),
           "print contract's output to console")
          ("actor-whitelist", boost::program_options::value<vector<string>>()->composing()->multitoken(),
@@ -216,6 +295,12 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
 
    cli.add_options()
          ("genesis-json", bpo::value<bfs::path>(), "File to read Genesis State from")
+         ("snapshot", bpo::value<bfs::path>(),
+          "File to read the chain state from; replaces the chain state database, after which only the blocks of the block log "
+          "following the snapshot are replayed")
+         ("export-snapshot", bpo::value<bfs::path>(),
+          "write a snapshot of the chain state as of the head block into the specified file and then exit; if the head block "
+          "is reversible, the node keeps running until it is irreversible")
          ("genesis-timestamp", bpo::value<string>(), "override the initial timestamp in the Genesis State file")
          ("print-genesis-json", bpo::bool_switch()->default_value(false),
           "extract genesis_state from blocks.log as JSON, print to console, and exit")
@@ -237,6 +322,9 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "replace reversible block database with blocks imported from specified file and then exit")
          ("export-reversible-blocks", bpo::value<bfs::path>(),
            "export reversible block database in portable format into specified file and then exit")
+         ("compress-block-log", bpo::bool_switch()->default_value(false),
+          "convert the block log, including sealed and archived block log files, to the compressed format and then exit; "
+          "uses the chunk size of block-log-compression-chunk, or 64 blocks if that is not set")
          ;
 
 }
@@ -358,6 +446,72 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
       if( my->wasm_runtime )
          my->chain_config->wasm_runtime = *my->wasm_runtime;
 
+      if( options.count( "wasm-instantiation-cache-size-mb" ))
+         my->chain_config->wasm_instantiation_cache_size = options.at( "wasm-instantiation-cache-size-mb" ).as<uint64_t>() * 1024 * 1024;
+
+      if( options.count( "wasm-compile-threads" )) {
+         my->chain_config->wasm_compile_threads = options.at( "wasm-compile-threads" ).as<uint32_t>();
+         ENU_ASSERT( my->chain_config->wasm_compile_threads <= 1, plugin_config_exception,
+                     "wasm-compile-threads ${num} must be 0 or 1", ("num", my->chain_config->wasm_compile_threads) );
+      }
+
+      if( options.count( "wasm-precompile-contracts" ))
+         my->chain_config->wasm_precompile_contracts = options.at( "wasm-precompile-contracts" ).as<uint32_t>();
+
+      if( options.count( "wasm-cache-dir" )) {
+         auto wcd = options.at( "wasm-cache-dir" ).as<bfs::path>();
+         if( !wcd.empty() && wcd.is_relative())
+            my->chain_config->wasm_cache_dir = app().data_dir() / wcd;
+         else
+            my->chain_config->wasm_cache_dir = wcd;
+      }
+
+      if( options.count( "block-log-sync-mode" ))
+         my->chain_config->block_log_sync = options.at( "block-log-sync-mode" ).as<block_log_sync_mode>();
+
+      if( options.count( "block-log-batch-blocks" ))
+         my->chain_config->block_log_batch_blocks = options.at( "block-log-batch-blocks" ).as<uint32_t>();
+
+      if( options.count( "block-log-batch-ms" ))
+         my->chain_config->block_log_batch_interval_ms = options.at( "block-log-batch-ms" ).as<uint32_t>();
+
+      if( options.count( "blocks-log-stride" ))
+         my->chain_config->blocks_log_stride = options.at( "blocks-log-stride" ).as<uint32_t>();
+
+      if( options.count( "max-retained-block-files" ))
+         my->chain_config->max_retained_block_files = options.at( "max-retained-block-files" ).as<uint32_t>();
+
+      if( options.count( "blocks-archive-dir" ))
+         my->chain_config->blocks_archive_dir = options.at( "blocks-archive-dir" ).as<bfs::path>();
+
+      if( options.count( "replay-read-ahead-blocks" ))
+         my->chain_config->replay_read_ahead_blocks = options.at( "replay-read-ahead-blocks" ).as<uint32_t>();
+
+      if( options.count( "replay-read-ahead-threads" ))
+         my->chain_config->replay_read_ahead_threads = options.at( "replay-read-ahead-threads" ).as<uint32_t>();
+
+      if( options.count( "signature-recovery-threads" ))
+         my->chain_config->signature_recovery_threads = options.at( "signature-recovery-threads" ).as<uint32_t>();
+
+      if( options.count( "signature-recovery-cache-size" ))
+         my->chain_config->signature_recovery_cache_size = options.at( "signature-recovery-cache-size" ).as<uint64_t>();
+
+      if( options.count( "merkle-threads" ))
+         my->chain_config->merkle_threads = options.at( "merkle-threads" ).as<uint32_t>();
+
+      if( options.count( "replay-profile" )) {
+         auto profile_file = options.at( "replay-profile" ).as<bfs::path>();
+         if( profile_file.is_relative())
+            profile_file = bfs::current_path() / profile_file;
+         my->chain_config->replay_profile = profile_file;
+      }
+
+      if( options.count( "replay-profile-slowest-blocks" ))
+         my->chain_config->replay_profile_slowest_blocks = options.at( "replay-profile-slowest-blocks" ).as<uint32_t>();
+
+      if( options.count( "block-log-compression-chunk" ))
+         my->chain_config->block_log_compression_chunk = options.at( "block-log-compression-chunk" ).as<uint32_t>();
+
       my->chain_config->force_all_checks = options.at( "force-all-checks" ).as<bool>();
       my->chain_config->contracts_console = options.at( "contracts-console" ).as<bool>();
 
@@ -404,6 +558,14 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
          ENU_THROW( node_management_success, "exported reversible blocks" );
       }
 
+      if( options.at( "compress-block-log" ).as<bool>()) {
+         auto chunk_blocks = my->chain_config->block_log_compression_chunk;
+         if( chunk_blocks == 0 )
+            chunk_blocks = config::default_block_log_compression_chunk_blocks;
+         block_log::compress_log( my->blocks_dir, chunk_blocks, my->chain_config->blocks_archive_dir );
+         ENU_THROW( node_management_success, "compressed block log" );
+      }
+
       if( options.at( "delete-all-blocks" ).as<bool>()) {
          ilog( "Deleting state database and blocks" );
          if( options.at( "truncate-at-block" ).as<uint32_t>() > 0 )
@@ -468,7 +630,34 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
          wlog("The --import-reversible-blocks option should be used by itself.");
       }
 
-      if( options.count( "genesis-json" )) {
+      if( options.count( "snapshot" )) {
+         ENU_ASSERT( !options.count( "genesis-json" ) && !options.count( "genesis-timestamp" ),
+                     plugin_config_exception,
+                     "The genesis state is taken from the snapshot and can not be set along with it." );
+
+         auto snapshot_file = options.at( "snapshot" ).as<bfs::path>();
+         if( snapshot_file.is_relative()) {
+            snapshot_file = bfs::current_path() / snapshot_file;
+         }
+
+         ENU_ASSERT( fc::is_regular_file( snapshot_file ),
+                     plugin_config_exception,
+                    "Specified snapshot file '${snapshot}' does not exist.",
+                    ("snapshot", snapshot_file.generic_string()));
+
+         auto header = snapshot::read_header( snapshot_file );
+         if( fc::is_regular_file( my->blocks_dir / "blocks.log" )) {
+            ENU_ASSERT( block_log::extract_genesis_state( my->blocks_dir ).compute_chain_id() == header.genesis.compute_chain_id(),
+                        plugin_config_exception,
+                        "Snapshot '${snapshot}' is of a different chain than the block log.",
+                        ("snapshot", snapshot_file.generic_string()));
+         }
+
+         ilog( "Starting from snapshot of block ${num}: deleting state database", ("num", header.head.block_num) );
+         fc::remove_all( my->chain_config->state_dir );
+         my->chain_config->snapshot = snapshot_file;
+         my->chain_config->genesis = header.genesis;
+      } else if( options.count( "genesis-json" )) {
          ENU_ASSERT( !fc::exists( my->blocks_dir / "blocks.log" ),
                      plugin_config_exception,
                     "Genesis state can only be set on a fresh blockchain." );
@@ -516,6 +705,28 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
       my->chain.emplace( *my->chain_config );
       my->chain_id.emplace( my->chain->get_chain_id());
 
+      if( options.count( "export-snapshot" )) {
+         auto p = options.at( "export-snapshot" ).as<bfs::path>();
+
+         if( p.is_relative()) {
+            p = bfs::current_path() / p;
+         }
+
+         my->chain->startup();
+         auto waiting = std::make_shared<bool>( false );
+         bool written = false;
+         my->chain->write_snapshot( p, [waiting, &written]() {
+            if( *waiting )
+               app().quit();
+            else
+               written = true;
+         } );
+         if( written )
+            ENU_THROW( node_management_success, "exported snapshot" );
+         *waiting = true;
+         ilog( "Head block is reversible, the snapshot is exported once it is irreversible" );
+      }
+
       // set up method providers
       my->get_block_by_number_provider = app().get_method<methods::get_block_by_number>().register_provider(
             [this]( uint32_t block_num ) -> signed_block_ptr {
@@ -610,7 +821,17 @@ void chain_plugin::plugin_shutdown() {
    my->accepted_transaction_connection.reset();
    my->applied_transaction_connection.reset();
    my->accepted_confirmation_connection.reset();
+   if( my->chain ) {
+      auto wasm_metrics = my->chain->get_wasm_interface().get_instantiation_cache_metrics();
+      ilog( "wasm instantiation cache: ${hits} hits, ${misses} misses, ${evictions} evictions, ${size} contracts in ${memory} bytes",
+            ("hits", wasm_metrics.hits)("misses", wasm_metrics.misses)("evictions", wasm_metrics.evictions)
+            ("size", wasm_metrics.size)("memory", wasm_metrics.memory) );
+   }
    my->chain.reset();
+
+   auto recovery_metrics = signature_recovery_cache::instance().get_metrics();
+   ilog( "signature recovery cache: ${hits} hits, ${misses} misses, ${evictions} evictions",
+         ("hits", recovery_metrics.hits)("misses", recovery_metrics.misses)("evictions", recovery_metrics.evictions) );
 }
 
 chain_apis::read_write chain_plugin::get_read_write_api() {
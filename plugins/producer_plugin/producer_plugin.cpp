@@ -13,6 +13,7 @@
 #include <fc/scoped_exit.hpp>
 
 #include <boost/asio.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include <iostream>
@@ -331,12 +332,71 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          }
       }
 
-      std::deque<std::tuple<packed_transaction_ptr, bool, next_function<transaction_trace_ptr>>> _pending_incoming_transactions;
+      std::deque<std::tuple<packed_transaction_ptr, transaction_metadata_ptr, bool, next_function<transaction_trace_ptr>>> _pending_incoming_transactions;
+
+      /*
+       * Unpacking an incoming transaction and recovering its signing keys is done on the incoming transaction
+       * threads when there are any, leaving only its execution to the application thread. The transaction is
+       * handed back to the application thread once its keys are recovered, and waits there until every
+       * transaction received before it has been handed back too, so transactions are executed in the order they
+       * arrived no matter which thread finishes first.
+       */
+      std::unique_ptr<boost::asio::thread_pool>                _incoming_transaction_thread_pool;
+
+      struct incoming_transaction_recovery {
+         packed_transaction_ptr                  trx;
+         transaction_metadata_ptr                mtrx;
+         bool                                    persist_until_expired = false;
+         next_function<transaction_trace_ptr>    next;
+         bool                                    recovered = false;
+      };
+
+      /// transactions handed to the incoming transaction threads, in the order they arrived; application thread only
+      std::deque<std::shared_ptr<incoming_transaction_recovery>> _incoming_transactions_in_recovery;
 
       void on_incoming_transaction_async(const packed_transaction_ptr& trx, bool persist_until_expired, next_function<transaction_trace_ptr> next) {
+         if (!_incoming_transaction_thread_pool) {
+            process_incoming_transaction(trx, transaction_metadata_ptr(), persist_until_expired, next);
+            return;
+         }
+
+         auto recovery = std::make_shared<incoming_transaction_recovery>();
+         recovery->trx = trx;
+         recovery->persist_until_expired = persist_until_expired;
+         recovery->next = next;
+         _incoming_transactions_in_recovery.push_back(recovery);
+
+         auto chain_id = app().get_plugin<chain_plugin>().chain().get_chain_id();
+         boost::asio::post(*_incoming_transaction_thread_pool, [self = shared_from_this(), recovery, chain_id]() {
+            transaction_metadata_ptr mtrx;
+            try {
+               mtrx = std::make_shared<transaction_metadata>(*recovery->trx);
+               mtrx->recover_keys(chain_id);
+            } catch ( ... ) {
+               // the transaction is unpacked again on the application thread, which reports the error
+               mtrx.reset();
+            }
+            app().get_io_service().post([self, recovery, mtrx]() {
+               recovery->mtrx = mtrx;
+               recovery->recovered = true;
+               self->process_recovered_incoming_transactions();
+            });
+         });
+      }
+
+      /// processes the transactions at the front of the arrival order whose keys have been recovered
+      void process_recovered_incoming_transactions() {
+         while (!_incoming_transactions_in_recovery.empty() && _incoming_transactions_in_recovery.front()->recovered) {
+            auto recovery = _incoming_transactions_in_recovery.front();
+            _incoming_transactions_in_recovery.pop_front();
+            process_incoming_transaction(recovery->trx, recovery->mtrx, recovery->persist_until_expired, recovery->next);
+         }
+      }
+
+      void process_incoming_transaction(const packed_transaction_ptr& trx, transaction_metadata_ptr mtrx, bool persist_until_expired, next_function<transaction_trace_ptr> next) {
          chain::controller& chain = app().get_plugin<chain_plugin>().chain();
          if (!chain.pending_block_state()) {
-            _pending_incoming_transactions.emplace_back(trx, persist_until_expired, next);
+            _pending_incoming_transactions.emplace_back(trx, mtrx, persist_until_expired, next);
             return;
          }
 
@@ -370,10 +430,12 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          }
 
          try {
-            auto trace = chain.push_transaction(std::make_shared<transaction_metadata>(*trx), deadline);
+            if (!mtrx)
+               mtrx = std::make_shared<transaction_metadata>(*trx);
+            auto trace = chain.push_transaction(mtrx, deadline);
             if (trace->except) {
                if (failure_is_subjective(*trace->except, deadline_is_subjective)) {
-                  _pending_incoming_transactions.emplace_back(trx, persist_until_expired, next);
+                  _pending_incoming_transactions.emplace_back(trx, mtrx, persist_until_expired, next);
                } else {
                   auto e_ptr = trace->except->dynamic_copy_exception();
                   send_response(e_ptr);
@@ -485,6 +547,8 @@ void producer_plugin::set_program_options(
           "offset of last block producing time in micro second. Negative number results in blocks to go out sooner, and positive number results in blocks to go out later")
          ("incoming-defer-ratio", bpo::value<double>()->default_value(1.0),
           "ratio between incoming transations and deferred transactions when both are exhausted")
+         ("incoming-transaction-threads", bpo::value<uint32_t>()->default_value(config::default_incoming_transaction_threads),
+          "Number of threads unpacking incoming transactions and recovering their signing keys before they are executed (0 to do so on the main thread)")
          ;
    config_file_options.add(producer_options);
 }
@@ -607,6 +671,10 @@ void producer_plugin::plugin_initialize(const boost::program_options::variables_
 
    my->_incoming_defer_ratio = options.at("incoming-defer-ratio").as<double>();
 
+   auto incoming_transaction_threads = options.at("incoming-transaction-threads").as<uint32_t>();
+   if (incoming_transaction_threads > 0)
+      my->_incoming_transaction_thread_pool.reset( new boost::asio::thread_pool( incoming_transaction_threads ) );
+
    my->_incoming_block_subscription = app().get_channel<incoming::channels::block>().subscribe([this](const signed_block_ptr& block){
       try {
          my->on_incoming_block(block);
@@ -686,6 +754,11 @@ void producer_plugin::plugin_shutdown() {
 
    my->_accepted_block_connection.reset();
    my->_irreversible_block_connection.reset();
+
+   if( my->_incoming_transaction_thread_pool ) {
+      my->_incoming_transaction_thread_pool->stop();
+      my->_incoming_transaction_thread_pool->join();
+   }
 }
 
 void producer_plugin::pause() {
@@ -1019,7 +1092,7 @@ producer_plugin_impl::start_block_result producer_plugin_impl::start_block(bool
                   _pending_incoming_transactions.pop_front();
                   --orig_pending_txn_size;
                   _incoming_trx_weight -= 1.0;
-                  on_incoming_transaction_async(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+                  process_incoming_transaction(std::get<0>(e), std::get<1>(e), std::get<2>(e), std::get<3>(e));
                }
 
                if (block_time <= fc::time_point::now()) {
@@ -1068,7 +1141,7 @@ producer_plugin_impl::start_block_result producer_plugin_impl::start_block(bool
                auto e = _pending_incoming_transactions.front();
                _pending_incoming_transactions.pop_front();
                --orig_pending_txn_size;
-               on_incoming_transaction_async(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+               process_incoming_transaction(std::get<0>(e), std::get<1>(e), std::get<2>(e), std::get<3>(e));
                if (block_time <= fc::time_point::now()) return start_block_result::exhausted;
             }
             return start_block_result::succeeded;
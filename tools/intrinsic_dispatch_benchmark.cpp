@@ -0,0 +1,151 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+
+#include <enumivo/testing/tester.hpp>
+
+#include <iostream>
+#include <sstream>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+namespace {
+   const name bench_table = N(bench);
+
+   std::string name_const( name n ) {
+      return "(i64.const " + std::to_string( int64_t(uint64_t(n)) ) + ")";
+   }
+
+   /// an action that runs body calls times, with the iterator of the benchmark row in $itr
+   std::string action_loop( name action, uint32_t calls, const std::string& body ) {
+      return "(block $skip (br_if $skip (i64.ne (get_local $2) " + name_const( action ) + "))"
+             " (set_local $itr (call $db_find_i64 (get_local $0) (get_local $0) " + name_const( bench_table ) + " (i64.const 0)))"
+             " (set_local $i (i32.const " + std::to_string( calls ) + "))"
+             " (loop $again " + body +
+             " (br_if $again (tee_local $i (i32.sub (get_local $i) (i32.const 1))))))\n";
+   }
+
+   /**
+    * a contract whose actions each call one intrinsic in a loop; the data the intrinsics read and write is at the start
+    * of its memory
+    */
+   std::string benchmark_wast( uint32_t calls ) {
+      std::string wast = R"=====(
+(module
+  (import "env" "read_action_data" (func $read_action_data (param i32 i32) (result i32)))
+  (import "env" "require_auth" (func $require_auth (param i64)))
+  (import "env" "sha256" (func $sha256 (param i32 i32 i32)))
+  (import "env" "db_store_i64" (func $db_store_i64 (param i64 i64 i64 i64 i32 i32) (result i32)))
+  (import "env" "db_find_i64" (func $db_find_i64 (param i64 i64 i64 i64) (result i32)))
+  (import "env" "db_get_i64" (func $db_get_i64 (param i32 i32 i32) (result i32)))
+  (import "env" "db_update_i64" (func $db_update_i64 (param i32 i64 i32 i32)))
+  (table 0 anyfunc)
+  (memory $0 1)
+  (export "apply" (func $apply))
+  (func $apply (param $0 i64) (param $1 i64) (param $2 i64)
+    (local $i i32) (local $itr i32)
+    (block $skip (br_if $skip (i64.ne (get_local $2) )=====" + name_const( N(store) ) + R"=====())
+      (drop (call $db_store_i64 (get_local $0) )=====" + name_const( bench_table ) + R"=====( (get_local $0) (i64.const 0) (i32.const 0) (i32.const 32))))
+)=====";
+      wast += action_loop( N(empty), calls, "(nop)" );
+      wast += action_loop( N(readdata), calls, "(drop (call $read_action_data (i32.const 0) (i32.const 32)))" );
+      wast += action_loop( N(reqauth), calls, "(call $require_auth (get_local $0))" );
+      wast += action_loop( N(sha), calls, "(call $sha256 (i32.const 0) (i32.const 32) (i32.const 64))" );
+      wast += action_loop( N(dbfind), calls, "(drop (call $db_find_i64 (get_local $0) (get_local $0) " + name_const( bench_table ) + " (i64.const 0)))" );
+      wast += action_loop( N(dbget), calls, "(drop (call $db_get_i64 (get_local $itr) (i32.const 0) (i32.const 32)))" );
+      wast += action_loop( N(dbupdate), calls, "(call $db_update_i64 (get_local $itr) (get_local $0) (i32.const 0) (i32.const 32))" );
+      wast += "))";
+      return wast;
+   }
+}
+
+/**
+ * Measures the time of a call to the intrinsics contracts call the most, for each wasm runtime: every action of the
+ * benchmark contract calls one of them in a loop, and the time of a loop that calls nothing is subtracted
+ */
+int main(int argc, const char **argv) {
+
+   uint32_t calls  = 10000;
+   uint32_t rounds = 20;
+   std::vector<std::string> runtimes = { "wavm", "binaryen", "predecoded" };
+
+   po::options_description desc("Options");
+   desc.add_options()
+      ("help,h", "Print this help message and exit")
+      ("calls,c", po::value<uint32_t>(&calls)->default_value(calls), "calls of the intrinsic per action")
+      ("rounds,n", po::value<uint32_t>(&rounds)->default_value(rounds), "actions per intrinsic")
+      ("runtime,r", po::value<std::vector<std::string>>(&runtimes)->composing(), "runtimes to measure (wavm/binaryen/predecoded), all of them by default")
+   ;
+
+   po::variables_map vm;
+   po::store(po::parse_command_line(argc, argv, desc), vm);
+   po::notify(vm);
+
+   if( vm.count("help") || calls == 0 || rounds == 0 ) {
+      std::cout << desc << std::endl;
+      return 1;
+   }
+
+   fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::off);
+
+   const std::string wast = benchmark_wast( calls );
+   const vector<name> actions = { N(readdata), N(reqauth), N(sha), N(dbfind), N(dbget), N(dbupdate) };
+
+   for( const auto& runtime : runtimes ) {
+      fc::temp_directory tempdir;
+      controller::config cfg;
+      cfg.blocks_dir = tempdir.path() / config::default_blocks_dir_name;
+      cfg.state_dir  = tempdir.path() / config::default_state_dir_name;
+      cfg.state_size = 1024*1024*64;
+      cfg.state_guard_size = 0;
+      cfg.reversible_cache_size = 1024*1024*64;
+      cfg.reversible_guard_size = 0;
+      cfg.genesis.initial_timestamp = fc::time_point::from_iso_string("2020-01-01T00:00:00.000");
+      cfg.genesis.initial_key = base_tester::get_public_key( config::system_account_name, "active" );
+      std::istringstream in( runtime );
+      in >> cfg.wasm_runtime;
+      if( !in ) {
+         std::cerr << "unknown runtime " << runtime << std::endl;
+         return 1;
+      }
+
+      tester chain( cfg );
+      chain.create_accounts( { N(bench) } );
+      chain.set_code( N(bench), wast.c_str() );
+      chain.produce_block();
+
+      uint32_t nonce = 0;
+      auto run = [&]( name action ) {
+         signed_transaction trx;
+         trx.actions.emplace_back( vector<permission_level>{{N(bench), config::active_name}}, N(bench), action,
+                                   fc::raw::pack( nonce++ ) );
+         chain.set_transaction_headers( trx );
+         trx.sign( chain.get_private_key( N(bench), "active" ), chain.control->get_chain_id() );
+         auto trace = chain.push_transaction( trx );
+         chain.produce_block();
+         return trace->action_traces.front().elapsed;
+      };
+      run( N(store) );
+
+      auto measure = [&]( name action ) {
+         fc::microseconds total;
+         for( uint32_t i = 0; i < rounds; ++i )
+            total += run( action );
+         return double(total.count()) / rounds;
+      };
+      const double empty = measure( N(empty) );
+
+      std::cout << runtime << ":" << std::endl;
+      for( auto action : actions ) {
+         const double per_call_ns = ( measure( action ) - empty ) * 1000 / calls;
+         std::cout << "   " << action.to_string() << ": " << per_call_ns << " ns per call" << std::endl;
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,94 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+
+#include <enumivo/chain/merkle.hpp>
+#include <enumivo/chain/action_receipt.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+using namespace enumivo::chain;
+
+/**
+ * Measures the time to accumulate the action merkle root of a transaction with many actions, from the action
+ * receipts to the root, appending the digests one at a time and in bulk on the calling thread and on thread pools
+ * of increasing size.
+ */
+int main(int argc, const char **argv) {
+
+   uint32_t num_actions = 10000;
+   uint32_t max_threads = 8;
+   uint32_t iterations  = 20;
+
+   po::options_description desc("Options");
+   desc.add_options()
+      ("help,h", "Print this help message and exit")
+      ("actions,a", po::value<uint32_t>(&num_actions)->default_value(num_actions), "number of action receipts in the transaction")
+      ("threads,t", po::value<uint32_t>(&max_threads)->default_value(max_threads), "largest thread pool measured")
+      ("iterations,i", po::value<uint32_t>(&iterations)->default_value(iterations), "roots calculated per measurement")
+   ;
+
+   po::variables_map vm;
+   po::store(po::parse_command_line(argc, argv, desc), vm);
+   po::notify(vm);
+
+   if( vm.count("help") ) {
+      std::cout << desc << std::endl;
+      return 1;
+   }
+
+   vector<action_receipt> receipts( num_actions );
+   for( uint32_t i = 0; i < num_actions; ++i ) {
+      receipts[i].receiver = N(enumivo);
+      receipts[i].act_digest = digest_type::hash( uint64_t(i) );
+      receipts[i].global_sequence = i;
+      receipts[i].recv_sequence = i;
+      receipts[i].auth_sequence[N(enumivo)] = i;
+   }
+
+   auto measure = [&]( const auto& accumulate, digest_type& root ) {
+      auto start = std::chrono::steady_clock::now();
+      for( uint32_t i = 0; i < iterations; ++i ) {
+         merkle_accumulator accumulator;
+         accumulate( accumulator );
+         root = accumulator.get_root();
+      }
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      return std::chrono::duration_cast<std::chrono::microseconds>( elapsed ).count() / std::max<uint32_t>( iterations, 1 );
+   };
+
+   digest_type serial_root;
+   auto serial_us = measure( [&]( merkle_accumulator& a ) {
+      for( const auto& r : receipts )
+         a.append( r.digest() );
+   }, serial_root );
+   std::cout << "actions: " << num_actions << ", root: " << serial_root.str() << std::endl;
+   std::cout << "serial:    " << serial_us << " us" << std::endl;
+
+   auto measure_bulk = [&]( boost::asio::thread_pool* pool ) {
+      digest_type root;
+      auto us = measure( [&]( merkle_accumulator& a ) { a.append( calculate_digests( receipts, pool ), pool ); }, root );
+      return std::make_pair( us, root == serial_root );
+   };
+
+   auto bulk = measure_bulk( nullptr );
+   std::cout << "bulk:      " << bulk.first << " us" << ( bulk.second ? "" : " (ROOT MISMATCH)" ) << std::endl;
+   if( !bulk.second )
+      return 1;
+
+   for( uint32_t threads = 1; threads <= max_threads; threads *= 2 ) {
+      boost::asio::thread_pool pool( threads );
+      auto result = measure_bulk( &pool );
+      pool.join();
+      std::cout << "threads " << threads << ": " << result.first << " us" << ( result.second ? "" : " (ROOT MISMATCH)" ) << std::endl;
+      if( !result.second )
+         return 1;
+   }
+
+   return 0;
+}
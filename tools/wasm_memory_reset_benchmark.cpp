@@ -0,0 +1,121 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+
+#include <enumivo/chain/wasm_enumivo_constraints.hpp>
+
+#include "IR/Types.h"
+#include "Runtime/Runtime.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+using namespace enumivo::chain;
+
+/**
+ * Measures the time to reset the linear memory of a contract before an action and to touch the part of it the action
+ * uses, clearing all of the module's initial memory before copying its initial data in, as the runtimes used to, and
+ * clearing only what was written, as they do now: WAVM by discarding the pages, binaryen by tracking how far its
+ * writes reached.
+ */
+int main(int argc, const char **argv) {
+
+   uint32_t memory_pages  = 16;
+   uint32_t touched_kib   = 16;
+   uint32_t initial_kib   = 8;
+   uint32_t iterations    = 10000;
+
+   po::options_description desc("Options");
+   desc.add_options()
+      ("help,h", "Print this help message and exit")
+      ("pages,p", po::value<uint32_t>(&memory_pages)->default_value(memory_pages), "initial size of the memory in 64 KiB pages")
+      ("touched,t", po::value<uint32_t>(&touched_kib)->default_value(touched_kib), "KiB of memory written by each action")
+      ("initial,d", po::value<uint32_t>(&initial_kib)->default_value(initial_kib), "KiB of initial data")
+      ("iterations,i", po::value<uint32_t>(&iterations)->default_value(iterations), "actions per measurement")
+   ;
+
+   po::variables_map vm;
+   po::store(po::parse_command_line(argc, argv, desc), vm);
+   po::notify(vm);
+
+   if( vm.count("help") ) {
+      std::cout << desc << std::endl;
+      return 1;
+   }
+
+   const size_t page_size = wasm_constraints::wasm_page_size;
+   if( memory_pages == 0 || size_t(memory_pages) * page_size > wasm_constraints::maximum_linear_memory
+       || size_t(touched_kib) * 1024 > size_t(memory_pages) * page_size
+       || size_t(initial_kib) * 1024 > wasm_constraints::maximum_linear_memory_init ) {
+      std::cerr << "the memory must hold the touched KiB and the initial data must fit in " << wasm_constraints::maximum_linear_memory_init / 1024
+                << " KiB" << std::endl;
+      return 1;
+   }
+
+   std::vector<uint8_t> initial( initial_kib * 1024, 0x5a );
+   const size_t memory_size = size_t(memory_pages) * page_size;
+   const size_t touched = size_t(touched_kib) * 1024;
+
+   // an action writes a byte to every 4 KiB of the memory it uses
+   auto touch = []( char* memory, size_t size ) {
+      for( size_t offset = 0; offset < size; offset += 4096 )
+         memory[offset] = 1;
+   };
+   auto measure = [&]( auto&& action ) {
+      auto start = std::chrono::steady_clock::now();
+      for( uint32_t i = 0; i < iterations; ++i )
+         action();
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      return std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count() / 1000.0 / std::max<uint32_t>( iterations, 1 );
+   };
+
+   std::cout << "memory: " << memory_pages << " pages, touched: " << touched_kib << " KiB, initial data: " << initial_kib
+             << " KiB" << std::endl;
+
+   IR::MemoryType type( false, { memory_pages, wasm_constraints::maximum_linear_memory / page_size } );
+   Runtime::MemoryInstance* memory = Runtime::createMemory( type );
+   if( !memory ) {
+      std::cerr << "failed to create the memory" << std::endl;
+      return 1;
+   }
+   char* wavm_base = (char*)Runtime::getMemoryBaseAddress( memory );
+
+   auto wavm_clear_all = measure( [&]() {
+      Runtime::resetMemory( memory, type );
+      memset( wavm_base, 0, memory_size );
+      memcpy( wavm_base, initial.data(), initial.size() );
+      touch( wavm_base, touched );
+   });
+   auto wavm_discard = measure( [&]() {
+      Runtime::resetMemory( memory, type, initial.data(), initial.size() );
+      touch( wavm_base, touched );
+   });
+   std::cout << "wavm clear all:       " << wavm_clear_all << " us" << std::endl;
+   std::cout << "wavm discard touched: " << wavm_discard << " us" << std::endl;
+
+   std::unique_ptr<char[]> buffer( new char[wasm_constraints::maximum_linear_memory]() );
+   size_t dirty = 0;
+   auto buffer_clear_all = measure( [&]() {
+      memset( buffer.get(), 0, memory_size );
+      memcpy( buffer.get(), initial.data(), initial.size() );
+      touch( buffer.get(), touched );
+   });
+   auto buffer_clear_written = measure( [&]() {
+      if( dirty > initial.size() )
+         memset( buffer.get() + initial.size(), 0, dirty - initial.size() );
+      memcpy( buffer.get(), initial.data(), initial.size() );
+      touch( buffer.get(), touched );
+      dirty = std::max( initial.size(), touched );
+   });
+   std::cout << "binaryen clear all:     " << buffer_clear_all << " us" << std::endl;
+   std::cout << "binaryen clear written: " << buffer_clear_written << " us" << std::endl;
+
+   return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ *  @file
+ *  @copyright defined in enumivo/LICENSE
+ */
+
+#include <enumivo/testing/tester.hpp>
+
+#include <enu.token/enu.token.wast.hpp>
+#include <enu.token/enu.token.abi.hpp>
+
+#include <fc/variant_object.hpp>
+
+#include <iostream>
+#include <sstream>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+/**
+ * Measures, for each wasm runtime, the time of the first action of enu.token, which instantiates the contract, and the
+ * mean time of the transfers after it
+ */
+int main(int argc, const char **argv) {
+
+   uint32_t transfers = 1000;
+   std::vector<std::string> runtimes = { "wavm", "binaryen", "predecoded" };
+
+   po::options_description desc("Options");
+   desc.add_options()
+      ("help,h", "Print this help message and exit")
+      ("transfers,t", po::value<uint32_t>(&transfers)->default_value(transfers), "transfers per runtime")
+      ("runtime,r", po::value<std::vector<std::string>>(&runtimes)->composing(), "runtimes to measure (wavm/binaryen/predecoded), all of them by default")
+   ;
+
+   po::variables_map vm;
+   po::store(po::parse_command_line(argc, argv, desc), vm);
+   po::notify(vm);
+
+   if( vm.count("help") || transfers == 0 ) {
+      std::cout << desc << std::endl;
+      return 1;
+   }
+
+   fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::off);
+
+   for( const auto& runtime : runtimes ) {
+      fc::temp_directory tempdir;
+      controller::config cfg;
+      cfg.blocks_dir = tempdir.path() / config::default_blocks_dir_name;
+      cfg.state_dir  = tempdir.path() / config::default_state_dir_name;
+      cfg.state_size = 1024*1024*64;
+      cfg.state_guard_size = 0;
+      cfg.reversible_cache_size = 1024*1024*64;
+      cfg.reversible_guard_size = 0;
+      cfg.genesis.initial_timestamp = fc::time_point::from_iso_string("2020-01-01T00:00:00.000");
+      cfg.genesis.initial_key = base_tester::get_public_key( config::system_account_name, "active" );
+      std::istringstream in( runtime );
+      in >> cfg.wasm_runtime;
+      if( !in ) {
+         std::cerr << "unknown runtime " << runtime << std::endl;
+         return 1;
+      }
+
+      tester chain( cfg );
+      chain.create_accounts( { N(enu.token), N(alice), N(bob) } );
+      chain.set_code( N(enu.token), enu_token_wast );
+      chain.set_abi( N(enu.token), enu_token_abi );
+      chain.produce_block();
+
+      auto create = chain.push_action( N(enu.token), N(create), N(enu.token), fc::mutable_variant_object()
+                         ("issuer", "alice")
+                         ("maximum_supply", "1000000000.0000 CUR")
+                         ("can_freeze", 0)
+                         ("can_recall", 0)
+                         ("can_whitelist", 0) );
+      chain.push_action( N(enu.token), N(issue), N(alice), fc::mutable_variant_object()
+                         ("to", "alice")
+                         ("quantity", "1000000.0000 CUR")
+                         ("memo", "") );
+      chain.produce_block();
+
+      fc::microseconds total;
+      for( uint32_t i = 0; i < transfers; ++i ) {
+         auto trace = chain.push_action( N(enu.token), N(transfer), N(alice), fc::mutable_variant_object()
+                                         ("from", "alice")
+                                         ("to", "bob")
+                                         ("quantity", "0.0001 CUR")
+                                         ("memo", std::to_string(i)) );
+         total += trace->action_traces.front().elapsed;
+         if( i % 100 == 99 )
+            chain.produce_block();
+      }
+
+      std::cout << runtime << ": first action " << create->action_traces.front().elapsed.count() << " us, "
+                << double(total.count()) / transfers << " us per transfer" << std::endl;
+   }
+
+   return 0;
+}
@@ -193,6 +193,29 @@ BOOST_CHECK_EXCEPTION( \
                      } \
 );
 
+void set_privileged( TESTER& test, account_name account, bool privileged ) {
+   auto set = [&]( controller& c ) {
+      const auto& a = c.db().get<account_object, by_name>( account );
+      c.db().modify( a, [&]( account_object& v ) { v.privileged = privileged; } );
+   };
+   set( *test.control );
+#ifndef NON_VALIDATING_TEST
+   set( *test.validating_node );
+#endif
+}
+
+/**
+ * test_api_db imports the batched table intrinsics, so the chain has to activate them before it can be set. The
+ * activation goes through the test_api_wast set on account, which is made privileged for it.
+ */
+void activate_batch_db( TESTER& test, account_name account ) {
+   set_privileged( test, account, true );
+   CALL_TEST_FUNCTION_SCOPE( test, "test_transaction", "activate_batch_db", {}, vector<account_name>{ account } );
+   set_privileged( test, account, false );
+   while( !test.control->is_feature_active( config::batch_db_feature_name ) )
+      test.produce_block();
+}
+
 bool is_access_violation(fc::unhandled_exception const & e) {
    try {
       std::rethrow_exception(e.get_inner_exception());
@@ -252,6 +275,7 @@ BOOST_FIXTURE_TEST_CASE(action_receipt_tests, TESTER) { try {
    BOOST_REQUIRE_EQUAL(uint32_t(res->action_traces[0].receipt.code_sequence), 1);
    BOOST_REQUIRE_EQUAL(uint32_t(res->action_traces[0].receipt.abi_sequence), 0);
 
+	activate_batch_db( *this, N(testapi) );
 	set_code( N(testapi), test_api_db_wast );
    set_code( config::system_account_name, test_api_db_wast );
    res = CALL_TEST_FUNCTION( *this, "test_db", "primary_i64_general", {});
@@ -1223,6 +1247,14 @@ BOOST_FIXTURE_TEST_CASE(db_tests, TESTER) { try {
    create_account( N(testapi) );
    create_account( N(testapi2) );
    produce_blocks(10);
+
+   // the batched table intrinsics test_api_db imports cannot be set before the chain activated them
+   BOOST_CHECK_EXCEPTION( set_code( N(testapi), test_api_db_wast ), wasm_exception,
+                          [](const fc::exception& e) {
+                             return expect_assert_message(e, "is not available until feature batchdb is active");
+                          });
+   set_code( N(testapi), test_api_wast );
+   activate_batch_db( *this, N(testapi) );
    set_code( N(testapi), test_api_db_wast );
    set_code( N(testapi2), test_api_db_wast );
    produce_blocks(1);
@@ -1230,6 +1262,7 @@ BOOST_FIXTURE_TEST_CASE(db_tests, TESTER) { try {
    CALL_TEST_FUNCTION( *this, "test_db", "primary_i64_general", {});
    CALL_TEST_FUNCTION( *this, "test_db", "primary_i64_lowerbound", {});
    CALL_TEST_FUNCTION( *this, "test_db", "primary_i64_upperbound", {});
+   CALL_TEST_FUNCTION( *this, "test_db", "primary_i64_batch", {});
    CALL_TEST_FUNCTION( *this, "test_db", "idx64_general", {});
    CALL_TEST_FUNCTION( *this, "test_db", "idx64_lowerbound", {});
    CALL_TEST_FUNCTION( *this, "test_db", "idx64_upperbound", {});
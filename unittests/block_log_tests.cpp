@@ -0,0 +1,315 @@
+#include <boost/test/unit_test.hpp>
+#include <enumivo/testing/tester.hpp>
+#include <enumivo/chain/block_log.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+namespace {
+   vector<signed_block_ptr> produce_chain( tester& chain, uint32_t num_blocks ) {
+      chain.produce_blocks( num_blocks );
+      vector<signed_block_ptr> blocks;
+      for( uint32_t n = 1; n <= chain.control->head_block_num(); ++n )
+         blocks.emplace_back( chain.control->fetch_block_by_number( n ) );
+      return blocks;
+   }
+
+   /// a chain of linked blocks of varying sizes, cheap enough to produce in large numbers
+   vector<signed_block_ptr> make_blocks( uint32_t num_blocks ) {
+      vector<signed_block_ptr> blocks;
+      block_id_type previous;
+      for( uint32_t n = 1; n <= num_blocks; ++n ) {
+         auto b = std::make_shared<signed_block>();
+         b->previous = previous;
+         b->block_extensions.emplace_back( 0, vector<char>( n % 97, 'x' ) );
+         previous = b->id();
+         blocks.emplace_back( b );
+      }
+      return blocks;
+   }
+
+   vector<char> read_file( const fc::path& file ) {
+      std::ifstream in( file.generic_string(), std::ios::binary );
+      return vector<char>( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(block_log_tests)
+
+BOOST_AUTO_TEST_CASE( read_while_appending ) try {
+   tester chain;
+   auto blocks = produce_chain( chain, 20 );
+
+   fc::temp_directory tempdir;
+   block_log blog( tempdir.path() );
+   blog.reset_to_genesis( genesis_state(), blocks.front() );
+
+   BOOST_REQUIRE( !blog.read_block_by_num( 2 ) );
+
+   for( size_t i = 1; i < blocks.size(); ++i ) {
+      blog.append( blocks[i] );
+      // every appended block must be readable right away, along with all the blocks before it
+      auto b = blog.read_block_by_num( blocks[i]->block_num() );
+      BOOST_REQUIRE( b );
+      BOOST_REQUIRE( b->id() == blocks[i]->id() );
+      BOOST_REQUIRE( blog.read_head()->id() == blocks[i]->id() );
+      BOOST_REQUIRE( blog.read_block_by_num( blocks[i/2]->block_num() )->id() == blocks[i/2]->id() );
+   }
+
+   BOOST_REQUIRE( !blog.read_block_by_num( 0 ) );
+   BOOST_REQUIRE( !blog.read_block_by_num( blocks.back()->block_num() + 1 ) );
+
+   auto pos = blog.get_block_pos( 2 );
+   auto res = blog.read_block( pos );
+   BOOST_REQUIRE( res.first->id() == blocks[1]->id() );
+   BOOST_REQUIRE_EQUAL( res.second, blog.get_block_pos( 3 ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( reopen ) try {
+   tester chain;
+   auto blocks = produce_chain( chain, 10 );
+
+   fc::temp_directory tempdir;
+   {
+      block_log blog( tempdir.path() );
+      blog.reset_to_genesis( genesis_state(), blocks.front() );
+      for( size_t i = 1; i < blocks.size(); ++i )
+         blog.append( blocks[i] );
+   }
+
+   fc::remove_all( tempdir.path() / "blocks.index" );
+
+   block_log blog( tempdir.path() );
+   BOOST_REQUIRE( blog.head()->id() == blocks.back()->id() );
+   for( const auto& b : blocks )
+      BOOST_REQUIRE( blog.read_block_by_num( b->block_num() )->id() == b->id() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( batched_appends ) try {
+   tester chain;
+   auto blocks = produce_chain( chain, 20 );
+
+   fc::temp_directory tempdir;
+   auto block_file = tempdir.path() / "blocks.log";
+   for( auto mode : { block_log_sync_mode::none, block_log_sync_mode::flush, block_log_sync_mode::fdatasync } ) {
+      fc::remove_all( tempdir.path() );
+      {
+         block_log_config cfg;
+         cfg.sync_mode      = mode;
+         cfg.batch_blocks   = 8;
+         cfg.batch_interval = fc::seconds(3600);
+         block_log blog( tempdir.path(), cfg );
+         blog.reset_to_genesis( genesis_state(), blocks.front() );
+         for( size_t i = 1; i < blocks.size(); ++i ) {
+            blog.append( blocks[i] );
+            // every block reaches the file as it is appended, whatever the mode, only the synchronization is batched
+            auto pos = blog.get_block_pos( blocks[i]->block_num() );
+            BOOST_REQUIRE_EQUAL( fc::file_size( block_file ), pos + fc::raw::pack_size( *blocks[i] ) + sizeof(uint64_t) );
+            BOOST_REQUIRE( blog.read_block_by_num( blocks[i]->block_num() )->id() == blocks[i]->id() );
+            BOOST_REQUIRE( blog.read_head()->id() == blocks[i]->id() );
+            BOOST_REQUIRE( blog.read_block( pos ).first->id() == blocks[i]->id() );
+         }
+         BOOST_REQUIRE( blog.read_block_by_num( 1 )->id() == blocks.front()->id() );
+      }
+
+      block_log blog( tempdir.path() );
+      BOOST_REQUIRE( blog.head()->id() == blocks.back()->id() );
+      for( const auto& b : blocks )
+         BOOST_REQUIRE( blog.read_block_by_num( b->block_num() )->id() == b->id() );
+   }
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( batch_ends_without_appends ) try {
+   tester chain;
+   auto blocks = produce_chain( chain, 10 );
+
+   fc::temp_directory tempdir;
+   {
+      // batches end on the timer between the appends, and the next append starts a new one which the timer ends again
+      block_log_config cfg;
+      cfg.sync_mode      = block_log_sync_mode::fdatasync;
+      cfg.batch_blocks   = 1000;
+      cfg.batch_interval = fc::milliseconds(10);
+      block_log blog( tempdir.path(), cfg );
+      blog.reset_to_genesis( genesis_state(), blocks.front() );
+      for( size_t i = 1; i < blocks.size(); ++i ) {
+         blog.append( blocks[i] );
+         if( i % 3 == 0 )
+            std::this_thread::sleep_for( std::chrono::milliseconds(30) );
+      }
+   }
+
+   block_log blog( tempdir.path() );
+   BOOST_REQUIRE( blog.head()->id() == blocks.back()->id() );
+   for( const auto& b : blocks )
+      BOOST_REQUIRE( blog.read_block_by_num( b->block_num() )->id() == b->id() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( segmented_log ) try {
+   tester chain;
+   auto blocks = produce_chain( chain, 22 - chain.control->head_block_num() );
+   BOOST_REQUIRE_EQUAL( blocks.size(), 22 );
+
+   fc::temp_directory tempdir;
+   block_log_config cfg;
+   cfg.stride             = 5;
+   cfg.max_retained_files = 1;
+   cfg.archive_dir        = "archive";
+   {
+      block_log blog( tempdir.path(), cfg );
+      blog.reset_to_genesis( genesis_state(), blocks.front() );
+      for( size_t i = 1; i < blocks.size(); ++i ) {
+         blog.append( blocks[i] );
+         BOOST_REQUIRE( blog.read_head()->id() == blocks[i]->id() );
+      }
+      for( const auto& b : blocks )
+         BOOST_REQUIRE( blog.read_block_by_num( b->block_num() )->id() == b->id() );
+   }
+
+   BOOST_REQUIRE( fc::exists( tempdir.path() / "blocks-16-20.log" ) );
+   BOOST_REQUIRE( fc::exists( tempdir.path() / "blocks-16-20.index" ) );
+   BOOST_REQUIRE( !fc::exists( tempdir.path() / "blocks-1-5.log" ) );
+   BOOST_REQUIRE( fc::exists( tempdir.path() / "archive" / "blocks-1-5.log" ) );
+   BOOST_REQUIRE( fc::exists( tempdir.path() / "archive" / "blocks-11-15.log" ) );
+
+   block_log blog( tempdir.path(), cfg );
+   BOOST_REQUIRE( blog.head()->id() == blocks.back()->id() );
+   for( const auto& b : blocks )
+      BOOST_REQUIRE( blog.read_block_by_num( b->block_num() )->id() == b->id() );
+   BOOST_REQUIRE_EQUAL( blog.get_block_pos( 5 ), block_log::npos );
+   BOOST_REQUIRE( blog.read_block( blog.get_block_pos( 21 ) ).first->id() == blocks[20]->id() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( compressed_segments ) try {
+   tester chain;
+   auto blocks = produce_chain( chain, 22 - chain.control->head_block_num() );
+   BOOST_REQUIRE_EQUAL( blocks.size(), 22 );
+
+   fc::temp_directory tempdir;
+   block_log_config cfg;
+   cfg.stride                   = 5;
+   cfg.compression_chunk_blocks = 2;
+   {
+      block_log blog( tempdir.path(), cfg );
+      blog.reset_to_genesis( genesis_state(), blocks.front() );
+      for( size_t i = 1; i < blocks.size(); ++i )
+         blog.append( blocks[i] );
+      // read backwards as well, so that chunks are decompressed out of order
+      for( auto itr = blocks.rbegin(); itr != blocks.rend(); ++itr )
+         BOOST_REQUIRE( blog.read_block_by_num( (*itr)->block_num() )->id() == (*itr)->id() );
+   }
+
+   // chunks of two blocks leave a chunk holding a single block at the end of every segment
+   BOOST_REQUIRE_EQUAL( fc::file_size( tempdir.path() / "blocks-6-10.index" ), 3 * sizeof(uint64_t) );
+   fc::remove_all( tempdir.path() / "blocks-6-10.index" );
+
+   block_log blog( tempdir.path(), cfg );
+   BOOST_REQUIRE( blog.head()->id() == blocks.back()->id() );
+   for( const auto& b : blocks )
+      BOOST_REQUIRE( blog.read_block_by_num( b->block_num() )->id() == b->id() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( compress_existing_log ) try {
+   tester chain;
+   auto blocks = produce_chain( chain, 20 );
+
+   fc::temp_directory tempdir;
+   size_t split = blocks.size() / 2;
+   {
+      block_log blog( tempdir.path() );
+      blog.reset_to_genesis( genesis_state(), blocks.front() );
+      for( size_t i = 1; i < split; ++i )
+         blog.append( blocks[i] );
+   }
+
+   block_log::compress_log( tempdir.path(), 3 );
+   BOOST_REQUIRE( fc::exists( tempdir.path() / ("blocks-1-" + std::to_string(split) + ".log") ) );
+
+   {
+      block_log blog( tempdir.path() );
+      BOOST_REQUIRE( blog.head()->id() == blocks[split - 1]->id() );
+      // the node keeps appending after the compressed blocks
+      for( size_t i = split; i < blocks.size(); ++i )
+         blog.append( blocks[i] );
+   }
+
+   block_log blog( tempdir.path() );
+   BOOST_REQUIRE( blog.head()->id() == blocks.back()->id() );
+   for( const auto& b : blocks )
+      BOOST_REQUIRE( blog.read_block_by_num( b->block_num() )->id() == b->id() );
+   BOOST_REQUIRE( block_log::extract_genesis_state( tempdir.path() ).compute_chain_id() == genesis_state().compute_chain_id() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( parallel_index_rebuild ) try {
+   auto blocks = make_blocks( 5000 );
+
+   fc::temp_directory tempdir;
+   {
+      block_log blog( tempdir.path() );
+      blog.reset_to_genesis( genesis_state(), blocks.front() );
+      for( size_t i = 1; i < blocks.size(); ++i )
+         blog.append( blocks[i] );
+   }
+   auto index = read_file( tempdir.path() / "blocks.index" );
+   BOOST_REQUIRE_EQUAL( index.size(), blocks.size() * sizeof(uint64_t) );
+
+   // a missing index as well as one that is behind are rebuilt from the block log
+   fc::remove_all( tempdir.path() / "blocks.index" );
+   {
+      block_log blog( tempdir.path() );
+      BOOST_REQUIRE( blog.head()->id() == blocks.back()->id() );
+   }
+   BOOST_REQUIRE( read_file( tempdir.path() / "blocks.index" ) == index );
+
+   {
+      std::ofstream out( (tempdir.path() / "blocks.index").generic_string(), std::ios::binary | std::ios::trunc );
+      out.write( index.data(), index.size() / 2 );
+   }
+   block_log blog( tempdir.path() );
+   BOOST_REQUIRE( read_file( tempdir.path() / "blocks.index" ) == index );
+   for( uint32_t n = 1; n <= blocks.size(); n += 123 )
+      BOOST_REQUIRE( blog.read_block_by_num( n )->id() == blocks[n-1]->id() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( read_ahead ) try {
+   auto blocks = make_blocks( 2000 );
+
+   fc::temp_directory tempdir;
+   block_log blog( tempdir.path() );
+   blog.reset_to_genesis( genesis_state(), blocks.front() );
+   for( size_t i = 1; i < blocks.size(); ++i )
+      blog.append( blocks[i] );
+
+   {
+      std::atomic<uint32_t> blocks_read{0};
+      block_read_ahead read_ahead( blog, 2, blocks.size(), 16, 3, [&]( const signed_block_ptr& ) { ++blocks_read; } );
+      for( size_t i = 1; i < blocks.size(); ++i ) {
+         auto b = read_ahead.next();
+         BOOST_REQUIRE( b );
+         BOOST_REQUIRE( b->id() == blocks[i]->id() );
+      }
+      BOOST_REQUIRE( !read_ahead.next() );
+      BOOST_REQUIRE_EQUAL( blocks_read, blocks.size() - 1 );
+   }
+
+   {
+      // blocks missing from the log end the range early
+      block_read_ahead read_ahead( blog, blocks.size() - 1, blocks.size() + 10, 4, 2 );
+      BOOST_REQUIRE( read_ahead.next()->id() == blocks[blocks.size() - 2]->id() );
+      BOOST_REQUIRE( read_ahead.next()->id() == blocks.back()->id() );
+      BOOST_REQUIRE( !read_ahead.next() );
+   }
+
+   // stopping in the middle of the range must not wait for the remaining blocks
+   block_read_ahead read_ahead( blog, 1, blocks.size(), 8, 4 );
+   BOOST_REQUIRE( read_ahead.next()->id() == blocks.front()->id() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -50,4 +50,31 @@ BOOST_AUTO_TEST_CASE(block_with_invalid_tx_test)
   
 }
 
+BOOST_AUTO_TEST_CASE(reuse_unapplied_transaction_test)
+{
+   tester main;
+
+   main.create_account(N(newacc));
+   auto b = main.produce_block();
+   auto pt = b->transactions.back().trx.get<packed_transaction>();
+
+   // The validator receives the transaction before the block including it
+   tester validator;
+   vector<transaction_metadata_ptr> accepted;
+   auto c = validator.control->accepted_transaction.connect( [&]( const transaction_metadata_ptr& t ) {
+      accepted.push_back( t );
+   });
+   validator.push_transaction( pt );
+   BOOST_REQUIRE_EQUAL( accepted.size(), 1 );
+   BOOST_REQUIRE( accepted.back()->signing_keys );
+
+   // The block applies the metadata of the transaction pushed speculatively, which was already accepted
+   validator.push_block( b );
+   c.disconnect();
+   BOOST_REQUIRE_EQUAL( accepted.size(), 1 );
+   BOOST_REQUIRE( validator.control->head_block_id() == b->id() );
+   BOOST_REQUIRE( validator.control->head_block_state()->trxs.back() == accepted.back() );
+   BOOST_REQUIRE( validator.control->get_unapplied_transactions().empty() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+#include <boost/test/unit_test.hpp>
+#include <enumivo/chain/merkle.hpp>
+#include <enumivo/chain/action_receipt.hpp>
+
+#include <fc/exception/exception.hpp>
+
+using namespace enumivo::chain;
+
+namespace {
+   /// the merkle root as calculated before levels were hashed in batches
+   digest_type reference_merkle( vector<digest_type> ids ) {
+      if( ids.empty() ) return digest_type();
+      while( ids.size() > 1 ) {
+         if( ids.size() % 2 )
+            ids.push_back( ids.back() );
+         vector<digest_type> parents;
+         for( size_t i = 0; i < ids.size(); i += 2 )
+            parents.push_back( digest_type::hash( make_canonical_pair( ids[i], ids[i + 1] ) ) );
+         ids = std::move( parents );
+      }
+      return ids.front();
+   }
+
+   vector<digest_type> make_ids( size_t n ) {
+      vector<digest_type> ids;
+      for( size_t i = 0; i < n; ++i )
+         ids.push_back( digest_type::hash( uint64_t(i) ) );
+      return ids;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(merkle_tests)
+
+BOOST_AUTO_TEST_CASE( roots_match_serial_merkle ) try {
+   boost::asio::thread_pool pool( 3 );
+   for( size_t n : { size_t(0), size_t(1), size_t(2), size_t(3), size_t(7), merkle_batch_size * 2,
+                     merkle_batch_size * 2 + 1, merkle_batch_size * 5 - 3, merkle_batch_size * 8 } ) {
+      auto ids = make_ids( n );
+      auto expected = reference_merkle( ids );
+      BOOST_REQUIRE( merkle( ids ) == expected );
+      BOOST_REQUIRE( merkle( ids, &pool ) == expected );
+      BOOST_REQUIRE( merkle( ids, nullptr ) == expected );
+   }
+   pool.join();
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( accumulator_matches_merkle ) try {
+   auto ids = make_ids( 300 );
+   merkle_accumulator accumulator;
+   BOOST_REQUIRE( accumulator.get_root() == digest_type() );
+   for( size_t n = 1; n <= ids.size(); ++n ) {
+      accumulator.append( ids[n - 1] );
+      BOOST_REQUIRE_EQUAL( accumulator.size(), n );
+      BOOST_REQUIRE( accumulator.get_root() == reference_merkle( vector<digest_type>( ids.begin(), ids.begin() + n ) ) );
+   }
+
+   // a copy taken earlier restores the root of the digests appended until then
+   merkle_accumulator restore_point;
+   for( size_t n = 0; n < 10; ++n )
+      restore_point.append( ids[n] );
+   auto restored = restore_point;
+   restored.append( ids[10] );
+   restored = restore_point;
+   BOOST_REQUIRE( restored.get_root() == reference_merkle( vector<digest_type>( ids.begin(), ids.begin() + 10 ) ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( bulk_append_matches_single_appends ) try {
+   boost::asio::thread_pool pool( 3 );
+   auto ids = make_ids( merkle_batch_size * 11 + 5 );
+
+   // bulk appends starting at every kind of offset, so subtrees of every size are filled by them
+   merkle_accumulator single, pooled, inline_bulk;
+   size_t begin = 0;
+   for( size_t count : { size_t(1), size_t(3), merkle_batch_size * 4, size_t(2), merkle_batch_size * 2 + 7, size_t(0),
+                         merkle_batch_size * 5 - 8 } ) {
+      vector<digest_type> batch( ids.begin() + begin, ids.begin() + begin + count );
+      for( const auto& id : batch )
+         single.append( id );
+      pooled.append( batch, &pool );
+      inline_bulk.append( batch, nullptr );
+      begin += count;
+
+      BOOST_REQUIRE_EQUAL( pooled.size(), begin );
+      BOOST_REQUIRE( pooled.get_root() == single.get_root() );
+      BOOST_REQUIRE( inline_bulk.get_root() == single.get_root() );
+   }
+   BOOST_REQUIRE_EQUAL( begin, ids.size() );
+   BOOST_REQUIRE( pooled.get_root() == reference_merkle( ids ) );
+   pool.join();
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( digests_match_serial_digests ) try {
+   boost::asio::thread_pool pool( 3 );
+   vector<action_receipt> receipts( 1000 );
+   for( size_t i = 0; i < receipts.size(); ++i ) {
+      receipts[i].receiver = N(enumivo);
+      receipts[i].global_sequence = i;
+      receipts[i].act_digest = digest_type::hash( uint64_t(i) );
+   }
+
+   auto digests = calculate_digests( receipts, &pool, 64 );
+   BOOST_REQUIRE_EQUAL( digests.size(), receipts.size() );
+   for( size_t i = 0; i < receipts.size(); ++i )
+      BOOST_REQUIRE( digests[i] == receipts[i].digest() );
+   pool.join();
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+#include <boost/test/unit_test.hpp>
+#include <enumivo/testing/tester.hpp>
+#include <enumivo/chain/replay_profiler.hpp>
+#include <enumivo/chain/transaction_conflicts.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/filesystem.hpp>
+
+#include <fstream>
+
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+namespace {
+   transaction_trace make_trace( fc::microseconds elapsed, account_name receiver, action_name name, fc::microseconds action_elapsed ) {
+      transaction_trace trace;
+      trace.elapsed = elapsed;
+      action_trace at;
+      at.receipt.receiver = receiver;
+      at.act.account = receiver;
+      at.act.name = name;
+      at.elapsed = action_elapsed;
+      action_trace notified( at );
+      notified.receipt.receiver = N(bob);
+      at.inline_traces.push_back( notified );
+      trace.action_traces.push_back( at );
+      return trace;
+   }
+
+   vector<string> read_lines( const fc::path& file ) {
+      std::ifstream in( file.generic_string() );
+      vector<string> lines;
+      for( string line; std::getline( in, line ); )
+         lines.push_back( line );
+      return lines;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(replay_profiler_tests)
+
+BOOST_AUTO_TEST_CASE( aggregate ) try {
+   replay_profiler profiler( 2 );
+   profiler.add_transaction( make_trace( fc::microseconds(100), N(alice), N(transfer), fc::microseconds(40) ) );
+   profiler.add_block( 2, fc::microseconds(300) );
+   profiler.add_block( 3, fc::microseconds(50) );
+   profiler.add_transaction( make_trace( fc::microseconds(200), N(alice), N(transfer), fc::microseconds(90) ) );
+   profiler.add_transaction( make_trace( fc::microseconds(10), N(carol), N(issue), fc::microseconds(5) ) );
+   profiler.add_block( 4, fc::microseconds(400) );
+
+   BOOST_REQUIRE_EQUAL( profiler.blocks().size(), 3 );
+   BOOST_REQUIRE_EQUAL( profiler.blocks()[0].transactions, 1 );
+   BOOST_REQUIRE_EQUAL( profiler.blocks()[0].actions, 2 );
+   BOOST_REQUIRE_EQUAL( profiler.blocks()[1].transactions, 0 );
+   BOOST_REQUIRE_EQUAL( profiler.blocks()[2].transactions, 2 );
+
+   BOOST_REQUIRE_EQUAL( profiler.transactions().count, 3 );
+   BOOST_REQUIRE_EQUAL( profiler.transactions().total.count(), 310 );
+   BOOST_REQUIRE_EQUAL( profiler.transactions().max.count(), 200 );
+
+   auto slowest = profiler.slowest_blocks();
+   BOOST_REQUIRE_EQUAL( slowest.size(), 2 );
+   BOOST_REQUIRE_EQUAL( slowest[0].block_num, 4 );
+   BOOST_REQUIRE_EQUAL( slowest[1].block_num, 2 );
+
+   // the notification of bob is counted separately from the action applied by alice
+   auto actions = profiler.actions();
+   BOOST_REQUIRE_EQUAL( actions.size(), 4 );
+   BOOST_REQUIRE( actions[0].receiver == N(alice) || actions[0].receiver == N(bob) );
+   BOOST_REQUIRE( actions[0].name == N(transfer) );
+   BOOST_REQUIRE_EQUAL( actions[0].time.count, 2 );
+   BOOST_REQUIRE_EQUAL( actions[0].time.total.count(), 130 );
+   BOOST_REQUIRE_EQUAL( actions[0].time.max.count(), 90 );
+
+   fc::temp_directory tempdir;
+   auto csv_file = tempdir.path() / "profile.csv";
+   profiler.write( csv_file );
+   auto lines = read_lines( csv_file );
+   BOOST_REQUIRE_EQUAL( lines.size(), 1 + 3 + 2 + 1 + 4 );
+   BOOST_REQUIRE_EQUAL( lines[1], "block,2,,,,1,2,1,300,300,1,1,100" );
+   // both transactions of block 4 notify bob, which their declared accounts do not tell
+   BOOST_REQUIRE_EQUAL( lines[4], "slowest_block,4,,,,2,4,1,400,400,1,2,210" );
+   BOOST_REQUIRE_EQUAL( lines[6], "transaction,,,,,,,3,310,200,,," );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( groups ) try {
+   vector<flat_set<account_name>> accounts = {
+      { N(alice), N(bob) },
+      { N(carol) },
+      { N(dan) },
+      { N(bob), N(erin) },
+      { N(erin), N(dan) },
+      { N(frank) },
+      {}
+   };
+   BOOST_REQUIRE( conflict_groups( accounts ) == vector<uint32_t>({ 0, 1, 0, 0, 0, 2, 3 }) );
+   BOOST_REQUIRE( conflict_groups( {} ).empty() );
+
+   auto trace = make_trace( fc::microseconds(1), N(alice), N(transfer), fc::microseconds(1) );
+   BOOST_REQUIRE( declared_accounts( trace ) == flat_set<account_name>({ N(alice) }) );
+   BOOST_REQUIRE( touched_accounts( trace ) == flat_set<account_name>({ N(alice), N(bob) }) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( profile_replay ) try {
+   fc::temp_directory tempdir;
+   auto cfg = base_tester::default_config( tempdir.path() );
+
+   uint32_t head_num = 0;
+   {
+      tester chain( cfg );
+      chain.create_accounts( {N(alice), N(bob)} );
+      chain.produce_blocks( 10 );
+      chain.control->abort_block();
+      head_num = chain.control->head_block_num();
+   }
+
+   fc::remove_all( cfg.state_dir );
+   cfg.replay_profile = tempdir.path() / "profile.json";
+   controller replayed( cfg );
+   replayed.startup();
+   BOOST_REQUIRE_EQUAL( replayed.head_block_num(), head_num );
+
+   auto report = fc::json::from_file( cfg.replay_profile ).get_object();
+   BOOST_REQUIRE( report["blocks"].as_uint64() > 0 );
+   BOOST_REQUIRE_EQUAL( report["block_times"].get_array().size(), report["blocks"].as_uint64() );
+
+   bool found_newaccount = false;
+   for( const auto& a : report["actions"].get_array() ) {
+      auto action = a.as<replay_profiler::action_timing>();
+      if( action.receiver == config::system_account_name && action.name == N(newaccount) ) {
+         BOOST_REQUIRE_EQUAL( action.time.count, 2 );
+         found_newaccount = true;
+      }
+   }
+   BOOST_REQUIRE( found_newaccount );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+#include <boost/test/unit_test.hpp>
+#include <enumivo/testing/tester.hpp>
+#include <enumivo/chain/signature_recovery_cache.hpp>
+
+#include <thread>
+
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+BOOST_AUTO_TEST_SUITE(signature_recovery_cache_tests)
+
+BOOST_AUTO_TEST_CASE( hits_misses_and_evictions ) try {
+   signature_recovery_cache cache( 4, 1 );
+   auto key = base_tester::get_private_key( N(alice), "active" );
+
+   vector<digest_type> digests;
+   vector<signature_type> sigs;
+   for( int i = 0; i < 5; ++i ) {
+      digests.push_back( digest_type::hash( std::to_string( i ) ) );
+      sigs.push_back( key.sign( digests.back() ) );
+   }
+
+   for( int i = 0; i < 4; ++i )
+      BOOST_REQUIRE( cache.recover( sigs[i], digests[i] ) == key.get_public_key() );
+   BOOST_REQUIRE( cache.recover( sigs[0], digests[0] ) == key.get_public_key() );
+
+   // the same signature of a different digest is a different entry
+   BOOST_REQUIRE( !cache.find( sigs[0], digests[1] ) );
+
+   // entry 1 is now the least recently used
+   cache.recover( sigs[4], digests[4] );
+   BOOST_REQUIRE( !cache.find( sigs[1], digests[1] ) );
+   BOOST_REQUIRE( cache.find( sigs[0], digests[0] ) );
+
+   auto m = cache.get_metrics();
+   BOOST_REQUIRE_EQUAL( m.hits, 2 );
+   BOOST_REQUIRE_EQUAL( m.misses, 7 );
+   BOOST_REQUIRE_EQUAL( m.evictions, 1 );
+   BOOST_REQUIRE_EQUAL( m.size, 4 );
+
+   cache.set_capacity( 2 );
+   BOOST_REQUIRE_EQUAL( cache.get_metrics().size, 2 );
+   BOOST_REQUIRE_EQUAL( cache.get_metrics().evictions, 3 );
+
+   cache.set_capacity( 0 );
+   cache.recover( sigs[1], digests[1] );
+   BOOST_REQUIRE_EQUAL( cache.get_metrics().size, 0 );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( concurrent_recovery ) try {
+   signature_recovery_cache cache( 1024 );
+   vector<private_key_type> keys;
+   vector<digest_type> digests;
+   vector<signature_type> sigs;
+   for( int i = 0; i < 32; ++i ) {
+      keys.push_back( base_tester::get_private_key( N(alice), std::to_string( i ) ) );
+      digests.push_back( digest_type::hash( std::to_string( i ) ) );
+      sigs.push_back( keys.back().sign( digests.back() ) );
+   }
+
+   std::atomic<uint32_t> mismatches{0};
+   vector<std::thread> threads;
+   for( int t = 0; t < 4; ++t ) {
+      threads.emplace_back( [&]() {
+         for( int round = 0; round < 4; ++round ) {
+            for( size_t i = 0; i < sigs.size(); ++i ) {
+               if( cache.recover( sigs[i], digests[i] ) != keys[i].get_public_key() )
+                  ++mismatches;
+            }
+         }
+      });
+   }
+   for( auto& t : threads )
+      t.join();
+
+   BOOST_REQUIRE_EQUAL( mismatches.load(), 0 );
+   auto m = cache.get_metrics();
+   BOOST_REQUIRE_EQUAL( m.hits + m.misses, 4 * 4 * sigs.size() );
+   BOOST_REQUIRE_EQUAL( m.size, sigs.size() );
+   BOOST_REQUIRE( m.hits >= 4 * 4 * sigs.size() - 4 * sigs.size() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+#include <boost/test/unit_test.hpp>
+#include <enumivo/testing/tester.hpp>
+#include <enumivo/chain/snapshot.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <fstream>
+
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+namespace {
+   vector<char> read_file( const fc::path& file ) {
+      std::ifstream in( file.generic_string(), std::ios::binary );
+      return vector<char>( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+   }
+
+   /// produces blocks until the block of id is irreversible, which is when a snapshot of it is moved in place
+   void produce_until_irreversible( tester& chain, const block_id_type& id ) {
+      while( chain.control->last_irreversible_block_num() < block_header::num_from_id( id ) )
+         chain.produce_block();
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(snapshot_tests)
+
+BOOST_AUTO_TEST_CASE( round_trip ) try {
+   fc::temp_directory tempdir;
+   tester chain( base_tester::default_config( tempdir.path() / "source" ) );
+   chain.create_accounts( {N(alice), N(bob)} );
+   chain.produce_blocks( 10 );
+   chain.create_accounts( {N(dave)} );
+   chain.produce_block();
+   chain.control->abort_block();
+
+   auto head_id = chain.control->head_block_id();
+   BOOST_REQUIRE( chain.control->last_irreversible_block_num() < chain.control->head_block_num() );
+
+   auto snapshot_file = tempdir.path() / "snapshot.bin";
+   fc::path pending_file = snapshot_file.generic_string() + ".pending";
+   bool written = false;
+   chain.control->write_snapshot( snapshot_file, [&written]() { written = true; } );
+
+   // the snapshot of the reversible head is kept aside without touching the chain until the head is irreversible
+   BOOST_REQUIRE( !written );
+   BOOST_REQUIRE( !fc::exists( snapshot_file ) );
+   BOOST_REQUIRE( fc::exists( pending_file ) );
+   BOOST_REQUIRE( chain.control->head_block_id() == head_id );
+
+   produce_until_irreversible( chain, head_id );
+   BOOST_REQUIRE( written );
+   BOOST_REQUIRE( fc::exists( snapshot_file ) );
+   BOOST_REQUIRE( !fc::exists( pending_file ) );
+
+   auto header = snapshot::read_header( snapshot_file );
+   BOOST_REQUIRE( header.head.id == head_id );
+   BOOST_REQUIRE( header.head_block.id() == head_id );
+
+   // a node started from the snapshot without a block log starts its block log at the snapshot
+   auto cfg = base_tester::default_config( tempdir.path() / "restored" );
+   cfg.snapshot = snapshot_file;
+   controller restored( cfg );
+   restored.startup();
+
+   BOOST_REQUIRE( restored.head_block_id() == header.head.id );
+   BOOST_REQUIRE_EQUAL( restored.get_account( N(alice) ).privileged, false );
+   restored.get_account( N(dave) );
+   BOOST_REQUIRE( restored.get_permission( {N(bob), config::active_name} ).auth.to_authority()
+                  == chain.control->get_permission( {N(bob), config::active_name} ).auth.to_authority() );
+
+   // the restored head is irreversible, so its state is written out again right away, exactly as it was read
+   auto copy_file = tempdir.path() / "copy.bin";
+   written = false;
+   restored.write_snapshot( copy_file, [&written]() { written = true; } );
+   BOOST_REQUIRE( written );
+   BOOST_REQUIRE( read_file( snapshot_file ) == read_file( copy_file ) );
+
+   // and validates the blocks produced after the snapshot
+   chain.create_accounts( {N(carol)} );
+   chain.produce_blocks( 5 );
+   for( uint32_t n = header.head.block_num + 1; n <= chain.control->head_block_num(); ++n )
+      restored.push_block( chain.control->fetch_block_by_number( n ) );
+   BOOST_REQUIRE( restored.head_block_id() == chain.control->head_block_id() );
+   restored.get_account( N(carol) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( replay_block_log_tail ) try {
+   fc::temp_directory tempdir;
+   auto cfg = base_tester::default_config( tempdir.path() );
+   auto snapshot_file = tempdir.path() / "snapshot.bin";
+
+   block_id_type head_id;
+   {
+      tester chain( cfg );
+      chain.create_accounts( {N(alice)} );
+      chain.produce_blocks( 10 );
+      chain.control->abort_block();
+      chain.control->write_snapshot( snapshot_file );
+      auto snapshot_id = chain.control->head_block_id();
+
+      chain.create_accounts( {N(bob)} );
+      chain.produce_blocks( 10 );
+      chain.control->abort_block();
+      BOOST_REQUIRE( chain.control->last_irreversible_block_num() >= block_header::num_from_id( snapshot_id ) );
+      head_id = chain.control->head_block_id();
+   }
+
+   // only the blocks after the snapshot are replayed into the state restored from it
+   fc::remove_all( cfg.state_dir );
+   cfg.snapshot = snapshot_file;
+   controller restored( cfg );
+   restored.startup();
+
+   BOOST_REQUIRE( restored.head_block_id() == head_id );
+   restored.get_account( N(alice) );
+   restored.get_account( N(bob) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( reject_other_chain ) try {
+   fc::temp_directory tempdir;
+   tester chain( base_tester::default_config( tempdir.path() / "source" ) );
+   chain.produce_blocks( 2 );
+   chain.control->abort_block();
+
+   auto snapshot_file = tempdir.path() / "snapshot.bin";
+   chain.control->write_snapshot( snapshot_file );
+   produce_until_irreversible( chain, chain.control->head_block_id() );
+
+   auto cfg = base_tester::default_config( tempdir.path() / "other" );
+   cfg.genesis.initial_timestamp = fc::time_point::from_iso_string("2020-01-02T00:00:00.000");
+   cfg.snapshot = snapshot_file;
+   controller other( cfg );
+   BOOST_REQUIRE_THROW( other.startup(), snapshot_validation_exception );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+#include <boost/test/unit_test.hpp>
+#include <enumivo/testing/tester.hpp>
+#include <enumivo/chain/contract_table_objects.hpp>
+
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+namespace {
+   const name rows_table = N(rows);
+   const uint64_t row_key = 7;
+
+   std::string name_const( name n ) {
+      return "(i64.const " + std::to_string( int64_t(uint64_t(n)) ) + ")";
+   }
+
+   std::string on_action( name action, const std::string& body ) {
+      return "(block $skip (br_if $skip (i64.ne (get_local $2) " + name_const( action ) + ")) " + body + ")\n";
+   }
+
+   /**
+    * a contract working on a single row of its own table: "missing" asserts the table does not exist, "present" that
+    * the row does, "store" creates the row, "erase" removes it, which removes the table with it, and "fail" aborts
+    */
+   std::string table_cache_wast() {
+      std::string find = "(call $db_find_i64 (get_local $0) (get_local $0) " + name_const( rows_table ) +
+                         " (i64.const " + std::to_string( row_key ) + "))";
+      std::string wast = R"=====(
+(module
+  (import "env" "enumivo_assert" (func $enumivo_assert (param i32 i32)))
+  (import "env" "db_store_i64" (func $db_store_i64 (param i64 i64 i64 i64 i32 i32) (result i32)))
+  (import "env" "db_find_i64" (func $db_find_i64 (param i64 i64 i64 i64) (result i32)))
+  (import "env" "db_remove_i64" (func $db_remove_i64 (param i32)))
+  (table 0 anyfunc)
+  (memory $0 1)
+  (data (i32.const 0) "payload!")
+  (data (i32.const 16) "table should be missing\00")
+  (data (i32.const 48) "row should be present\00")
+  (data (i32.const 80) "failed on purpose\00")
+  (export "apply" (func $apply))
+  (func $apply (param $0 i64) (param $1 i64) (param $2 i64)
+)=====";
+      wast += on_action( N(missing), "(call $enumivo_assert (i32.eq " + find + " (i32.const -1)) (i32.const 16))" );
+      wast += on_action( N(present), "(call $enumivo_assert (i32.ge_s " + find + " (i32.const 0)) (i32.const 48))" );
+      wast += on_action( N(store), "(drop (call $db_store_i64 (get_local $0) " + name_const( rows_table ) +
+                                   " (get_local $0) (i64.const " + std::to_string( row_key ) + ") (i32.const 0) (i32.const 8)))" );
+      wast += on_action( N(erase), "(call $db_remove_i64 " + find + ")" );
+      wast += on_action( N(fail), "(call $enumivo_assert (i32.const 0) (i32.const 80))" );
+      wast += "))";
+      return wast;
+   }
+
+   /// pushes the actions in a single transaction, so that all of them share the table cache of the transaction
+   transaction_trace_ptr push_actions( tester& chain, account_name account, const vector<name>& actions ) {
+      signed_transaction trx;
+      for( auto a : actions )
+         trx.actions.emplace_back( vector<permission_level>{{account, config::active_name}}, account, a, bytes() );
+      chain.set_transaction_headers( trx );
+      trx.sign( chain.get_private_key( account, "active" ), chain.control->get_chain_id() );
+      return chain.push_transaction( trx );
+   }
+
+   /**
+    * Returns the row of the contract from the state, or null. The row found through the index db_find_i64 uses,
+    * the hashed one when ENUMIVO_HASHED_KEY_VALUE_INDEX is set, must be the one of the ordered index.
+    */
+   const key_value_object* find_row( tester& chain, account_name account ) {
+      const auto& db = chain.control->db();
+      const auto* tid = db.find<table_id_object, by_code_scope_table>( boost::make_tuple( account, account, rows_table ) );
+      if( !tid ) return nullptr;
+      BOOST_REQUIRE_EQUAL( tid->count, 1 );
+      const auto* row = db.find<key_value_object, by_scope_primary>( boost::make_tuple( tid->id, row_key ) );
+      BOOST_REQUIRE( db.find<key_value_object, by_point_lookup>( boost::make_tuple( tid->id, row_key ) ) == row );
+      return row;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(table_cache_tests)
+
+// the tests below cover the hashed row index when built with -DENABLE_HASHED_KEY_VALUE_INDEX=ON
+BOOST_AUTO_TEST_CASE( point_lookup_index ) {
+   BOOST_REQUIRE_EQUAL( (std::is_same<by_point_lookup, by_scope_primary_hash>::value), bool(ENUMIVO_HASHED_KEY_VALUE_INDEX) );
+}
+
+BOOST_FIXTURE_TEST_CASE( missing_table_created_later, tester ) try {
+   create_accounts( { N(cache) } );
+   set_code( N(cache), table_cache_wast().c_str() );
+   produce_block();
+
+   // the table is cached as missing by the first action and must be found once the second one created it
+   push_actions( *this, N(cache), { N(missing), N(store), N(present) } );
+   BOOST_REQUIRE( find_row( *this, N(cache) ) );
+   produce_block();
+   BOOST_REQUIRE( find_row( *this, N(cache) ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE( removed_table_recreated, tester ) try {
+   create_accounts( { N(cache) } );
+   set_code( N(cache), table_cache_wast().c_str() );
+   produce_block();
+   push_actions( *this, N(cache), { N(store) } );
+   produce_block();
+
+   // removing the last row removes the table, which is then created again and removed again in the same transaction
+   push_actions( *this, N(cache), { N(present), N(erase), N(missing), N(store), N(present), N(erase), N(missing) } );
+   BOOST_REQUIRE( !find_row( *this, N(cache) ) );
+
+   push_actions( *this, N(cache), { N(missing), N(store), N(erase), N(store), N(present) } );
+   BOOST_REQUIRE( find_row( *this, N(cache) ) );
+   produce_block();
+   BOOST_REQUIRE( find_row( *this, N(cache) ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE( failed_transaction_leaves_no_table, tester ) try {
+   create_accounts( { N(cache) } );
+   set_code( N(cache), table_cache_wast().c_str() );
+   produce_block();
+
+   // the table the failed transaction created is undone along with it, and so is the removal of an existing one
+   BOOST_REQUIRE_THROW( push_actions( *this, N(cache), { N(missing), N(store), N(present), N(fail) } ),
+                        enumivo_assert_message_exception );
+   BOOST_REQUIRE( !find_row( *this, N(cache) ) );
+   push_actions( *this, N(cache), { N(missing), N(store) } );
+   BOOST_REQUIRE( find_row( *this, N(cache) ) );
+
+   BOOST_REQUIRE_THROW( push_actions( *this, N(cache), { N(erase), N(missing), N(fail) } ),
+                        enumivo_assert_message_exception );
+   BOOST_REQUIRE( find_row( *this, N(cache) ) );
+   push_actions( *this, N(cache), { N(present) } );
+   produce_block();
+   BOOST_REQUIRE( find_row( *this, N(cache) ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+#include <boost/test/unit_test.hpp>
+#include <enumivo/testing/tester.hpp>
+#include <enumivo/chain/wasm_instantiation_cache.hpp>
+#include <enumivo/chain/wast_to_wasm.hpp>
+
+#include <payloadless/payloadless.wast.hpp>
+#include <payloadless/payloadless.abi.hpp>
+#include <enu.token/enu.token.wast.hpp>
+#include <enu.system/enu.system.wast.hpp>
+
+#include <fc/variant_object.hpp>
+
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+namespace {
+   struct fake_module : wasm_instantiated_module_interface {
+      fake_module( size_t memory, uint32_t& live ) : memory( memory ), live( live ) { ++live; }
+      ~fake_module() { --live; }
+
+      void apply( apply_context& ) override {}
+      size_t memory_usage()const override { return memory; }
+
+      size_t     memory;
+      uint32_t&  live;
+   };
+
+   digest_type code_id( int i ) {
+      return digest_type::hash( uint64_t( i ) );
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(wasm_instantiation_cache_tests)
+
+BOOST_AUTO_TEST_CASE( lru_eviction ) try {
+   uint32_t live = 0;
+   uint32_t released = 0;
+   wasm_instantiation_cache cache( 300, [&]() { ++released; } );
+
+   for( int i = 0; i < 3; ++i )
+      cache.insert( code_id( i ), std::make_unique<fake_module>( 100, live ) );
+   BOOST_REQUIRE_EQUAL( live, 3 );
+   BOOST_REQUIRE_EQUAL( released, 0 );
+
+   // 0 becomes the most recently used, so 1 makes room for 3
+   BOOST_REQUIRE( cache.find( code_id( 0 ) ) );
+   cache.insert( code_id( 3 ), std::make_unique<fake_module>( 100, live ) );
+   BOOST_REQUIRE_EQUAL( live, 3 );
+   BOOST_REQUIRE_EQUAL( released, 1 );
+   BOOST_REQUIRE( !cache.find( code_id( 1 ) ) );
+   BOOST_REQUIRE( cache.find( code_id( 0 ) ) );
+
+   // a module larger than the capacity is still kept, on its own
+   auto& large = cache.insert( code_id( 4 ), std::make_unique<fake_module>( 1000, live ) );
+   BOOST_REQUIRE_EQUAL( large.memory_usage(), 1000 );
+   BOOST_REQUIRE_EQUAL( live, 1 );
+   BOOST_REQUIRE( cache.find( code_id( 4 ) ) == &large );
+
+   auto m = cache.get_metrics();
+   BOOST_REQUIRE_EQUAL( m.hits, 3 );
+   BOOST_REQUIRE_EQUAL( m.misses, 1 );
+   BOOST_REQUIRE_EQUAL( m.evictions, 4 );
+   BOOST_REQUIRE_EQUAL( m.size, 1 );
+   BOOST_REQUIRE_EQUAL( m.memory, 1000 );
+
+   cache.set_capacity( 0 );
+   BOOST_REQUIRE_EQUAL( live, 0 );
+   BOOST_REQUIRE_EQUAL( cache.get_metrics().memory, 0 );
+   BOOST_REQUIRE_EQUAL( released, 3 );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( replace ) try {
+   uint32_t live = 0;
+   wasm_instantiation_cache cache( 1000 );
+
+   cache.insert( code_id( 0 ), std::make_unique<fake_module>( 100, live ) );
+   cache.insert( code_id( 0 ), std::make_unique<fake_module>( 200, live ) );
+   BOOST_REQUIRE_EQUAL( live, 1 );
+   BOOST_REQUIRE_EQUAL( cache.get_metrics().memory, 200 );
+
+   // contains is not a use of the module
+   BOOST_REQUIRE( cache.contains( code_id( 0 ) ) );
+   BOOST_REQUIRE( !cache.contains( code_id( 1 ) ) );
+   BOOST_REQUIRE_EQUAL( cache.get_metrics().hits + cache.get_metrics().misses, 0 );
+
+   cache.clear();
+   BOOST_REQUIRE_EQUAL( live, 0 );
+   BOOST_REQUIRE_EQUAL( cache.get_metrics().size, 0 );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( precompile_on_setcode ) try {
+   fc::temp_directory tempdir;
+   auto cfg = base_tester::default_config( tempdir.path() );
+   // only wavm compiles in the background
+   cfg.wasm_runtime = wasm_interface::vm_type::wavm;
+   cfg.wasm_compile_threads = 1;
+   tester chain( cfg );
+   auto& wasmif = chain.control->get_wasm_interface();
+
+   chain.create_accounts( {N(payloadless)} );
+   auto before = wasmif.get_instantiation_cache_metrics();
+   chain.set_code( N(payloadless), payloadless_wast );
+   chain.set_abi( N(payloadless), payloadless_abi );
+
+   // the module compiled in the background is cached before any action of the contract ran
+   wasmif.wait_for_compiles();
+   auto compiled = wasmif.get_instantiation_cache_metrics();
+   BOOST_REQUIRE_EQUAL( compiled.size, before.size + 1 );
+   BOOST_REQUIRE_EQUAL( compiled.misses, before.misses );
+
+   // and the first action finds it there
+   auto trace = chain.push_action( N(payloadless), N(doit), N(payloadless), fc::mutable_variant_object() );
+   BOOST_REQUIRE_EQUAL( trace->action_traces.front().console, "Im a payloadless action" );
+   auto applied = wasmif.get_instantiation_cache_metrics();
+   BOOST_REQUIRE_EQUAL( applied.misses, before.misses );
+   BOOST_REQUIRE_EQUAL( applied.hits, compiled.hits + 1 );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( validate_while_compiling ) try {
+   fc::temp_directory tempdir;
+   auto cfg = base_tester::default_config( tempdir.path() );
+   cfg.wasm_runtime = wasm_interface::vm_type::wavm;
+   cfg.wasm_compile_threads = 1;
+   tester chain( cfg );
+   auto& wasmif = chain.control->get_wasm_interface();
+
+   chain.create_accounts( {N(enu.token), N(payloadless)} );
+   auto before = wasmif.get_instantiation_cache_metrics();
+   chain.set_code( N(enu.token), enu_token_wast );
+   chain.set_code( N(payloadless), payloadless_wast );
+   chain.set_abi( N(payloadless), payloadless_abi );
+
+   // other code is deserialized and validated on this thread while the contracts are compiled in the background
+   auto wasm = wast_to_wasm( enu_system_wast );
+   for( int i = 0; i < 20; ++i )
+      wasm_interface::validate( *chain.control, bytes( wasm.begin(), wasm.end() ) );
+
+   wasmif.wait_for_compiles();
+   BOOST_REQUIRE_EQUAL( wasmif.get_instantiation_cache_metrics().size, before.size + 2 );
+   auto trace = chain.push_action( N(payloadless), N(doit), N(payloadless), fc::mutable_variant_object() );
+   BOOST_REQUIRE_EQUAL( trace->action_traces.front().console, "Im a payloadless action" );
+   BOOST_REQUIRE_EQUAL( wasmif.get_instantiation_cache_metrics().misses, before.misses );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
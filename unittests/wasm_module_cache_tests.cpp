@@ -0,0 +1,113 @@
+#include <boost/test/unit_test.hpp>
+#include <enumivo/testing/tester.hpp>
+#include <enumivo/chain/wasm_module_cache.hpp>
+
+#include <payloadless/payloadless.wast.hpp>
+#include <payloadless/payloadless.abi.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/io/raw.hpp>
+#include <boost/filesystem.hpp>
+#include <fc/variant_object.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace enumivo::chain;
+using namespace enumivo::testing;
+
+namespace {
+   controller::config make_config( const fc::path& dir, const fc::path& wasm_cache_dir ) {
+      auto cfg = base_tester::default_config( dir );
+      cfg.wasm_cache_dir = wasm_cache_dir;
+      return cfg;
+   }
+
+   /// replaces every occurrence of from in bytes by to, which has the same length, and returns how many there were
+   uint32_t replace_bytes( vector<uint8_t>& bytes, const std::string& from, const std::string& to ) {
+      uint32_t replaced = 0;
+      for( auto itr = bytes.begin(); ( itr = std::search( itr, bytes.end(), from.begin(), from.end() ) ) != bytes.end(); ++replaced )
+         itr = std::copy( to.begin(), to.end(), itr );
+      return replaced;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(wasm_module_cache_tests)
+
+BOOST_AUTO_TEST_CASE( store_and_load ) try {
+   fc::temp_directory tempdir;
+   wasm_module_cache cache( tempdir.path() / "wasm" );
+
+   injected_wasm_module module;
+   module.code_id = digest_type::hash( std::string( "code" ) );
+   module.code = { 0, 'a', 's', 'm', 1, 0, 0, 0 };
+   module.initial_memory = { 1, 2, 3 };
+
+   BOOST_REQUIRE( !cache.load( module.code_id ) );
+   cache.store( module );
+
+   auto loaded = cache.load( module.code_id );
+   BOOST_REQUIRE( loaded );
+   BOOST_REQUIRE( loaded->code == module.code );
+   BOOST_REQUIRE( loaded->initial_memory == module.initial_memory );
+   BOOST_REQUIRE( loaded->injection_hash == wasm_module_cache::injection_hash() );
+
+   // a module injected by another version of the injection is not reused
+   module.injection_hash = digest_type::hash( std::string( "older injection" ) );
+   auto file = tempdir.path() / "wasm" / ( module.code_id.str() + ".wasm" );
+   {
+      module.checksum = module.calculate_checksum();
+      auto data = fc::raw::pack( module );
+      std::ofstream out( file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+      out.write( data.data(), data.size() );
+   }
+   BOOST_REQUIRE( !cache.load( module.code_id ) );
+   BOOST_REQUIRE( !fc::exists( file ) );
+
+   // nor is a truncated one
+   cache.store( module );
+   boost::filesystem::resize_file( file, fc::file_size( file ) - 1 );
+   BOOST_REQUIRE( !cache.load( module.code_id ) );
+   BOOST_REQUIRE( !fc::exists( file ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE( reuse_after_restart ) try {
+   fc::temp_directory tempdir;
+   auto wasm_cache_dir = tempdir.path() / config::default_wasm_cache_dir_name;
+
+   digest_type code_id;
+   {
+      tester chain( make_config( tempdir.path() / "first", wasm_cache_dir ) );
+      chain.create_accounts( {N(payloadless)} );
+      chain.set_code( N(payloadless), payloadless_wast );
+      chain.set_abi( N(payloadless), payloadless_abi );
+      chain.push_action( N(payloadless), N(doit), N(payloadless), fc::mutable_variant_object() );
+      code_id = chain.control->db().get<account_object,by_name>( N(payloadless) ).code_version;
+   }
+
+   // the message the contract prints is changed in the cached module, so the action prints the new one only if the
+   // second chain runs the cached module rather than injecting the contract again
+   const std::string cached_message = "Im a cached wasm module";
+   {
+      wasm_module_cache cache( wasm_cache_dir );
+      auto module = cache.load( code_id );
+      BOOST_REQUIRE( module );
+      BOOST_REQUIRE_EQUAL( replace_bytes( module->code, "Im a payloadless action", cached_message ), 1 );
+      BOOST_REQUIRE_EQUAL( replace_bytes( module->initial_memory, "Im a payloadless action", cached_message ), 1 );
+      cache.store( *module );
+   }
+
+   tester chain( make_config( tempdir.path() / "second", wasm_cache_dir ) );
+   chain.create_accounts( {N(payloadless)} );
+   chain.set_code( N(payloadless), payloadless_wast );
+   chain.set_abi( N(payloadless), payloadless_abi );
+   auto trace = chain.push_action( N(payloadless), N(doit), N(payloadless), fc::mutable_variant_object() );
+   BOOST_REQUIRE_EQUAL( trace->action_traces.front().console, cached_message );
+
+   // and the cached module was not written again
+   auto module = wasm_module_cache( wasm_cache_dir ).load( code_id );
+   BOOST_REQUIRE( module );
+   BOOST_REQUIRE_EQUAL( replace_bytes( module->initial_memory, cached_message, cached_message ), 1 );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
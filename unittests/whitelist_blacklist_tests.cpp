@@ -45,6 +45,8 @@ class whitelist_blacklist_tester {
                cfg.wasm_runtime = chain::wasm_interface::vm_type::binaryen;
             else if(boost::unit_test::framework::master_test_suite().argv[i] == std::string("--wavm"))
                cfg.wasm_runtime = chain::wasm_interface::vm_type::wavm;
+            else if(boost::unit_test::framework::master_test_suite().argv[i] == std::string("--predecoded"))
+               cfg.wasm_runtime = chain::wasm_interface::vm_type::predecoded;
             else
                cfg.wasm_runtime = chain::wasm_interface::vm_type::binaryen;
          }